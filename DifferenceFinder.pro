@@ -10,6 +10,16 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 QMAKE_CXXFLAGS += -std=c++11
 
+#compressed input support (see decompressor.h): enabled for the libraries that are installed
+packagesExist(zlib) {
+    DEFINES += HAVE_ZLIB
+    LIBS += -lz
+}
+packagesExist(liblzma) {
+    DEFINES += HAVE_LZMA
+    LIBS += -llzma
+}
+
 TARGET = DifferenceFinder
 TEMPLATE = app
 
@@ -19,37 +29,69 @@ SOURCES += main.cpp\
     dataSet.cpp \
     dataSetView.cpp \
     hexfield.cpp \
+    overviewstrip.cpp \
     log.cpp \
     settingsdialog.cpp \
     usersettings.cpp \
     comparison.cpp \
     blockmatchset.cpp \
+    blockmatchstore.cpp \
+    indexrunlist.cpp \
+    bytespan.cpp \
     comparisonthread.cpp \
+    commonends.cpp \
+    chunktriage.cpp \
+    fileloaderthread.cpp \
     stopwatch.cpp \
     buzhash.cpp \
     offsetmetrics.cpp \
+    diagonalmatchindex.cpp \
+    diagonalmatchindexcache.cpp \
     rangematch.cpp \
     utilities.cpp \
     indexrange.cpp \
+    highlightindex.cpp \
+    renderedrowcache.cpp \
+    densitypyramid.cpp \
+    navigationindex.cpp \
+    offsetmap.cpp \
+    hexformat.cpp \
+    decompressor.cpp \
     searchprocessing.cpp
 
 HEADERS  += mainwindow.h \
     dataSet.h \
     dataSetView.h \
     hexfield.h \
+    overviewstrip.h \
     log.h \
     settingsdialog.h \
     usersettings.h \
     defensivecoding.h \
     comparison.h \
     blockmatchset.h \
+    blockmatchstore.h \
+    indexrunlist.h \
+    bytespan.h \
     comparisonthread.h \
+    commonends.h \
+    chunktriage.h \
+    fileloaderthread.h \
     stopwatch.h \
     buzhash.h \
     offsetmetrics.h \
+    diagonalmatchindex.h \
+    diagonalmatchindexcache.h \
     rangematch.h \
     utilities.h \
     indexrange.h \
+    highlightindex.h \
+    renderedrowcache.h \
+    densitypyramid.h \
+    navigationindex.h \
+    offsetmap.h \
+    hexformat.h \
+    decompressor.h \
     searchprocessing.h
 
 FORMS    += mainwindow.ui \
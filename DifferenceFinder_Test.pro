@@ -10,6 +10,16 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 QMAKE_CXXFLAGS += -std=c++11
 
+#compressed input support (see decompressor.h): enabled for the libraries that are installed
+packagesExist(zlib) {
+    DEFINES += HAVE_ZLIB
+    LIBS += -lz
+}
+packagesExist(liblzma) {
+    DEFINES += HAVE_LZMA
+    LIBS += -llzma
+}
+
 TARGET = DifferenceFinder
 TEMPLATE = app
 
@@ -20,40 +30,86 @@ SOURCES +=\
     dataSet.cpp \
     dataSetView.cpp \
     hexfield.cpp \
+    overviewstrip.cpp \
     log.cpp \
     settingsdialog.cpp \
     usersettings.cpp \
     comparison.cpp \
     blockmatchset.cpp \
+    blockmatchstore.cpp \
+    indexrunlist.cpp \
+    bytespan.cpp \
     comparisonthread.cpp \
+    commonends.cpp \
+    chunktriage.cpp \
+    fileloaderthread.cpp \
     stopwatch.cpp \
     buzhash.cpp \
     offsetmetrics.cpp \
+    diagonalmatchindex.cpp \
+    diagonalmatchindexcache.cpp \
     rangematch.cpp \
     utilities.cpp \
     indexrange.cpp \
+    highlightindex.cpp \
+    renderedrowcache.cpp \
+    densitypyramid.cpp \
+    navigationindex.cpp \
+    offsetmap.cpp \
+    hexformat.cpp \
+    decompressor.cpp \
     searchprocessing.cpp \
     dataSet_gtest.cpp \
     indexrange_gtest.cpp \
-    utilities_gtest.cpp
+    utilities_gtest.cpp \
+    diagonalmatchindex_gtest.cpp \
+    highlightindex_gtest.cpp \
+    densitypyramid_gtest.cpp \
+    navigationindex_gtest.cpp \
+    offsetmap_gtest.cpp \
+    renderedrowcache_gtest.cpp \
+    hexformat_gtest.cpp \
+    decompressor_gtest.cpp \
+    commonends_gtest.cpp \
+    chunktriage_gtest.cpp \
+    indexrunlist_gtest.cpp \
+    blockmatchstore_gtest.cpp \
+    offsetmetrics_gtest.cpp \
+    comparison_gtest.cpp
 
 HEADERS  += mainwindow.h \
     dataSet.h \
     dataSetView.h \
     hexfield.h \
+    overviewstrip.h \
     log.h \
     settingsdialog.h \
     usersettings.h \
     defensivecoding.h \
     comparison.h \
     blockmatchset.h \
+    blockmatchstore.h \
+    indexrunlist.h \
+    bytespan.h \
     comparisonthread.h \
+    commonends.h \
+    chunktriage.h \
+    fileloaderthread.h \
     stopwatch.h \
     buzhash.h \
     offsetmetrics.h \
+    diagonalmatchindex.h \
+    diagonalmatchindexcache.h \
     rangematch.h \
     utilities.h \
     indexrange.h \
+    highlightindex.h \
+    renderedrowcache.h \
+    densitypyramid.h \
+    navigationindex.h \
+    offsetmap.h \
+    hexformat.h \
+    decompressor.h \
     searchprocessing.h \
     gtestDefs.h
 
@@ -6,8 +6,8 @@ blockMatchSet::blockMatchSet(unsigned int hash_, unsigned int blockSize_, unsign
         data1_BlockStartIndices(),
         data2_BlockStartIndices()
 {
-    data1_BlockStartIndices.emplace_back(data1_initialBlockIndex);
-    data2_BlockStartIndices.emplace_back(data2_initialBlockIndex);
+    data1_BlockStartIndices.push_back(data1_initialBlockIndex);
+    data2_BlockStartIndices.push_back(data2_initialBlockIndex);
 }
 
 bool blockMatchSet::operator < (const blockMatchSet& rhs) const
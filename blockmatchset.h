@@ -4,9 +4,14 @@
 #include <memory>
 #include <vector>
 
+#include "indexrunlist.h"
+
 /*
 records a set of identical matching byte blocks across 2 data sets,
 possibly including multiple blocks in each set
+
+the start indices are stored as periodic runs (see indexRunList):
+ a block repeated throughout a padded or repetitive region doesn't need one index per occurrence
 */
 
 class blockMatchSet
@@ -16,8 +21,8 @@ public:
 
     unsigned int hash;
     unsigned int blockSize;
-    std::vector<unsigned int>data1_BlockStartIndices;
-    std::vector<unsigned int>data2_BlockStartIndices;
+    indexRunList data1_BlockStartIndices;
+    indexRunList data2_BlockStartIndices;
 
     bool operator < (const blockMatchSet& rhs) const;
 
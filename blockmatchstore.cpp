@@ -0,0 +1,102 @@
+#include "blockmatchstore.h"
+
+#include <algorithm>
+#include <iterator>
+
+/*static*/ const unsigned int blockMatchStore::NONE;
+
+blockMatchStore::blockMatchStore()
+    :   m_sets(),
+        m_next(),
+        m_bucketHeads(),
+        m_bucketBits(0)
+{
+    rebuildBuckets(6);
+}
+
+unsigned int blockMatchStore::add(const unsigned int hash, const unsigned int blockSize, const unsigned int data1Index, const unsigned int data2Index)
+{
+    ASSERT(m_sets.size() < NONE);
+    const unsigned int id = static_cast<unsigned int>(m_sets.size());
+
+    m_sets.emplace_back(hash, blockSize, data1Index, data2Index);
+
+    //keep the load factor at or below 1
+    if (m_sets.size() > m_bucketHeads.size()) {
+        m_next.push_back(NONE);
+        rebuildBuckets(m_bucketBits + 1);
+        return id;
+    }
+
+    const unsigned int bucket = getBucket(hash);
+    m_next.push_back(m_bucketHeads[bucket]);
+    m_bucketHeads[bucket] = id;
+
+    return id;
+}
+
+blockMatchSet& blockMatchStore::operator[](const unsigned int id)
+{
+    ASSERT(id < m_sets.size());
+    return m_sets[id];
+}
+
+unsigned int blockMatchStore::findFirst(const unsigned int hash) const
+{
+    return skipToHash(m_bucketHeads[getBucket(hash)], hash);
+}
+
+unsigned int blockMatchStore::findNext(const unsigned int id) const
+{
+    ASSERT(id < m_sets.size());
+    return skipToHash(m_next[id], m_sets[id].hash);
+}
+
+unsigned int blockMatchStore::size() const
+{
+    return static_cast<unsigned int>(m_sets.size());
+}
+
+bool blockMatchStore::empty() const
+{
+    return m_sets.empty();
+}
+
+void blockMatchStore::moveTo(std::multiset<blockMatchSet>& sets)
+{
+    //(a multiset inserts equal elements after the ones already there: stable order, as when they were added one at a time)
+    std::stable_sort(m_sets.begin(), m_sets.end());
+    sets.insert(std::make_move_iterator(m_sets.begin()), std::make_move_iterator(m_sets.end()));
+
+    m_sets.clear();
+    m_next.clear();
+    rebuildBuckets(6);
+}
+
+unsigned int blockMatchStore::getBucket(const unsigned int hash) const
+{
+    //fibonacci hashing: the top bits of the product depend on every bit of hash
+    return static_cast<unsigned int>((hash * 2654435769u) >> (32 - m_bucketBits));
+}
+
+unsigned int blockMatchStore::skipToHash(unsigned int id, const unsigned int hash) const
+{
+    //(a bucket can hold sets with other hashes)
+    while (NONE != id && m_sets[id].hash != hash) {
+        id = m_next[id];
+    }
+    return id;
+}
+
+void blockMatchStore::rebuildBuckets(const unsigned int bucketBits)
+{
+    ASSERT(0 < bucketBits && bucketBits < 32);
+    m_bucketBits = bucketBits;
+    m_bucketHeads.assign(static_cast<size_t>(1) << bucketBits, NONE);
+
+    for (unsigned int id = 0; id < m_sets.size(); ++id) {
+        const unsigned int bucket = getBucket(m_sets[id].hash);
+        m_next[id] = m_bucketHeads[bucket];
+        m_bucketHeads[bucket] = id;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef BLOCKMATCHSTORE_H
+#define BLOCKMATCHSTORE_H
+
+#include <vector>
+#include <set>
+#include <climits>
+
+#include "blockmatchset.h"
+#include "defensivecoding.h"
+
+/*
+    flat storage for the blockMatchSets built by a block match search, with a hash-bucketed lookup
+
+    the sets are kept in one vector (in the order they're added), and chained into buckets by hash:
+     finding the sets with a hash doesn't search a tree, and adding indices to a set doesn't need a const_cast
+     (as it did for sets held in a std::multiset<blockMatchSet>)
+    the bucket array grows with the number of sets (at most 1 set per bucket on average)
+
+    when the search is done, moveTo() hands the sets over to a std::multiset, one insertion per set
+*/
+
+class blockMatchStore
+{
+public:
+    static const unsigned int NONE = UINT_MAX;  //no set
+
+    blockMatchStore();
+
+    //adds a new set for a matching block pair, and returns its id
+    unsigned int add(const unsigned int hash, const unsigned int blockSize, const unsigned int data1Index, const unsigned int data2Index);
+
+    blockMatchSet& operator[](const unsigned int id);
+
+    //the sets with a hash:
+    //  for (unsigned int id = findFirst(hash); blockMatchStore::NONE != id; id = findNext(id)) {...}
+    unsigned int findFirst(const unsigned int hash) const;
+    unsigned int findNext(const unsigned int id) const;
+
+    unsigned int size() const;
+    bool empty() const;
+
+    //moves the sets into sets (in hash order; sets with equal hashes stay in the order they were added),
+    // and clears this store
+    void moveTo(std::multiset<blockMatchSet>& sets);
+
+private:
+    std::vector<blockMatchSet> m_sets;
+    std::vector<unsigned int> m_next;           //the next set in the same bucket (for each set)
+    std::vector<unsigned int> m_bucketHeads;    //the last set added to each bucket
+    unsigned int m_bucketBits;                  //log2 of the bucket count
+
+    unsigned int getBucket(const unsigned int hash) const;
+    unsigned int skipToHash(unsigned int id, const unsigned int hash) const;
+    void rebuildBuckets(const unsigned int bucketBits);
+};
+
+#endif // BLOCKMATCHSTORE_H
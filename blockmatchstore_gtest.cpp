@@ -0,0 +1,54 @@
+#include "blockmatchstore.h"
+#include <algorithm>
+#include "gtestDefs.h"
+#include <gtest.h>
+
+TEST(blockMatchStore, findByHash){
+    blockMatchStore store;
+    EXPECT_TRUE(store.empty());
+    EXPECT_EQ(blockMatchStore::NONE, store.findFirst(5));
+
+    //enough sets to rebuild the buckets several times
+    for (unsigned int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(i, store.add(i % 300, 4, i, i + 1));
+    }
+    EXPECT_EQ(1000u, store.size());
+
+    //hash 7 has the sets added at 7, 307, 607 and 907
+    std::vector<unsigned int> found;
+    for (unsigned int id = store.findFirst(7); blockMatchStore::NONE != id; id = store.findNext(id)) {
+        EXPECT_EQ(7u, store[id].hash);
+        found.push_back(store[id].data1_BlockStartIndices.front());
+    }
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(std::vector<unsigned int>({7, 307, 607, 907}), found);
+
+    EXPECT_EQ(blockMatchStore::NONE, store.findFirst(300));
+
+    //sets are modified in place
+    store[store.findFirst(299)].data2_BlockStartIndices.push_back(5000);
+}
+
+TEST(blockMatchStore, moveTo){
+    blockMatchStore store;
+    store.add(9, 4, 0, 10);
+    store.add(3, 4, 1, 11);
+    store.add(9, 4, 2, 12);
+    store[0].data1_BlockStartIndices.push_back(20);
+
+    std::multiset<blockMatchSet> sets;
+    store.moveTo(sets);
+    EXPECT_TRUE(store.empty());
+    EXPECT_EQ(blockMatchStore::NONE, store.findFirst(9));
+
+    //in hash order, and in the order they were added for equal hashes
+    ASSERT_EQ(3u, sets.size());
+    auto it = sets.begin();
+    EXPECT_EQ(3u, it->hash);
+    ++it;
+    EXPECT_EQ(9u, it->hash);
+    EXPECT_EQ(indexRunList({0, 20}), it->data1_BlockStartIndices);
+    ++it;
+    EXPECT_EQ(9u, it->hash);
+    EXPECT_EQ(indexRunList({2}), it->data1_BlockStartIndices);
+}
@@ -0,0 +1,20 @@
+#include "bytespan.h"
+
+byteSpan::byteSpan(const std::vector<unsigned char>& data)
+    :   m_data(data.data()),
+        m_size(data.size())
+{
+}
+
+byteSpan::byteSpan(const std::vector<unsigned char>& data, const indexRange& range)
+    :   m_data(data.data() + range.start),
+        m_size(range.count())
+{
+    ASSERT(range.start <= data.size() && range.count() <= data.size() - range.start);
+}
+
+byteSpan::byteSpan(const unsigned char* data, const size_t size)
+    :   m_data(data),
+        m_size(size)
+{
+}
@@ -0,0 +1,40 @@
+#ifndef BYTESPAN_H
+#define BYTESPAN_H
+
+#include <vector>
+#include <cstddef>
+
+#include "indexrange.h"
+#include "defensivecoding.h"
+
+/*
+    a read-only view of a contiguous range of bytes (usually part of a std::vector<unsigned char> owned elsewhere)
+
+    the comparison algorithms take their data as byteSpans, so part of a loaded file
+     (e.g. the middle between two files' identical ends) can be compared without copying it
+    a std::vector<unsigned char> converts to a byteSpan of its whole contents
+
+    the viewed bytes must outlive the byteSpan, and must not be reallocated while it's used
+*/
+
+class byteSpan
+{
+public:
+    byteSpan(const std::vector<unsigned char>& data);  //the whole vector (intentionally not explicit)
+    byteSpan(const std::vector<unsigned char>& data, const indexRange& range);
+    byteSpan(const unsigned char* data, const size_t size);
+
+    //(defined here so they're inlined in the comparison loops)
+    size_t size() const                                 { return m_size; }
+    bool empty() const                                  { return 0 == m_size; }
+    const unsigned char* data() const                   { return m_data; }
+    const unsigned char* begin() const                  { return m_data; }
+    const unsigned char* end() const                    { return m_data + m_size; }
+    const unsigned char& operator[](const size_t i) const  { return m_data[i]; }
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+};
+
+#endif // BYTESPAN_H
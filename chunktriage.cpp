@@ -0,0 +1,157 @@
+#include "chunktriage.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <thread>
+
+/*static*/ const unsigned int chunkTriage::HASH_WINDOW_SIZE;
+/*static*/ const unsigned int chunkTriage::CUT_MASK;
+/*static*/ const unsigned int chunkTriage::MIN_CHUNK_SIZE;
+/*static*/ const unsigned int chunkTriage::MAX_CHUNK_SIZE;
+/*static*/ const unsigned int chunkTriage::MAX_SHIFTS;
+/*static*/ const double chunkTriage::UNRELATED_FRACTION = 0.02;
+
+/*static*/ std::atomic_bool chunkTriage::m_abort{false};
+
+double chunkTriage::results::getSharedFraction() const
+{
+    const unsigned long long totalSize = size1 + size2;
+    if (0 == totalSize) {
+        return 0;
+    }
+
+    return static_cast<double>(sharedBytes1 + sharedBytes2) / static_cast<double>(totalSize);
+}
+
+bool chunkTriage::results::isUnrelated() const
+{
+    return getSharedFraction() < UNRELATED_FRACTION;
+}
+
+/*static*/ std::vector<chunkTriage::chunk> chunkTriage::getChunks(const byteSpan& data)
+{
+    ASSERT_LE_UINT_MAX(data.size());
+    const unsigned int size = static_cast<unsigned int>(data.size());
+
+    const unsigned long long FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    const unsigned long long FNV_PRIME        = 0x100000001b3ULL;
+
+    std::vector<chunk> chunks;
+    chunks.reserve(size/(CUT_MASK + 1) + 1);
+
+    buzhash hasher(HASH_WINDOW_SIZE);
+    unsigned int chunkStart = 0;
+    unsigned long long fingerprint = FNV_OFFSET_BASIS;
+
+    for (unsigned int i = 0; i < size; ++i) {
+        const unsigned char c = data[i];
+
+        const unsigned int hashValue = hasher.hashByte(c);
+        fingerprint = (fingerprint ^ c) * FNV_PRIME;
+
+        //cut after this byte?
+        const unsigned int length = i + 1 - chunkStart;
+        if (     (length >= MIN_CHUNK_SIZE && CUT_MASK == (hashValue & CUT_MASK))
+              ||  length >= MAX_CHUNK_SIZE )
+        {
+            chunks.push_back(chunk{chunkStart, length, fingerprint});
+            chunkStart = i + 1;
+            fingerprint = FNV_OFFSET_BASIS;
+
+            if (m_abort) {
+                return chunks;  //(incomplete: analyze() marks its results as aborted)
+            }
+        }
+    }
+
+    //the rest is the last chunk
+    if (chunkStart < size) {
+        chunks.push_back(chunk{chunkStart, size - chunkStart, fingerprint});
+    }
+
+    return chunks;
+}
+
+/*static*/ chunkTriage::results chunkTriage::analyze(   const byteSpan& data1,
+                                                        const byteSpan& data2 )
+{
+    results res;
+    res.size1 = data1.size();
+    res.size2 = data2.size();
+
+    //chunk data 2 on another thread while this one chunks data 1
+    std::vector<chunk> chunks2;
+    std::thread chunker2([&chunks2, &data2]() { chunks2 = getChunks(data2); });
+    const std::vector<chunk> chunks1 = getChunks(data1);
+    chunker2.join();
+
+    if (m_abort) {
+        res.aborted = true;
+        return res;
+    }
+
+    ASSERT_LE_UINT_MAX(chunks1.size());
+    ASSERT_LE_UINT_MAX(chunks2.size());
+    res.chunkCount1 = static_cast<unsigned int>(chunks1.size());
+    res.chunkCount2 = static_cast<unsigned int>(chunks2.size());
+
+    //the first chunk in data 1 with each fingerprint
+    std::unordered_map<unsigned long long, unsigned int> starts1;
+    starts1.reserve(chunks1.size());
+    for (const chunk& c : chunks1) {
+        starts1.emplace(c.fingerprint, c.start);
+    }
+
+    //shared data 2 chunks, and the diagonals they're on
+    std::unordered_set<unsigned long long> shared;
+    std::unordered_map<long long, unsigned long long> diagonalBytes;
+    for (const chunk& c : chunks2) {
+        auto found = starts1.find(c.fingerprint);
+        if (found == starts1.end()) {
+            continue;
+        }
+
+        res.sharedBytes2 += c.length;
+        shared.insert(c.fingerprint);
+
+        const long long diagonal = static_cast<long long>(c.start) - static_cast<long long>(found->second);
+        diagonalBytes[diagonal] += c.length;
+    }
+
+    for (const chunk& c : chunks1) {
+        if (shared.count(c.fingerprint)) {
+            res.sharedBytes1 += c.length;
+        }
+    }
+
+    //the diagonals with the most shared bytes
+    for (const auto& diagonal : diagonalBytes) {
+        res.shifts.push_back(shift{diagonal.first, diagonal.second});
+    }
+
+    auto mostBytesFirst = [](const shift& lhs, const shift& rhs) {
+        return    lhs.byteCount >  rhs.byteCount
+              || (lhs.byteCount == rhs.byteCount && lhs.diagonal < rhs.diagonal);
+    };
+
+    if (res.shifts.size() > MAX_SHIFTS) {
+        std::partial_sort(res.shifts.begin(), res.shifts.begin() + MAX_SHIFTS, res.shifts.end(), mostBytesFirst);
+        res.shifts.resize(MAX_SHIFTS);
+    }
+    else {
+        std::sort(res.shifts.begin(), res.shifts.end(), mostBytesFirst);
+    }
+
+    return res;
+}
+
+/*static*/ void chunkTriage::abort()
+{
+    m_abort = true;
+}
+
+/*static*/ void chunkTriage::clearAbort()
+{
+    m_abort = false;
+}
@@ -0,0 +1,93 @@
+#ifndef CHUNKTRIAGE_H
+#define CHUNKTRIAGE_H
+
+#include <vector>
+#include <atomic>
+
+#include "buzhash.h"
+#include "bytespan.h"
+#include "defensivecoding.h"
+
+/*
+    quick similarity estimate for 2 data sets, made before (or instead of) a full comparison
+
+    each data set is split into content-defined chunks: a chunk ends after a byte where the rolling hash (buzhash)
+     of the bytes before it has all of the mask bits set, so an insertion or deletion only changes the chunks around it
+     (and identical content is split into identical chunks wherever it is in either data set)
+
+    each chunk is fingerprinted (64-bit FNV-1a) in the same pass; chunks with the same fingerprint in both data sets
+     are shared, and the difference between their start indices (the diagonal: index in data 2 - index in data 1)
+     is the offset shift between the files there
+
+    the diagonal with the most shared bytes can seed a comparison (see offsetMetrics::options::initialDiagonal)
+*/
+
+class chunkTriage
+{
+public:
+    chunkTriage() = delete; //static functions only
+
+    class chunk {
+    public:
+        unsigned int start;
+        unsigned int length;
+        unsigned long long fingerprint;
+    };
+
+    //a diagonal (index in data 2 - index in data 1) shared chunks were found on, and how many bytes they have
+    class shift {
+    public:
+        long long diagonal;
+        unsigned long long byteCount;
+    };
+
+    class results {
+    public:
+        unsigned int chunkCount1;
+        unsigned int chunkCount2;
+
+        unsigned long long size1;
+        unsigned long long size2;
+
+        //bytes in chunks that are also in the other data set
+        unsigned long long sharedBytes1;
+        unsigned long long sharedBytes2;
+
+        //the diagonals with the most shared bytes (most first; at most MAX_SHIFTS)
+        std::vector<shift> shifts;
+
+        bool aborted;   //if true, the other members are incomplete
+
+        //shared bytes in both data sets / bytes in both data sets (0 to 1)
+        double getSharedFraction() const;
+
+        //true if so little is shared that a full comparison won't find much (e.g. unrelated files)
+        bool isUnrelated() const;
+
+        results() : chunkCount1(0), chunkCount2(0), size1(0), size2(0), sharedBytes1(0), sharedBytes2(0), shifts(), aborted(false) {}
+    };
+
+    //splits data into content-defined chunks in one pass (see above)
+    static std::vector<chunk> getChunks(const byteSpan& data);
+
+    //chunks both data sets (in parallel) and matches their chunks
+    static results analyze( const byteSpan& data1,
+                            const byteSpan& data2 );
+
+    static void abort();
+    static void clearAbort();   //call before starting a new analysis
+
+    static const unsigned int HASH_WINDOW_SIZE = 48;    //bytes in the rolling hash (not a multiple of 32: see buzhash::hashByte)
+    static const unsigned int CUT_MASK = (1 << 12) - 1; //average chunk size: 4 KiB
+    static const unsigned int MIN_CHUNK_SIZE = 1 << 10;
+    static const unsigned int MAX_CHUNK_SIZE = 1 << 16; //(chunks of repeated bytes never match the mask)
+
+    static const unsigned int MAX_SHIFTS = 8;
+
+    static const double UNRELATED_FRACTION;     //see results::isUnrelated
+
+private:
+    static std::atomic_bool m_abort;  //abort flag
+};
+
+#endif // CHUNKTRIAGE_H
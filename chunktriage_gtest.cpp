@@ -0,0 +1,66 @@
+#include "chunktriage.h"
+#include "gtestDefs.h"
+#include <gtest.h>
+
+TEST(chunkTriage, chunksCoverData){
+    const std::vector<unsigned char> data = gtestDefs::randomData(1 << 20, 47);
+    const std::vector<chunkTriage::chunk> chunks = chunkTriage::getChunks(data);
+
+    //in order, without gaps, within the size limits (except the last)
+    unsigned int next = 0;
+    for (const chunkTriage::chunk& c : chunks) {
+        EXPECT_EQ(next, c.start);
+        EXPECT_LE(c.length, chunkTriage::MAX_CHUNK_SIZE);
+        if (&c != &chunks.back()) {
+            EXPECT_GE(c.length, chunkTriage::MIN_CHUNK_SIZE);
+        }
+        next = c.start + c.length;
+    }
+    EXPECT_EQ(data.size(), next);
+
+    //about 1 chunk per (CUT_MASK + 1) bytes past the minimum size
+    EXPECT_GT(chunks.size(), 100u);
+    EXPECT_LT(chunks.size(), 400u);
+
+    EXPECT_TRUE(chunkTriage::getChunks(std::vector<unsigned char>()).empty());
+}
+
+TEST(chunkTriage, insertionShiftsChunks){
+    const std::vector<unsigned char> data1 = gtestDefs::randomData(1 << 20, 47);
+
+    //1000 bytes inserted a quarter of the way in: the rest of the file is on diagonal 1000
+    std::vector<unsigned char> data2(data1);
+    const std::vector<unsigned char> inserted = gtestDefs::randomData(1000, 48);
+    data2.insert(data2.begin() + (1 << 18), inserted.begin(), inserted.end());
+
+    const chunkTriage::results res = chunkTriage::analyze(data1, data2);
+
+    EXPECT_GT(res.getSharedFraction(), 0.95);
+    EXPECT_FALSE(res.isUnrelated());
+
+    ASSERT_LE(2u, res.shifts.size());
+    EXPECT_EQ(1000, res.shifts[0].diagonal);
+    EXPECT_EQ(0, res.shifts[1].diagonal);
+    EXPECT_GT(res.shifts[0].byteCount, res.shifts[1].byteCount);
+}
+
+TEST(chunkTriage, unrelatedData){
+    const chunkTriage::results res = chunkTriage::analyze(gtestDefs::randomData(1 << 18, 47), gtestDefs::randomData(1 << 18, 49));
+
+    EXPECT_EQ(0u, res.sharedBytes1);
+    EXPECT_EQ(0u, res.sharedBytes2);
+    EXPECT_TRUE(res.shifts.empty());
+    EXPECT_TRUE(res.isUnrelated());
+}
+
+TEST(chunkTriage, abort){
+    const std::vector<unsigned char> data = gtestDefs::randomData(1 << 20, 47);
+
+    chunkTriage::abort();
+    EXPECT_TRUE(chunkTriage::analyze(data, data).aborted);
+
+    chunkTriage::clearAbort();
+    const chunkTriage::results res = chunkTriage::analyze(data, data);
+    EXPECT_FALSE(res.aborted);
+    EXPECT_EQ(data.size(), res.sharedBytes1);
+}
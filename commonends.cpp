@@ -0,0 +1,140 @@
+#include "commonends.h"
+
+#include "utilities.h"
+
+/*static*/ const unsigned int commonEnds::MIN_TRIM_LENGTH;
+
+namespace {
+
+    void moveRanges(std::list<indexRange>& ranges, const unsigned int distance)
+    {
+        for (indexRange& range : ranges) {
+            ASSERT(noSumOverflow(range.end, distance));
+            range.start += distance;
+            range.end += distance;
+        }
+    }
+
+}
+
+/*static*/ commonEnds::lengths commonEnds::find(    const std::vector<unsigned char>& data1,
+                                                    const std::vector<unsigned char>& data2 )
+{
+    lengths ends;
+
+    ASSERT_LE_UINT_MAX(data1.size());
+    ASSERT_LE_UINT_MAX(data2.size());
+    const unsigned int shorterSize = static_cast<unsigned int>(std::min(data1.size(), data2.size()));
+
+    if (0 == shorterSize) {
+        return ends;
+    }
+
+    ends.prefix = utilities::getCommonPrefixLength(data1.data(), data2.data(), shorterSize);
+    ends.suffix = utilities::getCommonSuffixLength(data1.data() + data1.size(), data2.data() + data2.size(), shorterSize - ends.prefix);
+
+    return ends;
+}
+
+/*static*/ bool commonEnds::isWorthTrimming(const lengths& ends, const unsigned int size1, const unsigned int size2)
+{
+    if (!size1 || !size2) {
+        return false;   //nothing is common
+    }
+
+    return     static_cast<unsigned long long>(ends.prefix) + ends.suffix >= MIN_TRIM_LENGTH
+            || 0 == getMiddle(ends, size1).count()
+            || 0 == getMiddle(ends, size2).count();
+}
+
+/*static*/ indexRange commonEnds::getMiddle(const lengths& ends, const unsigned int size)
+{
+    ASSERT(noSumOverflow(ends.prefix, ends.suffix));
+    ASSERT(ends.prefix + ends.suffix <= size);
+
+    return indexRange(ends.prefix, size - ends.suffix);
+}
+
+/*static*/ void commonEnds::addEnds(    comparison::results& results,
+                                        const lengths& ends,
+                                        const unsigned int size1,
+                                        const unsigned int size2 )
+{
+    const indexRange middle1 = getMiddle(ends, size1);
+    const indexRange middle2 = getMiddle(ends, size2);
+
+    //the match sets are ordered by hash, so they're rebuilt with their indices moved
+    std::multiset<blockMatchSet> matches;
+    for (const blockMatchSet& match : results.matches) {
+        blockMatchSet moved(match);
+        moved.data1_BlockStartIndices.move(ends.prefix);
+        moved.data2_BlockStartIndices.move(ends.prefix);
+        matches.insert(std::move(moved));
+    }
+
+    moveRanges(results.data1_unmatchedBlocks, ends.prefix);
+    moveRanges(results.data2_unmatchedBlocks, ends.prefix);
+
+    //a middle with nothing to match against is all difference
+    if (!middle1.count() || !middle2.count()) {
+        if (middle1.count()) {
+            results.data1_unmatchedBlocks.push_back(middle1);
+        }
+        if (middle2.count()) {
+            results.data2_unmatchedBlocks.push_back(middle2);
+        }
+    }
+
+    //the ends are matching blocks (the hash only orders the match sets; 0 is used for both)
+    if (ends.prefix) {
+        matches.insert(blockMatchSet(0, ends.prefix, 0, 0));
+    }
+    if (ends.suffix) {
+        matches.insert(blockMatchSet(0, ends.suffix, middle1.end, middle2.end));
+    }
+
+    results.matches.swap(matches);
+}
+
+/*static*/ void commonEnds::addEnds(    offsetMetrics::results& results,
+                                        const lengths& ends,
+                                        const unsigned int size1,
+                                        const unsigned int size2 )
+{
+    const indexRange middle1 = getMiddle(ends, size1);
+    const indexRange middle2 = getMiddle(ends, size2);
+
+    moveRanges(results.file1_matches,     ends.prefix);
+    moveRanges(results.file1_differences, ends.prefix);
+    moveRanges(results.file2_matches,     ends.prefix);
+    moveRanges(results.file2_differences, ends.prefix);
+
+    for (rangeMatch& alignmentRange : results.alignmentRanges) {
+        ASSERT(noSumOverflow(alignmentRange.getEndInFile1(), ends.prefix));
+        ASSERT(noSumOverflow(alignmentRange.getEndInFile2(), ends.prefix));
+        alignmentRange.startIndexInFile1 += ends.prefix;
+        alignmentRange.startIndexInFile2 += ends.prefix;
+    }
+
+    //a middle with nothing to match against is all difference
+    if (!middle1.count() || !middle2.count()) {
+        if (middle1.count()) {
+            results.file1_differences.push_back(middle1);
+        }
+        if (middle2.count()) {
+            results.file2_differences.push_back(middle2);
+        }
+    }
+
+    //the ends are matches, each in its own alignment range (keeping the alignment ranges in file 1 order)
+    if (ends.prefix) {
+        results.file1_matches.emplace_front(0, ends.prefix);
+        results.file2_matches.emplace_front(0, ends.prefix);
+        results.alignmentRanges.emplace_front(0, 0, ends.prefix);
+    }
+    if (ends.suffix) {
+        results.file1_matches.emplace_back(middle1.end, size1);
+        results.file2_matches.emplace_back(middle2.end, size2);
+        results.alignmentRanges.emplace_back(middle1.end, middle2.end, ends.suffix);
+    }
+}
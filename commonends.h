@@ -0,0 +1,63 @@
+#ifndef COMMONENDS_H
+#define COMMONENDS_H
+
+#include <vector>
+
+#include "indexrange.h"
+#include "comparison.h"
+#include "offsetmetrics.h"
+#include "defensivecoding.h"
+
+/*
+    finds the identical bytes at the start (prefix) and end (suffix) of 2 data sets,
+     so a comparison only has to search the differing middles
+
+    most compared files are versions of each other that only differ in a small part:
+     the middles are compared (see comparisonThread), then addEnds() turns the results for the middles
+     into results for the whole data sets
+
+    the bytes are compared with utilities::getCommonPrefixLength and getCommonSuffixLength
+*/
+
+class commonEnds
+{
+public:
+    commonEnds() = delete;  //static functions only
+
+    class lengths {
+    public:
+        unsigned int prefix;    //identical bytes at the start of both data sets
+        unsigned int suffix;    //identical bytes at the end of both data sets (not overlapping the prefix)
+
+        lengths() : prefix(0), suffix(0) {}
+    };
+
+    //the common prefix, then the common suffix of the bytes after it
+    // (so if the data sets are identical, the whole of them is prefix)
+    static lengths find(    const std::vector<unsigned char>& data1,
+                            const std::vector<unsigned char>& data2 );
+
+    //true if comparing only the middles is worth moving their results and adding the ends to them:
+    // at least MIN_TRIM_LENGTH bytes are common, or a middle is empty (there's nothing left to search)
+    static bool isWorthTrimming(const lengths& ends, const unsigned int size1, const unsigned int size2);
+
+    //the bytes between the prefix and the suffix of a data set of this size
+    static indexRange getMiddle(const lengths& ends, const unsigned int size);
+
+    //turns results for the middles (indexed from the start of the middles) into results for the whole data sets:
+    // indices are moved past the prefix, and the prefix and suffix are added as matches
+    //if a middle is empty, results should be empty: the other middle (if any) is added as a difference
+    static void addEnds(    comparison::results& results,
+                            const lengths& ends,
+                            const unsigned int size1,
+                            const unsigned int size2 );
+
+    static void addEnds(    offsetMetrics::results& results,
+                            const lengths& ends,
+                            const unsigned int size1,
+                            const unsigned int size2 );
+
+    static const unsigned int MIN_TRIM_LENGTH = 1 << 16;
+};
+
+#endif // COMMONENDS_H
@@ -0,0 +1,94 @@
+#include "commonends.h"
+#include "gtestDefs.h"
+#include <gtest.h>
+
+TEST(commonEnds, find){
+    const std::vector<unsigned char> data1 = gtestDefs::randomData(1000, 45);
+
+    //identical: all prefix
+    commonEnds::lengths ends = commonEnds::find(data1, data1);
+    EXPECT_EQ(1000u, ends.prefix);
+    EXPECT_EQ(0u, ends.suffix);
+
+    //5 bytes inserted at 300
+    std::vector<unsigned char> data2(data1);
+    data2.insert(data2.begin() + 300, 5, 0);
+    ends = commonEnds::find(data1, data2);
+    EXPECT_EQ(300u, ends.prefix);
+    EXPECT_EQ(700u, ends.suffix);
+    EXPECT_EQ(indexRange(300, 300), commonEnds::getMiddle(ends, 1000));
+    EXPECT_EQ(indexRange(300, 305), commonEnds::getMiddle(ends, 1005));
+    EXPECT_TRUE(commonEnds::isWorthTrimming(ends, 1000, 1005));
+
+    //repeated bytes can't be counted in both the prefix and the suffix
+    const std::vector<unsigned char> zeros1(10, 0);
+    const std::vector<unsigned char> zeros2(12, 0);
+    ends = commonEnds::find(zeros1, zeros2);
+    EXPECT_EQ(10u, ends.prefix);
+    EXPECT_EQ(0u, ends.suffix);
+
+    EXPECT_FALSE(commonEnds::isWorthTrimming(commonEnds::find(data1, gtestDefs::randomData(1000, 46)), 1000, 1000));
+}
+
+TEST(commonEnds, addEndsToSequentialResults){
+    commonEnds::lengths ends;
+    ends.prefix = 100;
+    ends.suffix = 50;
+
+    //middles: [100, 120) in file 1 and [100, 110) in file 2
+    offsetMetrics::results results;
+    results.file1_matches.emplace_back(0, 10);
+    results.file1_differences.emplace_back(10, 20);
+    results.file2_matches.emplace_back(0, 10);
+    results.alignmentRanges.emplace_back(0, 0, 10);
+
+    commonEnds::addEnds(results, ends, 170, 160);
+
+    EXPECT_EQ(std::list<indexRange>({indexRange(0, 100), indexRange(100, 110), indexRange(120, 170)}), results.file1_matches);
+    EXPECT_EQ(std::list<indexRange>({indexRange(110, 120)}), results.file1_differences);
+    EXPECT_EQ(std::list<indexRange>({indexRange(0, 100), indexRange(100, 110), indexRange(110, 160)}), results.file2_matches);
+    EXPECT_TRUE(results.file2_differences.empty());
+
+    ASSERT_EQ(3u, results.alignmentRanges.size());
+    EXPECT_EQ(50u, results.alignmentRanges.back().byteCount);
+    EXPECT_EQ(0u, results.alignmentRanges.front().startIndexInFile1);
+    EXPECT_EQ(100u, std::next(results.alignmentRanges.begin())->startIndexInFile1);
+    EXPECT_EQ(120u, results.alignmentRanges.back().startIndexInFile1);
+    EXPECT_EQ(110u, results.alignmentRanges.back().startIndexInFile2);
+}
+
+TEST(commonEnds, addEndsToLargestBlockResults){
+    commonEnds::lengths ends;
+    ends.prefix = 100;
+    ends.suffix = 0;
+
+    //file 2 is file 1 with 8 bytes appended: nothing is left to compare in file 1
+    comparison::results results;
+    commonEnds::addEnds(results, ends, 100, 108);
+
+    ASSERT_EQ(1u, results.matches.size());
+    EXPECT_EQ(100u, results.matches.begin()->blockSize);
+    EXPECT_EQ(indexRunList({0}), results.matches.begin()->data1_BlockStartIndices);
+    EXPECT_TRUE(results.data1_unmatchedBlocks.empty());
+    EXPECT_EQ(std::list<indexRange>({indexRange(100, 108)}), results.data2_unmatchedBlocks);
+
+    //a match set of the middles is moved past the prefix
+    comparison::results middleResults;
+    middleResults.matches.insert(blockMatchSet(7, 4, 2, 3));
+    middleResults.data1_unmatchedBlocks.emplace_back(0, 2);
+    ends.suffix = 10;
+    commonEnds::addEnds(middleResults, ends, 116, 117);
+
+    EXPECT_EQ(3u, middleResults.matches.size());
+    for (const blockMatchSet& match : middleResults.matches) {
+        if (7 == match.hash) {
+            EXPECT_EQ(indexRunList({102}), match.data1_BlockStartIndices);
+            EXPECT_EQ(indexRunList({103}), match.data2_BlockStartIndices);
+        }
+        else if (10 == match.blockSize) {
+            EXPECT_EQ(indexRunList({106}), match.data1_BlockStartIndices);
+            EXPECT_EQ(indexRunList({107}), match.data2_BlockStartIndices);
+        }
+    }
+    EXPECT_EQ(std::list<indexRange>({indexRange(100, 102)}), middleResults.data1_unmatchedBlocks);
+}
@@ -2,8 +2,8 @@
 
 /*static*/ std::atomic_bool comparison::m_abort{false};
 
-/*static*/ unsigned int comparison::findLargestMatchingBlocks(  const std::vector<unsigned char>&   data1,
-                                                                const std::vector<unsigned char>&   data2,
+/*static*/ unsigned int comparison::findLargestMatchingBlocks(  const byteSpan&                     data1,
+                                                                const byteSpan&                     data2,
                                                                 const std::multiset<indexRange>&    data1SkipRanges,
                                                                 const std::multiset<indexRange>&    data2SkipRanges,
                                                                       std::multiset<blockMatchSet>& matches )
@@ -105,8 +105,8 @@ if resultMatches is nullptr, results won't being returned, so
 
 */
 /*static*/ bool comparison::blockMatchSearch(   const unsigned int                  blockLength,
-                                                const std::vector<unsigned char>&   data1,
-                                                const std::vector<unsigned char>&   data2,
+                                                const byteSpan&                     data1,
+                                                const byteSpan&                     data2,
                                                 const std::multiset<indexRange>&    data1SkipRanges,
                                                 const std::multiset<indexRange>&    data2SkipRanges,
                                                       std::multiset<blockMatchSet>* resultMatches /*= nullptr*/ )
@@ -144,9 +144,13 @@ if resultMatches is nullptr, results won't being returned, so
         }
     };
 
-    //quickly searchable storage
-    //(not a vector, so we need to record the index in a HashIndexPair)
-    std::multiset<HashIndexPair> hashes2;
+    //quickly searchable storage: sorted by hash after all hashes are added
+    // (the sort is stable, so blocks with equal hashes stay in index order)
+    //(sorting changes the order, so we need to record the index in a HashIndexPair)
+    std::vector<HashIndexPair> hashes2;
+
+    //blockMatchSets found so far (moved to resultMatches when the search is done)
+    blockMatchStore store;
 
 
     auto isBlockSkipped = [&blockLength](const unsigned int startIndex, const std::multiset<indexRange>& skipRanges) {
@@ -171,11 +175,15 @@ if resultMatches is nullptr, results won't being returned, so
          hashes1.push_back(hashValue);
     };
 
-    auto addToHashes2 = [&hashes2](unsigned int hashValue, unsigned int index){
-         hashes2.insert(HashIndexPair(hashValue, index));
+    //skipped data set 2 blocks are left out: they can't be matched
+    // (so a long skipped repetitive region isn't searched again for every data set 1 block with the same hash)
+    auto addToHashes2 = [&hashes2, &isBlockSkipped, &data2SkipRanges](unsigned int hashValue, unsigned int index){
+         if (!isBlockSkipped(index, data2SkipRanges)) {
+             hashes2.push_back(HashIndexPair(hashValue, index));
+         }
     };
 
-    auto getAllHashes = [blockLength](const std::vector<unsigned char>& data, std::function<void(unsigned int, unsigned int)> storeHashValue)
+    auto getAllHashes = [blockLength](const byteSpan& data, std::function<void(unsigned int, unsigned int)> storeHashValue)
     {
         if (data.size() < blockLength) {return;}    //if there isn't enough for a full block, just return
 
@@ -200,8 +208,8 @@ if resultMatches is nullptr, results won't being returned, so
         }
     };
 
-    auto blocksAreBytewiseEqual = [&blockLength](   const unsigned int block1StartIndex, const std::vector<unsigned char>& data1,
-                                                    const unsigned int block2StartIndex, const std::vector<unsigned char>& data2) -> bool
+    auto blocksAreBytewiseEqual = [&blockLength](   const unsigned int block1StartIndex, const byteSpan& data1,
+                                                    const unsigned int block2StartIndex, const byteSpan& data2) -> bool
     {
         for (unsigned int i = 0; i < blockLength; ++i) {
             if (    data1[block1StartIndex + i]
@@ -213,13 +221,41 @@ if resultMatches is nullptr, results won't being returned, so
         return true;
     };
 
+    //true if the block at startIndex continues the last run of indices (with period < blockLength) in a blockMatchSet index list
+    //
+    //  the run's last 2 blocks are equal (they're in the same blockMatchSet), so data[j] == data[j - period]
+    //   for j in [lastIndex, lastIndex + blockLength); the block at startIndex = lastIndex + period is equal to them
+    //   if that continues for j up to startIndex + blockLength: only the last period bytes need to be compared
+    //  (so each block of a zero-filled region is matched with 1 byte comparison instead of blockLength)
+    auto continuesPeriodicRun = [&blockLength](const indexRunList& indices, const unsigned int startIndex, const byteSpan& data) -> bool
+    {
+        if (indices.empty()) {
+            return false;
+        }
+
+        const indexRunList::run& lastRun = indices.getRuns().back();
+        const unsigned int period = lastRun.period;
+        const unsigned int lastIndex = lastRun.getLast();
+
+        if (lastRun.count < 2 || period >= blockLength || startIndex <= lastIndex || startIndex - lastIndex != period) {
+            return false;
+        }
+
+        for (unsigned int j = lastIndex + blockLength; j < startIndex + blockLength; ++j) {
+            if (data[j] != data[j - period]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
     //adds a block to an existing blockMatchSet, if there is one
     //returns false if this index/dataset's byte contents are not already in a blockMatchSet
-    auto addToExistingBlockMatchSet = [&resultMatches, &blockLength, &data1, &data2, &blocksAreBytewiseEqual, &spuriousHashCollisions]
+    auto addToExistingBlockMatchSet = [&store, &data1, &data2, &blocksAreBytewiseEqual, &continuesPeriodicRun, &spuriousHashCollisions]
                                       (const unsigned int hash, const unsigned int startIndex, const whichDataSet&& source) -> bool
     {
         //select source data set to refer to
-        const std::vector<unsigned char> *sourceDataSet = nullptr;
+        const byteSpan *sourceDataSet = nullptr;
         if (whichDataSet::first == source) {
             sourceDataSet = &data1;
         }
@@ -230,46 +266,36 @@ if resultMatches is nullptr, results won't being returned, so
             FAIL();
         }
 
-        //find all blockMatchSets with the hash we're looking for
-        auto matchRange = resultMatches->equal_range(blockMatchSet(hash,0,0,0));
+        //iterate through all blockMatchSets with the hash we're looking for
+        for (unsigned int id = store.findFirst(hash); blockMatchStore::NONE != id; id = store.findNext(id)) {
 
-        //iterate through them
-        auto iter = matchRange.first;
-        for ( ; iter != matchRange.second; ++iter ) {
+            blockMatchSet& matchSet = store[id];
+            indexRunList* addToThisIndexList = nullptr;
+
+            if (whichDataSet::first == source) {
+                addToThisIndexList = &matchSet.data1_BlockStartIndices;
+            }
+            else if (whichDataSet::second == source) {
+                addToThisIndexList = &matchSet.data2_BlockStartIndices;
+            }
+            else {
+                FAIL();
+            }
 
             //get a reference index in data set 1 as a source of the byte contents represented by this blockMatchSet
-            ASSERT(1 <= iter->data1_BlockStartIndices.size());
-            unsigned int referenceIndex = iter->data1_BlockStartIndices[0];
+            ASSERT(1 <= matchSet.data1_BlockStartIndices.size());
+            unsigned int referenceIndex = matchSet.data1_BlockStartIndices.front();
 
             //see if the byte contents of this blockMatchSet actually match the block we're trying to add (i.e., not a hash collision)
-            if (blocksAreBytewiseEqual(referenceIndex, data1, startIndex, *sourceDataSet)) {
+            // (a block continuing a periodic run of this blockMatchSet's blocks is checked with fewer byte comparisons)
+            if (    continuesPeriodicRun(*addToThisIndexList, startIndex, *sourceDataSet)
+                 || blocksAreBytewiseEqual(referenceIndex, data1, startIndex, *sourceDataSet)) {
 
                 //match found, add this block to the matching blockMatchSet
-
-                const std::vector<unsigned int>* addToThisIndexList = nullptr;
-
-                if (whichDataSet::first == source) {
-                    addToThisIndexList = &iter->data1_BlockStartIndices;
-                }
-                else if (whichDataSet::second == source) {
-                    addToThisIndexList = &iter->data2_BlockStartIndices;
-                }
-                else {
-                    FAIL();
-                }
-
-                //why is breaking const ok here?:
-                //const-ness of std::multiset elements preserves the sorted-ness of the container
-                //  changes are intended to be done by removing the element and reinserting a new one,
-                //  so it is sorted into the right place for its new contents
-                //(if there's another reason, this may not be ok)
-                //blockMatchSet's < operator only uses its hash value, so changing other members shouldn't break sorted-ness
-
-                auto tmp = const_cast<std::vector<unsigned int>*>(addToThisIndexList);
-                tmp->emplace_back(startIndex);
+                addToThisIndexList->push_back(startIndex);
 
                 //we found a match and stored this block in it, stop searching
-                break;
+                return true;
             }
             else {
                 //the blocks didn't match each other: a spurious hash collision occurred
@@ -277,11 +303,7 @@ if resultMatches is nullptr, results won't being returned, so
             }
         }
 
-        //if the iterator isn't at the end of matchRange, the current block has been assigned to a pre-existing blockMatchSet
-        if (iter != matchRange.second) {
-            return true;
-        }
-
+        //if this is reached, the current block hasn't been assigned to a pre-existing blockMatchSet
         return false;
     };
 
@@ -291,6 +313,7 @@ if resultMatches is nullptr, results won't being returned, so
 
     getAllHashes(data1, addToHashes1);
     getAllHashes(data2, addToHashes2);
+    std::stable_sort(hashes2.begin(), hashes2.end());
 
     //loop through all the hashes of blocks from data set 1
     //(they're stored in order, so the index in hashes1[] is also the start index of the block in data1)
@@ -319,29 +342,34 @@ if resultMatches is nullptr, results won't being returned, so
         }
 
         //get all the blocks in data set 2 with hashes equal to the current data set 1 block
-        auto matchRange = hashes2.equal_range(HashIndexPair(data1BlockHash,0));
+        auto matchRange = std::equal_range(hashes2.begin(), hashes2.end(), HashIndexPair(data1BlockHash,0));
+
+        //the blockMatchSet made for this block's byte contents (when the first data set 2 match is found)
+        // (its byte contents aren't in any other blockMatchSet: if they were, this block would have been added to it above)
+        unsigned int newMatchSet = blockMatchStore::NONE;
 
         //iterate through them and make sure they actually match (i.e., not a hash collision)
+        // (they're in increasing index order, so a run of them in a repetitive region can be matched as a periodic run)
         for (auto iter = matchRange.first; iter != matchRange.second; ++iter ) {
 
+            //(blocks to be skipped (i.e., that would overlap previously completed match results) aren't in hashes2)
             unsigned int data2BlockStartIndex = iter->index;
 
-            if (isBlockSkipped(data2BlockStartIndex, data2SkipRanges)) {
-                //if this block is to be skipped (i.e., would overlap previously completed match results), skip it
-                continue;
-            }
+            const bool continuesRun =    blockMatchStore::NONE != newMatchSet
+                                      && continuesPeriodicRun(store[newMatchSet].data2_BlockStartIndices, data2BlockStartIndex, data2);
 
-            if (blocksAreBytewiseEqual(data1BlockStartIndex, data1, data2BlockStartIndex, data2)){
+            if (continuesRun || blocksAreBytewiseEqual(data1BlockStartIndex, data1, data2BlockStartIndex, data2)){
                 //match found
                 if(!resultMatches) {
                     return true;    //if no output storage is provided by the caller, just return the result
                 }
 
-                //add this block to a blockMatchSet:
-                //add this block to an existing blockMatchSet that matches its byte contents (if there is one)
-                if (!addToExistingBlockMatchSet(data1BlockHash, data2BlockStartIndex, whichDataSet::second)) {
-                    //if not, make a new blockMatchSet and add this block pair
-                    resultMatches->emplace(data1BlockHash, blockLength, data1BlockStartIndex, data2BlockStartIndex);
+                //add this block pair to a new blockMatchSet, or the block to the one made for an earlier match
+                if (blockMatchStore::NONE == newMatchSet) {
+                    newMatchSet = store.add(data1BlockHash, blockLength, data1BlockStartIndex, data2BlockStartIndex);
+                }
+                else {
+                    store[newMatchSet].data2_BlockStartIndices.push_back(data2BlockStartIndex);
                 }
                 matchFound = true;  //update return value to reflect successful match
             }
@@ -353,6 +381,8 @@ if resultMatches is nullptr, results won't being returned, so
     }
 
     if (resultMatches) {
+        store.moveTo(*resultMatches);
+
         //return true if a blockMatchSet was added
         return matchFound;
     }
@@ -362,8 +392,8 @@ if resultMatches is nullptr, results won't being returned, so
 }
 
 /*static*/ void comparison::chooseValidMatchSet( blockMatchSet& match,
-                                                 const std::vector<unsigned int>& alreadyChosen1,
-                                                 const std::vector<unsigned int>& alreadyChosen2 )
+                                                 const std::multiset<indexRange>& alreadyChosen1,
+                                                 const std::multiset<indexRange>& alreadyChosen2 )
 {
     //called with blockMatchSet cast to non-const: don't modify blockMatchSet::hash or multiset ordering will be disrupted
 
@@ -372,46 +402,63 @@ if resultMatches is nullptr, results won't being returned, so
     ASSERT(indexRange::isNonDecreasing(match.data2_BlockStartIndices));
 
     //step forward through the index lists, accepting the first block and then all future non-overlapping blocks (greedy algorithm)
+    // (within a periodic run, the blocks overlapping the last accepted block are stepped over all at once)
     const unsigned int blockLength = match.blockSize;
-    auto makeValidList = [&blockLength](const std::vector<unsigned int>& indices,
-                                              std::vector<unsigned int>& validIndices,
-                                        const std::vector<unsigned int>& alreadyChosen ) {
-
-        for (unsigned int index : indices) {
-
-            //if this block would overlap a block already validated in another blockMatchSet, skip it
-            ASSERT(    noSumOverflow( index,blockLength));
-            indexRange current(index, index+blockLength);
-            if (current.overlapsAnyIn(alreadyChosen, blockLength)) {
-                continue;
-            }
+    auto makeValidList = [&blockLength](const indexRunList& indices,
+                                              indexRunList& validIndices,
+                                        const std::multiset<indexRange>& alreadyChosen ) {
+
+        for (const indexRunList::run& run : indices.getRuns()) {
+
+            unsigned int step = 0;
+            while (step < run.count) {
+                const unsigned int index = run.start + step*run.period;
+
+                //if this block would overlap a block already validated in another blockMatchSet,
+                // skip to the first block in the run past that one
+                ASSERT(    noSumOverflow( index,blockLength));
+                indexRange current(index, index+blockLength);
+                auto chosen = current.findOverlapInSorted(alreadyChosen);
+                if (chosen != alreadyChosen.end()) {
+                    if (0 == run.period) {
+                        break;  //(a run of 1)
+                    }
+                    step = (chosen->end - run.start + run.period - 1)/run.period;
+                    continue;
+                }
 
-            if ( 0 == validIndices.size() ) {
-                validIndices.push_back(index);  //just add the first index as valid
-            }
-            else {
                 //compare the current block to the last validated block
-                unsigned int lastValidStart = validIndices.back();
-                ASSERT(               noSumOverflow( lastValidStart,blockLength));
-                indexRange lastValid(lastValidStart, lastValidStart+blockLength);
-
-                //add the current block only if it doesn't overlap the validated block
-                if ( !current.overlaps(lastValid) ) {
-                    validIndices.push_back(index);
+                if (!validIndices.empty()) {
+                    unsigned int lastValidStart = validIndices.back();
+                    ASSERT(               noSumOverflow( lastValidStart,blockLength));
+                    indexRange lastValid(lastValidStart, lastValidStart+blockLength);
+
+                    //skip to the first block in the run that doesn't overlap the validated block
+                    if (current.overlaps(lastValid)) {
+                        if (0 == run.period) {
+                            break;  //(a run of 1)
+                        }
+                        step = (lastValid.end - run.start + run.period - 1)/run.period;
+                        continue;
+                    }
                 }
+
+                //add the current block (it doesn't overlap the validated block)
+                validIndices.push_back(index);
+                ++step;
             }
         }
     };
 
-    std::vector<unsigned int> validated_data1_BlockStartIndices;
-    std::vector<unsigned int> validated_data2_BlockStartIndices;
+    indexRunList validated_data1_BlockStartIndices;
+    indexRunList validated_data2_BlockStartIndices;
 
     makeValidList(match.data1_BlockStartIndices, validated_data1_BlockStartIndices, alreadyChosen1);
     makeValidList(match.data2_BlockStartIndices, validated_data2_BlockStartIndices, alreadyChosen2);
 
 
     //truncate the longer list to the shorter list's length
-    unsigned long count = std::min( validated_data1_BlockStartIndices.size(),
+    unsigned int count = std::min(  validated_data1_BlockStartIndices.size(),
                                     validated_data2_BlockStartIndices.size());
 
     validated_data1_BlockStartIndices.resize(count);
@@ -426,30 +473,26 @@ if resultMatches is nullptr, results won't being returned, so
 
 /*static*/ void comparison::chooseValidMatchSets( std::multiset<blockMatchSet>& matches ) {
 
-    //lists of already chosen blocks from previous iterations
+    //already chosen blocks from previous iterations, as sorted non-overlapping ranges
     // (to ensure that valid match sets in matches are chosen without overlapping each other)
-    std::vector<unsigned int> alreadyChosen1;
-    std::vector<unsigned int> alreadyChosen2;
-
-    auto appendVector = [](std::vector<unsigned int> appendThis, std::vector<unsigned int> toThis){
-        toThis.reserve(toThis.size() + appendThis.size());
-        toThis.insert(toThis.end(), appendThis.begin(), appendThis.end());
-    };
+    std::multiset<indexRange> alreadyChosen1;
+    std::multiset<indexRange> alreadyChosen2;
 
     //for (const blockMatchSet& match : matches) {
-    for (std::multiset<blockMatchSet>::iterator match = matches.begin(); match != matches.end(); ++match) {
+    for (std::multiset<blockMatchSet>::iterator match = matches.begin(); match != matches.end(); ) {
         //casting to non-const: don't modify blockMatchSet::hash or multiset ordering will be disrupted
         chooseValidMatchSet(const_cast<blockMatchSet&>(*match), alreadyChosen1, alreadyChosen2);
 
-        //remove match if empty
+        //remove match if empty (erase returns the next match)
         if (    ( 0 == match->data1_BlockStartIndices.size())
              && ( 0 == match->data2_BlockStartIndices.size()) ) {
             match = matches.erase(match);
         }
         else {
             //record chosen blocks
-            appendVector(match->data1_BlockStartIndices, alreadyChosen1);
-            appendVector(match->data2_BlockStartIndices, alreadyChosen2);
+            addBlocksAsRanges(match->data1_BlockStartIndices, match->blockSize, alreadyChosen1);
+            addBlocksAsRanges(match->data2_BlockStartIndices, match->blockSize, alreadyChosen2);
+            ++match;
         }
     }
 }
@@ -459,15 +502,27 @@ if resultMatches is nullptr, results won't being returned, so
                                                            std::multiset<indexRange>&     data2SkipRanges )
 {
     for (const blockMatchSet& match : matches) {
+        addBlocksAsRanges(match.data1_BlockStartIndices, match.blockSize, data1SkipRanges);
+        addBlocksAsRanges(match.data2_BlockStartIndices, match.blockSize, data2SkipRanges);
+    }
+}
 
-        for (auto& index : match.data1_BlockStartIndices) {
-            ASSERT(noSumOverflow(          index,match.blockSize));
-            data1SkipRanges.emplace(index, index+match.blockSize);
+template <typename T>
+/*static*/ void comparison::addBlocksAsRanges(const indexRunList& startIndices, const unsigned int blockSize, T& ranges)
+{
+    for (const indexRunList::run& run : startIndices.getRuns()) {
+
+        //a run of adjacent blocks is one range
+        if (1 < run.count && run.period == blockSize) {
+            ASSERT(noSumOverflow(run.getLast(), blockSize));
+            ranges.insert(ranges.end(), indexRange(run.start, run.getLast() + blockSize));
+            continue;
         }
 
-        for (auto& index : match.data2_BlockStartIndices) {
-            ASSERT(noSumOverflow(          index,match.blockSize));
-            data2SkipRanges.emplace(index, index+match.blockSize);
+        for (unsigned int step = 0; step < run.count; ++step) {
+            const unsigned int start = run.start + step*run.period;
+            ASSERT(noSumOverflow(start, blockSize));
+            ranges.insert(ranges.end(), indexRange(start, start + blockSize));
         }
     }
 }
@@ -480,15 +535,12 @@ if resultMatches is nullptr, results won't being returned, so
 
     for (auto& match : matches) {
 
-        const std::vector<unsigned int>& startIndices =
+        const indexRunList& startIndices =
                 whichDataSet::first == which
                 ? match.data1_BlockStartIndices
                 : match.data2_BlockStartIndices;
 
-        for (auto& start : startIndices) {
-            ASSERT(noSumOverflow(         start,match.blockSize));
-            allBlocks.emplace_back(start, start+match.blockSize);
-        }
+        addBlocksAsRanges(startIndices, match.blockSize, allBlocks);
     }
 
     allBlocks.sort();
@@ -509,10 +561,10 @@ if resultMatches is nullptr, results won't being returned, so
     return copiesOfAddedBlocks;
 }
 
-/*static*/ std::unique_ptr<comparison::results> comparison::doCompare(  const std::vector<unsigned char>& data1,
-                                                                        const std::vector<unsigned char>& data2 )
+/*static*/ std::unique_ptr<comparison::results> comparison::doCompare(  const byteSpan& data1,
+                                                                        const byteSpan& data2 )
 {
-    m_abort = false; //clear abort flag
+    //(the abort flag isn't cleared here: an abort requested before the comparison starts still applies, see clearAbort)
 
     auto Results = std::unique_ptr<comparison::results>( new comparison::results );
 
@@ -578,3 +630,8 @@ void comparison::abort()
 {
     m_abort = true;
 }
+
+void comparison::clearAbort()
+{
+    m_abort = false;
+}
@@ -8,7 +8,10 @@
 #include <utility>
 #include <atomic>
 #include "blockmatchset.h"
+#include "blockmatchstore.h"
+#include "indexrunlist.h"
 #include "indexrange.h"
+#include "bytespan.h"
 #include "buzhash.h"
 
 #include "defensivecoding.h"
@@ -43,22 +46,22 @@ public:
 
 
 
-    static unsigned int findLargestMatchingBlocks(  const std::vector<unsigned char>&   data1,
-                                                    const std::vector<unsigned char>&   data2,
+    static unsigned int findLargestMatchingBlocks(  const byteSpan&                     data1,
+                                                    const byteSpan&                     data2,
                                                     const std::multiset<indexRange>&    data1SkipRanges,
                                                     const std::multiset<indexRange>&    data2SkipRanges,
                                                           std::multiset<blockMatchSet>& matches );
 
     static bool blockMatchSearch(   const unsigned int blockLength,
-                                    const std::vector<unsigned char>& data1,
-                                    const std::vector<unsigned char>& data2,
+                                    const byteSpan& data1,
+                                    const byteSpan& data2,
                                     const std::multiset<indexRange>& data1SkipRanges,
                                     const std::multiset<indexRange>& data2SkipRanges,
                                           std::multiset<blockMatchSet>* allMatches = nullptr );
 
     static void chooseValidMatchSet(       blockMatchSet& match,
-                                     const std::vector<unsigned int>& alreadyChosen1,
-                                     const std::vector<unsigned int>& alreadyChosen2 );
+                                     const std::multiset<indexRange>& alreadyChosen1,
+                                     const std::multiset<indexRange>& alreadyChosen2 );
 
     static void chooseValidMatchSets( std::multiset<blockMatchSet>& matches );
 
@@ -70,14 +73,20 @@ public:
                                                                         const std::multiset<blockMatchSet>& matches,
                                                                         const whichDataSet which );
 
-    static std::unique_ptr<comparison::results> doCompare(  const std::vector<unsigned char>& data1,
-                                                            const std::vector<unsigned char>& data2 );
+    static std::unique_ptr<comparison::results> doCompare(  const byteSpan& data1,
+                                                            const byteSpan& data2 );
 
     static void abort();
+    static void clearAbort();   //call before starting a new comparison
 
 private:
     static std::atomic_bool m_abort;  //abort flag
 
+    //adds the blocks at startIndices to ranges (a std::multiset or std::list of indexRanges),
+    // as one range for each run of adjacent blocks
+    template <typename T>
+    static void addBlocksAsRanges(const indexRunList& startIndices, const unsigned int blockSize, T& ranges);
+
 };
 
 #endif // COMPARISON_H
@@ -0,0 +1,236 @@
+#include "comparison.h"
+#include <algorithm>
+#include <array>
+#include <map>
+#include "gtestDefs.h"
+#include <gtest.h>
+
+namespace {
+
+    //a copy of data with length copies of byte inserted at index
+    std::vector<unsigned char> insertPadding(std::vector<unsigned char> data, const unsigned int index,
+                                             const unsigned int length, const unsigned char byte)
+    {
+        data.insert(data.begin() + index, length, byte);
+        return data;
+    }
+
+    //a copy of data with repeatCount copies of a period byte table inserted at index
+    std::vector<unsigned char> insertRepeatedTable(std::vector<unsigned char> data, const unsigned int index,
+                                                   const unsigned int period, const unsigned int repeatCount)
+    {
+        std::vector<unsigned char> table(period);
+        for (unsigned int i = 0; i < period; ++i) {
+            table[i] = static_cast<unsigned char>(i*37 + 1);
+        }
+        for (unsigned int i = 0; i < repeatCount; ++i) {
+            data.insert(data.begin() + index, table.begin(), table.end());
+        }
+        return data;
+    }
+
+    //the matched blocks and unmatched blocks of one file, in order
+    std::vector<indexRange> getFileRanges(const comparison::results& results, const comparison::whichDataSet which)
+    {
+        std::vector<indexRange> ranges;
+        for (const blockMatchSet& match : results.matches) {
+            const indexRunList& indices = (comparison::whichDataSet::first == which) ? match.data1_BlockStartIndices
+                                                                                      : match.data2_BlockStartIndices;
+            for (const unsigned int index : indices) {
+                ranges.push_back(indexRange(index, index + match.blockSize));
+            }
+        }
+
+        const std::list<indexRange>& unmatched = (comparison::whichDataSet::first == which) ? results.data1_unmatchedBlocks
+                                                                                             : results.data2_unmatchedBlocks;
+        ranges.insert(ranges.end(), unmatched.begin(), unmatched.end());
+
+        std::sort(ranges.begin(), ranges.end());
+        return ranges;
+    }
+
+    //the matches are equal in both files, don't overlap each other, and with the unmatched blocks cover each file exactly
+    void expectValidResults(const comparison::results& results, const std::vector<unsigned char>& data1, const std::vector<unsigned char>& data2)
+    {
+        EXPECT_FALSE(results.aborted);
+        EXPECT_FALSE(results.internalError);
+
+        for (const blockMatchSet& match : results.matches) {
+            ASSERT_FALSE(match.data1_BlockStartIndices.empty());
+            ASSERT_FALSE(match.data2_BlockStartIndices.empty());
+
+            const unsigned int reference = match.data1_BlockStartIndices.front();
+            for (const unsigned int index : match.data1_BlockStartIndices) {
+                EXPECT_TRUE(std::equal(data1.begin() + index, data1.begin() + index + match.blockSize, data1.begin() + reference));
+            }
+            for (const unsigned int index : match.data2_BlockStartIndices) {
+                EXPECT_TRUE(std::equal(data2.begin() + index, data2.begin() + index + match.blockSize, data1.begin() + reference));
+            }
+        }
+
+        for (const comparison::whichDataSet which : {comparison::whichDataSet::first, comparison::whichDataSet::second}) {
+            const unsigned int size = static_cast<unsigned int>((comparison::whichDataSet::first == which) ? data1.size() : data2.size());
+
+            //each range starts where the one before it ends (no overlaps or gaps)
+            unsigned int next = 0;
+            for (const indexRange& r : getFileRanges(results, which)) {
+                EXPECT_EQ(next, r.start);
+                EXPECT_LT(r.start, r.end);
+                next = r.end;
+            }
+            EXPECT_EQ(size, next);
+        }
+    }
+
+    //the matches as {data1 index, data2 index, block size}, sorted (for matches found once in each file)
+    std::vector<std::array<unsigned int, 3>> getSingleMatches(const comparison::results& results)
+    {
+        std::vector<std::array<unsigned int, 3>> singleMatches;
+        for (const blockMatchSet& match : results.matches) {
+            EXPECT_EQ(1u, match.data1_BlockStartIndices.size());
+            EXPECT_EQ(1u, match.data2_BlockStartIndices.size());
+            singleMatches.push_back({match.data1_BlockStartIndices.front(), match.data2_BlockStartIndices.front(), match.blockSize});
+        }
+        std::sort(singleMatches.begin(), singleMatches.end());
+        return singleMatches;
+    }
+
+    //the start indices of every block in data1 and data2, grouped by block contents
+    // (the blockMatchSets blockMatchSearch should find: one for each block contents found in both)
+    typedef std::map<std::vector<unsigned char>, std::array<std::vector<unsigned int>, 2>> blockIndexMap;
+    blockIndexMap findEqualBlocks(const unsigned int blockLength, const std::vector<unsigned char>& data1, const std::vector<unsigned char>& data2)
+    {
+        blockIndexMap blocks;
+        for (unsigned int i = 0; i + blockLength <= data1.size(); ++i) {
+            blocks[std::vector<unsigned char>(data1.begin() + i, data1.begin() + i + blockLength)][0].push_back(i);
+        }
+        for (unsigned int i = 0; i + blockLength <= data2.size(); ++i) {
+            blocks[std::vector<unsigned char>(data2.begin() + i, data2.begin() + i + blockLength)][1].push_back(i);
+        }
+
+        for (auto it = blocks.begin(); it != blocks.end(); ) {
+            it = (it->second[0].empty() || it->second[1].empty()) ? blocks.erase(it) : std::next(it);
+        }
+        return blocks;
+    }
+
+    std::unique_ptr<comparison::results> compare(const std::vector<unsigned char>& data1, const std::vector<unsigned char>& data2)
+    {
+        comparison::clearAbort();
+        std::unique_ptr<comparison::results> results = comparison::doCompare(data1, data2);
+        expectValidResults(*results, data1, data2);
+        return results;
+    }
+}
+
+TEST(comparison, randomData){
+    const std::vector<unsigned char> data1 = gtestDefs::makeTestData(3000, 1, 256);
+    std::vector<unsigned char> data2(data1);
+    data2[1500] ^= 1;
+
+    std::unique_ptr<comparison::results> results = compare(data1, data2);
+    EXPECT_EQ((std::vector<std::array<unsigned int, 3>>{ {{0, 0, 1500}}, {{1501, 1501, 1499}} }), getSingleMatches(*results));
+    EXPECT_EQ(std::list<indexRange>({indexRange(1500, 1501)}), results->data1_unmatchedBlocks);
+    EXPECT_EQ(std::list<indexRange>({indexRange(1500, 1501)}), results->data2_unmatchedBlocks);
+}
+
+//the results on padded and repetitive data are the ones found before block start indices were stored as periodic runs
+TEST(comparison, zeroPadding){
+    std::vector<unsigned char> data2 = gtestDefs::makeTestData(3000, 1, 256);
+    const std::vector<unsigned char> data1 = insertPadding(data2, 1000, 20000, 0);
+    data2[1500] ^= 1;
+    data2 = insertPadding(data2, 1200, 15000, 0);
+
+    std::unique_ptr<comparison::results> results = compare(data1, data2);
+    EXPECT_EQ((std::vector<std::array<unsigned int, 3>>{ {{    0,     0,  1000}},
+                                                         {{ 1000,  1200, 15000}},
+                                                         {{21000,  1000,   200}},
+                                                         {{21200, 16200,   300}},
+                                                         {{21501, 16501,  1499}} }), getSingleMatches(*results));
+    EXPECT_EQ(std::list<indexRange>({indexRange(16000, 21000), indexRange(21500, 21501)}), results->data1_unmatchedBlocks);
+    EXPECT_EQ(std::list<indexRange>({indexRange(16500, 16501)}), results->data2_unmatchedBlocks);
+}
+
+TEST(comparison, mixedPadding){
+    std::vector<unsigned char> data2 = gtestDefs::makeTestData(3000, 1, 256);
+    const std::vector<unsigned char> data1 = insertPadding(insertPadding(data2, 2000, 8000, 0xFF), 100, 3000, 0);
+    data2[1500] ^= 1;
+    data2 = insertPadding(data2, 2500, 9000, 0xFF);
+
+    std::unique_ptr<comparison::results> results = compare(data1, data2);
+    EXPECT_EQ((std::vector<std::array<unsigned int, 3>>{ {{    0,     0,  100}},
+                                                         {{ 3100,   100, 1400}},
+                                                         {{ 4501,  1501,  499}},
+                                                         {{ 5000,  2500, 8000}},
+                                                         {{13000,  2000,  500}},
+                                                         {{13500, 11500,  500}} }), getSingleMatches(*results));
+    EXPECT_EQ(std::list<indexRange>({indexRange(100, 3100), indexRange(4500, 4501)}), results->data1_unmatchedBlocks);
+    EXPECT_EQ(std::list<indexRange>({indexRange(1500, 1501), indexRange(10500, 11500)}), results->data2_unmatchedBlocks);
+}
+
+TEST(comparison, repeatedTable){
+    std::vector<unsigned char> data2 = gtestDefs::makeTestData(3000, 1, 256);
+    const std::vector<unsigned char> data1 = insertRepeatedTable(data2, 1000, 7, 500);
+    data2[1500] ^= 1;
+    data2 = insertRepeatedTable(data2, 300, 7, 400);
+
+    std::unique_ptr<comparison::results> results = compare(data1, data2);
+    EXPECT_EQ((std::vector<std::array<unsigned int, 3>>{ {{   0,    0,  300}},
+                                                         {{ 300, 3100,  700}},
+                                                         {{1000,  300, 2800}},
+                                                         {{4500, 3800,  500}},
+                                                         {{5001, 4301, 1499}} }), getSingleMatches(*results));
+    EXPECT_EQ(std::list<indexRange>({indexRange(3800, 4500), indexRange(5000, 5001)}), results->data1_unmatchedBlocks);
+    EXPECT_EQ(std::list<indexRange>({indexRange(4300, 4301)}), results->data2_unmatchedBlocks);
+}
+
+TEST(comparison, lowEntropy){
+    //(many short matches, some of them repeated in a file)
+    const std::vector<unsigned char> data1 = gtestDefs::makeTestData(4000, 3, 2);
+    const std::vector<unsigned char> data2 = gtestDefs::makeTestData(4000, 4, 2);
+
+    std::unique_ptr<comparison::results> results = compare(data1, data2);
+    EXPECT_FALSE(results->matches.empty());
+}
+
+//repeated blocks are stored as periodic runs, and a run is only continued while the data repeats
+TEST(comparison, blockMatchSearchPeriodicRuns){
+    const unsigned int blockLength = 64;
+
+    //zero padding (period 1), and tables with periods shorter than the block, with a changed byte inside a repeat
+    std::vector<unsigned char> data1 = gtestDefs::makeTestData(3000, 5, 256);
+    data1 = insertPadding(data1, 500, 300, 0);
+    data1 = insertRepeatedTable(data1, 1200, 7, 40);
+    data1[1200 + 7*20 + 3] ^= 1;
+    data1 = insertRepeatedTable(data1, 2000, 40, 10);
+
+    //(the hash rotates 32 bits, so swapping 2 bytes 32 apart leaves the hash of a block containing both unchanged:
+    // a block 4 repeats into the table is a hash collision with the run's block contents, continuing its period)
+    std::vector<unsigned char> data2 = gtestDefs::makeTestData(2000, 6, 256);
+    data2 = insertRepeatedTable(data2, 100, 7, 30);
+    data2 = insertPadding(data2, 900, 200, 0);
+    data2 = insertRepeatedTable(data2, 1500, 40, 10);
+    std::swap(data2[1500 + 40*4 + 2], data2[1500 + 40*4 + 34]);
+
+    std::multiset<blockMatchSet> matches;
+    EXPECT_TRUE(comparison::blockMatchSearch(blockLength, data1, data2, std::multiset<indexRange>(), std::multiset<indexRange>(), &matches));
+
+    blockIndexMap found;
+    for (const blockMatchSet& match : matches) {
+        EXPECT_EQ(blockLength, match.blockSize);
+
+        const unsigned int reference = match.data1_BlockStartIndices.front();
+        std::array<std::vector<unsigned int>, 2>& indices = found[std::vector<unsigned char>(data1.begin() + reference, data1.begin() + reference + blockLength)];
+        EXPECT_TRUE(indices[0].empty());    //one blockMatchSet for each block contents
+        indices[0].assign(match.data1_BlockStartIndices.begin(), match.data1_BlockStartIndices.end());
+        indices[1].assign(match.data2_BlockStartIndices.begin(), match.data2_BlockStartIndices.end());
+
+        //the zero blocks are one run in each file
+        if (0 == data1[reference] && std::equal(data1.begin() + reference + 1, data1.begin() + reference + blockLength, data1.begin() + reference)) {
+            EXPECT_EQ(1u, match.data1_BlockStartIndices.getRuns().size());
+            EXPECT_EQ(1u, match.data2_BlockStartIndices.getRuns().size());
+            EXPECT_EQ(300u - blockLength + 1, match.data1_BlockStartIndices.size());
+        }
+    }
+    EXPECT_TRUE(findEqualBlocks(blockLength, data1, data2) == found);
+}
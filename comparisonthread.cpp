@@ -5,12 +5,15 @@ comparisonThread::comparisonThread(QObject* parent/*= nullptr*/)
     m_mutex(),
     m_comparisonAlgorithmWriteLock(),
     m_comparisonAlgorithm(comparisonAlgorithm::largestBlock),
+    m_abort(false),
     m_dataSet1(nullptr),
     m_dataSet2(nullptr),
+    m_sequentialOptions(),
     m_results_largestBlock(nullptr),
     m_results_sequential(nullptr)
 {
-
+    //use all available cores for full target searches
+    m_sequentialOptions.workerThreadCount = static_cast<unsigned int>(qMax(1, QThread::idealThreadCount()));
 }
 
 comparisonThread::~comparisonThread()
@@ -25,6 +28,12 @@ bool comparisonThread::startThread(comparisonAlgorithm algorithm)
     QMutexLocker lock2(&m_comparisonAlgorithmWriteLock);
     m_comparisonAlgorithm = algorithm;
 
+    //(cleared here, not when the comparison algorithms start: an abort requested after this is never lost)
+    m_abort = false;
+    comparison::clearAbort();
+    offsetMetrics::clearAbort();
+    chunkTriage::clearAbort();
+
     start();
 
     return true;
@@ -34,6 +43,9 @@ void comparisonThread::abort()
 {
     QMutexLocker lock(&m_comparisonAlgorithmWriteLock);
 
+    m_abort = true;
+    chunkTriage::abort();
+
     switch (m_comparisonAlgorithm) {
 
         case comparisonAlgorithm::largestBlock:
@@ -95,14 +107,111 @@ void comparisonThread::run()
     const dataSet::DataReadLock& DRL2 = m_dataSet2->getReadLock();
     const std::vector<unsigned char> &dS2 = DRL2.getData();
 
+    //most compared files only differ in a small part: only the middles between their identical ends are compared
+    const commonEnds::lengths ends = commonEnds::find(dS1, dS2);
+
+    if (m_abort) {
+        setAbortedResults();
+        return;
+    }
+
+    ASSERT_LE_UINT_MAX(dS1.size());
+    ASSERT_LE_UINT_MAX(dS2.size());
+    const unsigned int size1 = static_cast<unsigned int>(dS1.size());
+    const unsigned int size2 = static_cast<unsigned int>(dS2.size());
+
+    if (!commonEnds::isWorthTrimming(ends, size1, size2)) {
+        compare(dS1, dS2);
+        return;
+    }
+
+    const indexRange middle1 = commonEnds::getMiddle(ends, size1);
+    const indexRange middle2 = commonEnds::getMiddle(ends, size2);
+
+    LOG.Info(QString("identical ends: %1 bytes at the start, %2 bytes at the end (comparing %3 and %4 bytes)")
+                    .arg(ends.prefix)
+                    .arg(ends.suffix)
+                    .arg(middle1.count())
+                    .arg(middle2.count()));
+
+    if (middle1.count() && middle2.count()) {
+        //(views of the middles: the data isn't copied, the read locks keep it in place)
+        compare(byteSpan(dS1, middle1), byteSpan(dS2, middle2));
+    }
+    else {
+        //nothing left to search: the results are just the ends
+        switch (m_comparisonAlgorithm) {
+            case comparisonAlgorithm::largestBlock: m_results_largestBlock.reset(new    comparison::results); break;
+            case comparisonAlgorithm::sequential:   m_results_sequential  .reset(new offsetMetrics::results); break;
+            default:
+                FAIL();
+        }
+    }
+
+    if (m_results_largestBlock && !m_results_largestBlock->aborted && !m_results_largestBlock->internalError) {
+        commonEnds::addEnds(*m_results_largestBlock, ends, size1, size2);
+    }
+    if (m_results_sequential && !m_results_sequential->aborted && !m_results_sequential->internalError) {
+        commonEnds::addEnds(*m_results_sequential, ends, size1, size2);
+    }
+}
+
+void comparisonThread::compare(const byteSpan& data1, const byteSpan& data2)
+{
+    switch (m_comparisonAlgorithm) {
+
+        case comparisonAlgorithm::largestBlock:
+            m_results_largestBlock = comparison::doCompare(data1, data2);
+            break;
+
+        case comparisonAlgorithm::sequential:
+            {
+                //a quick estimate of how similar the data is
+                // (the largest block comparison doesn't use it, so it's only made here)
+                const chunkTriage::results triage = chunkTriage::analyze(data1, data2);
+
+                if (triage.aborted || m_abort) {
+                    setAbortedResults();
+                    return;
+                }
+
+                LOG.Info(QString("chunk triage: %1% shared (%2 and %3 chunks)%4")
+                            .arg(100*triage.getSharedFraction(), 0, 'f', 1)
+                            .arg(triage.chunkCount1)
+                            .arg(triage.chunkCount2)
+                            .arg(triage.shifts.empty() ? QString() : QString(", main offset shift %1").arg(triage.shifts.front().diagonal)));
+
+                if (triage.isUnrelated()) {
+                    LOG.Info("chunk triage: the files look unrelated (few matches are likely to be found)");
+                }
+
+                //start searching at the offset shift that has the most shared chunks
+                // (if banded search is enabled in m_sequentialOptions)
+                offsetMetrics::options options = m_sequentialOptions;
+                if (!triage.shifts.empty()) {
+                    options.initialDiagonal = triage.shifts.front().diagonal;
+                }
+                m_results_sequential = offsetMetrics::doCompare(data1, data2, options);
+            }
+            break;
+
+        default:
+            FAIL();
+    }
+}
+
+void comparisonThread::setAbortedResults()
+{
     switch (m_comparisonAlgorithm) {
 
         case comparisonAlgorithm::largestBlock:
-            m_results_largestBlock = comparison::doCompare(dS1, dS2);
+            m_results_largestBlock.reset(new comparison::results);
+            m_results_largestBlock->aborted = true;
             break;
 
         case comparisonAlgorithm::sequential:
-            m_results_sequential = offsetMetrics::doCompare(dS1, dS2);
+            m_results_sequential.reset(new offsetMetrics::results);
+            m_results_sequential->aborted = true;
             break;
 
         default:
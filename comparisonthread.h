@@ -12,10 +12,14 @@
 #include <set>
 #include <memory>
 #include <utility>
+#include <atomic>
 
 #include "comparison.h"
 #include "offsetmetrics.h"
 #include "dataSet.h"
+#include "commonends.h"
+#include "chunktriage.h"
+#include "bytespan.h"
 
 class comparisonThread : public QThread
 {
@@ -50,6 +54,12 @@ protected:
 
 
 private:
+    //runs the selected comparison algorithm on data1 and data2, storing its results
+    void compare(const byteSpan& data1, const byteSpan& data2);
+
+    //stores empty results, marked as aborted, for the selected comparison algorithm
+    void setAbortedResults();
+
     QMutex m_mutex;
 
     //special lock so abort() can be called while the thread holds m_mutex
@@ -58,10 +68,16 @@ private:
     //comparison algorithm to use
     comparisonAlgorithm m_comparisonAlgorithm;
 
+    //abort flag (for the steps before and between the comparison algorithm's own steps)
+    std::atomic_bool m_abort;
+
     //inputs
     QSharedPointer<dataSet> m_dataSet1;
     QSharedPointer<dataSet> m_dataSet2;
 
+    //sequential comparison settings
+    offsetMetrics::options m_sequentialOptions;
+
     //output
     std::unique_ptr<   comparison::results> m_results_largestBlock;
     std::unique_ptr<offsetMetrics::results> m_results_sequential;
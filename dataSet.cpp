@@ -1,9 +1,19 @@
 #include "dataSet.h"
+#include "utilities.h"
+
+#include <chrono>
+#include <thread>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#endif
 
 dataSet::dataSet() :
     m_mutex(),
     m_data(),
     m_fileName(),
+    m_windows(),
+    m_windowDataStarts(),
     m_sourceType(dataSet::sourceType::none),
     m_loaded(false),
     m_dataReadLockCount(0)
@@ -50,49 +60,286 @@ const dataSet::sourceInfo dataSet::getSourceInfo() const
     return ret;
 }
 
-dataSet::loadFileResult dataSet::loadFile(const QString fileName)
+dataSet::loadFileResult dataSet::loadFile(const QString fileName, const std::vector<fileWindow>& windows /*= std::vector<fileWindow>()*/)
 {
-    QMutexLocker lock(&m_mutex);
-    if (0 < m_dataReadLockCount) {
-        //there is an active DataReadLock:
-        // the dataSet may be in use
-        return loadFileResult::ERROR_ActiveDataReadLock;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (0 < m_dataReadLockCount) {
+            //there is an active DataReadLock:
+            // the dataSet may be in use
+            return loadFileResult::ERROR_ActiveDataReadLock;
+        }
+
+        //reset the dataSet
+        m_data.clear();
+        m_fileName.clear();
+        m_windows.clear();
+        m_windowDataStarts.clear();
+        m_sourceType = dataSet::sourceType::none;
+        m_loaded = false;
+        m_dataReadLockCount = 0;
     }
 
-    //reset the dataSet
-    m_data.clear();
-    m_fileName.clear();
-    m_sourceType = dataSet::sourceType::none;
-    m_loaded = false;
-    m_dataReadLockCount = 0;
+    std::unique_ptr<std::vector<unsigned char>> data(new std::vector<unsigned char>());
+    std::vector<fileWindow> readWindows = windows;
+
+    loadFileResult res = readFile(fileName, readWindows, *data);
+    if (loadFileResult::SUCCESS != res) {
+        return res;
+    }
+
+    return loadFileData(fileName, std::move(data), readWindows);
+}
+
+/*static*/ dataSet::loadFileResult dataSet::readFile(const QString fileName,
+                                                     std::vector<fileWindow>& windows,
+                                                     std::vector<unsigned char>& data,
+                                                     abortFunction abortRequested /*= nullptr*/,
+                                                     progressFunction progress /*= nullptr*/)
+{
+    data.clear();
 
     if (fileName.isEmpty()) {
         return loadFileResult::ERROR_FileDoesNotExist;
     }
 
+    //unbuffered: QFile::read goes straight to the OS read, into data's storage (no intermediate buffer)
     QFile file(fileName);   //QFile will close itself when it is released
-    if (!file.open(QIODevice::ReadOnly)) {
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
         return loadFileResult::ERROR_FileDoesNotExist;
     }
 
-    QDataStream in(&file);
+    //compressed files are decompressed into data
+    {
+        unsigned char header[decompressor::HEADER_SIZE];
+        const qint64 headerSize = file.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (0 > headerSize || !file.seek(0)) {
+            return loadFileResult::ERROR_FileReadFailure;
+        }
+
+        const decompressor::format compression = decompressor::detectFormat(header, static_cast<std::size_t>(headerSize));
+        if (decompressor::format::none != compression) {
+            loadFileResult res = readCompressedFile(file, compression, data, abortRequested, progress);
+            if (loadFileResult::SUCCESS == res && !windows.empty()) {
+                //windows are offsets in the decompressed data: keep only their bytes
+                res = extractWindows(windows, data);
+            }
+            return res;
+        }
+    }
 
-    //get filesize, constrain to int for QDataStream::readRawData
-    qint64 s = file.size();
-    if (s > INT_MAX) {
+    //the regions to read (the whole file, or its parts in windows), with their sizes constrained to int (data indices are unsigned int)
+    const qint64 s = file.size();
+    if (s < 0) {
         return loadFileResult::ERROR_FileReadFailure;
     }
-    int fileSize = static_cast<int>(s);
+    const unsigned long long fileSize = static_cast<unsigned long long>(s);
 
-    QScopedArrayPointer<char> rawFile(new char[fileSize]);
-    if (-1 == in.readRawData(rawFile.data(), fileSize))
-    {
+    std::vector<fileWindow> regions = windows;
+    if (regions.empty()) {
+        regions.push_back(fileWindow{0, fileSize});
+    }
+
+    unsigned long long totalSize;
+    if (!clipWindows(regions, fileSize, totalSize)) {
         return loadFileResult::ERROR_FileReadFailure;
     }
 
-    m_data.resize(static_cast<unsigned long>(fileSize));
+    //allocate once, but only grow one chunk at a time, right before reading into it: resize still zero-fills each chunk,
+    // but the chunk is small enough to still be in the cache when the read overwrites it (instead of zero-filling the
+    // whole file up front, and then bringing each part back from memory to read into it)
+    data.reserve(totalSize);
+
+    unsigned long long bytesRead = 0;
+    for (const fileWindow& region : regions) {
+
+        if (!file.seek(static_cast<qint64>(region.offset))) {
+            std::vector<unsigned char>().swap(data);
+            return loadFileResult::ERROR_FileReadFailure;
+        }
+
+#if defined(Q_OS_UNIX) && defined(POSIX_FADV_SEQUENTIAL)
+        //each region is read once from start to end: let the OS read ahead aggressively
+        posix_fadvise(file.handle(), static_cast<off_t>(region.offset), static_cast<off_t>(region.length), POSIX_FADV_SEQUENTIAL);
+#endif
+
+        const unsigned long long regionEnd = bytesRead + region.length;
+        while (bytesRead < regionEnd) {
+
+            if (abortRequested && abortRequested()) {
+                std::vector<unsigned char>().swap(data);    //release the memory too
+                return loadFileResult::ERROR_Aborted;
+            }
+
+            const unsigned long long chunkSize = std::min<unsigned long long>(READ_CHUNK_SIZE, regionEnd - bytesRead);
+            data.resize(bytesRead + chunkSize);
+
+            const qint64 chunkRead = file.read(reinterpret_cast<char*>(data.data() + bytesRead), static_cast<qint64>(chunkSize));
+            if (0 >= chunkRead) {
+                //read error, or the file is shorter than its reported size
+                std::vector<unsigned char>().swap(data);
+                return loadFileResult::ERROR_FileReadFailure;
+            }
+            bytesRead += static_cast<unsigned long long>(chunkRead);
+            data.resize(bytesRead);     //a short read leaves the rest of the chunk for the next read
+
+            if (progress) {
+                progress(bytesRead, totalSize);
+            }
+        }
+    }
+
+    if (!windows.empty()) {
+        windows = regions;
+    }
 
-    std::copy(rawFile.data(), rawFile.data()+fileSize, m_data.begin());
+    return loadFileResult::SUCCESS;
+}
+
+/*static*/ bool dataSet::clipWindows(std::vector<fileWindow>& windows, const unsigned long long fileSize, unsigned long long& totalSize)
+{
+    std::vector<fileWindow> clipped;
+    totalSize = 0;
+
+    for (const fileWindow& w : windows) {
+        if (w.offset >= fileSize) {
+            continue;   //entirely past the end of the file
+        }
+
+        const unsigned long long length = std::min(w.length, fileSize - w.offset);
+        if (0 == length) {
+            continue;
+        }
+
+        clipped.push_back(fileWindow{w.offset, length});
+        totalSize += length;
+
+        if (totalSize > INT_MAX) {
+            return false;
+        }
+    }
+
+    windows.swap(clipped);
+    return true;
+}
+
+/*static*/ dataSet::loadFileResult dataSet::extractWindows(std::vector<fileWindow>& windows, std::vector<unsigned char>& data)
+{
+    unsigned long long totalSize;
+    if (!clipWindows(windows, data.size(), totalSize)) {
+        std::vector<unsigned char>().swap(data);
+        return loadFileResult::ERROR_FileReadFailure;
+    }
+
+    std::vector<unsigned char> windowed;
+    windowed.reserve(totalSize);
+    for (const fileWindow& w : windows) {
+        windowed.insert(windowed.end(), data.begin() + static_cast<std::ptrdiff_t>(w.offset),
+                                        data.begin() + static_cast<std::ptrdiff_t>(w.offset + w.length));
+    }
+    data.swap(windowed);
+
+    return loadFileResult::SUCCESS;
+}
+
+/*static*/ dataSet::loadFileResult dataSet::readCompressedFile(QFile& file,
+                                                               const decompressor::format compression,
+                                                               std::vector<unsigned char>& data,
+                                                               abortFunction abortRequested,
+                                                               progressFunction progress)
+{
+    if (!decompressor::isSupported(compression)) {
+        return loadFileResult::ERROR_UnsupportedCompression;
+    }
+
+    const qint64 s = file.size();
+    const unsigned long long fileSize = static_cast<unsigned long long>(qMax(static_cast<qint64>(0), s));
+
+#if defined(Q_OS_UNIX) && defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(file.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    //file is read on the decompressor's reader thread (this thread only waits in decompress meanwhile)
+    const decompressor::result res =
+            decompressor::decompress(compression,
+                                     [&file](unsigned char* buffer, unsigned long long size) -> long long {
+                                         return file.read(reinterpret_cast<char*>(buffer), static_cast<qint64>(size));
+                                     },
+                                     data,
+                                     INT_MAX,   //data indices are unsigned int (and file sizes are constrained to int)
+                                     abortRequested,
+                                     [&progress, fileSize](unsigned long long compressedBytesRead) {
+                                         if (progress) {
+                                             progress(qMin(compressedBytesRead, fileSize), fileSize);
+                                         }
+                                     });
+
+    switch (res) {
+        case decompressor::result::SUCCESS:
+            break;
+        case decompressor::result::ERROR_Aborted:
+            return loadFileResult::ERROR_Aborted;
+        case decompressor::result::ERROR_Unsupported:
+            return loadFileResult::ERROR_UnsupportedCompression;
+        case decompressor::result::ERROR_Corrupt:
+        case decompressor::result::ERROR_ReadFailure:
+        case decompressor::result::ERROR_TooLarge:
+            return loadFileResult::ERROR_FileReadFailure;
+        default:
+            FAIL();
+            return loadFileResult::ERROR_FileReadFailure;
+    }
+
+    //report decompression throughput
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const double MB = 1024.0*1024.0;
+    LOG.Info(QString("Decompressed %1 (%2): %3 MB -> %4 MB in %5 s (%6 MB/s)")
+                .arg(file.fileName())
+                .arg(decompressor::getName(compression))
+                .arg(fileSize/MB, 0, 'f', 1)
+                .arg(data.size()/MB, 0, 'f', 1)
+                .arg(seconds, 0, 'f', 2)
+                .arg(seconds > 0 ? data.size()/MB/seconds : 0.0, 0, 'f', 1));
+
+    return loadFileResult::SUCCESS;
+}
+
+dataSet::loadFileResult dataSet::loadFileData(const QString fileName,
+                                              std::unique_ptr<std::vector<unsigned char>> data,
+                                              const std::vector<fileWindow>& windows /*= std::vector<fileWindow>()*/)
+{
+    QMutexLocker lock(&m_mutex);
+    if (0 < m_dataReadLockCount) {
+        //there is an active DataReadLock:
+        // the dataSet may be in use
+        return loadFileResult::ERROR_ActiveDataReadLock;
+    }
+
+    //reset the dataSet
+    m_data.clear();
+    m_fileName.clear();
+    m_windows.clear();
+    m_windowDataStarts.clear();
+    m_sourceType = dataSet::sourceType::none;
+    m_loaded = false;
+    m_dataReadLockCount = 0;
+
+    //swap the read data into m_data (no copy)
+    if (nullptr != data) {
+        m_data.swap(*data);
+    }
+
+    //the data index where each window's bytes start
+    m_windows = windows;
+    unsigned long long dataStart = 0;
+    for (const fileWindow& w : m_windows) {
+        ASSERT_LE_UINT_MAX(dataStart);
+        m_windowDataStarts.push_back(static_cast<unsigned int>(dataStart));
+        dataStart += w.length;
+    }
+    ASSERT(m_windows.empty() || dataStart == m_data.size());
 
     m_sourceType = dataSet::sourceType::file;
     m_loaded = true;
@@ -101,6 +348,58 @@ dataSet::loadFileResult dataSet::loadFile(const QString fileName)
     return loadFileResult::SUCCESS;
 }
 
+unsigned long long dataSet::getFileOffset(const unsigned int index) const
+{
+    QMutexLocker lock(&m_mutex);
+
+    if (m_windowDataStarts.empty()) {
+        return index;   //the whole file is loaded
+    }
+
+    //the last window starting at or before index (indices past the last window continue its offsets)
+    auto next = std::upper_bound(m_windowDataStarts.begin(), m_windowDataStarts.end(), index);
+    const std::size_t w = (m_windowDataStarts.begin() == next) ? 0 : static_cast<std::size_t>(next - m_windowDataStarts.begin()) - 1;
+
+    return m_windows[w].offset + (index - m_windowDataStarts[w]);
+}
+
+unsigned long long dataSet::getLastFileOffset() const
+{
+    const unsigned int size = getSize();
+    return size ? getFileOffset(size - 1) : 0;
+}
+
+const std::vector<dataSet::fileWindow> dataSet::getWindows() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_windows;
+}
+
+/*static*/ bool dataSet::parseWindows(const QString text, std::vector<fileWindow>& windows)
+{
+    //"offset:length" pairs separated by commas (numbers in decimal, 0x hex, or 0 octal)
+    windows.clear();
+
+    for (const QString& item : text.split(',', QString::SkipEmptyParts)) {
+        const QStringList parts = item.split(':');
+        if (2 != parts.size()) {
+            return false;
+        }
+
+        bool offsetOK = false;
+        bool lengthOK = false;
+        const unsigned long long offset = parts.at(0).trimmed().toULongLong(&offsetOK, 0);
+        const unsigned long long length = parts.at(1).trimmed().toULongLong(&lengthOK, 0);
+        if (!offsetOK || !lengthOK || 0 == length) {
+            return false;
+        }
+
+        windows.push_back(fileWindow{offset, length});
+    }
+
+    return !windows.empty();
+}
+
 dataSet::loadFromMemoryResult dataSet::loadFromMemory(std::unique_ptr<std::vector<unsigned char>> data)
 {
     QMutexLocker lock(&m_mutex);
@@ -113,6 +412,8 @@ dataSet::loadFromMemoryResult dataSet::loadFromMemory(std::unique_ptr<std::vecto
     //reset the dataSet
     m_data.clear();
     m_fileName.clear();
+    m_windows.clear();
+    m_windowDataStarts.clear();
     m_sourceType = dataSet::sourceType::none;
     m_loaded = false;
     m_dataReadLockCount = 0;
@@ -139,44 +440,29 @@ dataSet::loadFromMemoryResult dataSet::loadFromMemory(std::unique_ptr<std::vecto
         return compareResult::ERROR_SizeMismatch;
     }
 
-    std::vector<unsigned char>::const_iterator it_dataset1 = dataSet1.m_data.begin();
-    std::vector<unsigned char>::const_iterator it_dataset2 = dataSet2.m_data.begin();
-    bool inDiffSection = false;   //true when byteindex is in a section of byte differences
-    unsigned int byteindex;
+    ASSERT_LE_UINT_MAX(dataSet1.m_data.size());
+    const unsigned int size = static_cast<unsigned int>(dataSet1.m_data.size());
 
-    while (it_dataset1 != dataSet1.m_data.end() && it_dataset2 != dataSet2.m_data.end()) {
-        if (*it_dataset1 != *it_dataset2){
+    //runs of differing bytes, found 32 bytes at a time (on several threads for large files)
+    const unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    const std::vector<indexRange> runs = utilities::findDifferences(dataSet1.m_data.data(), dataSet2.m_data.data(), size, threadCount);
 
-            {
-                //get the byte index (from iterator difference)
-                long val = it_dataset1 - dataSet1.m_data.begin();
-                ASSERT_NOT_NEGATIVE(val);
-                ASSERT(val <= UINT_MAX);
-                byteindex = static_cast<unsigned int>(val);
-            }
+    ASSERT_LE_INT_MAX(runs.size());
+    diffs.reserve(diffs.size() + static_cast<int>(runs.size()));
+    for (const indexRange& run : runs) {
+        diffs.push_back(run);
+    }
 
-            if (inDiffSection){
-                Q_ASSERT(0 != diffs.size());
-                Q_ASSERT(diffs.last().end < UINT_MAX);
-                diffs.last().end++;   //add one to the size of the current diff indexRange
-            } else {
-                Q_ASSERT(byteindex < UINT_MAX);
-                diffs.push_back(indexRange(byteindex, byteindex + 1));  //add a new diff indexRange of size 1 at this index
-                inDiffSection = true;
+    //every differing byte (only when detailed debug messages are enabled: there may be millions)
+    if (Log::isDetailedDebugEnabled()) {
+        for (const indexRange& run : runs) {
+            for (unsigned int byteindex = run.start; byteindex < run.end; ++byteindex) {
+                LOG.DetailedDebug(QString("\t%1: %2, %3")
+                                    .arg(byteindex)
+                                    .arg(dataSet1.m_data[byteindex])
+                                    .arg(dataSet2.m_data[byteindex]));
             }
-
-            QString str;
-            QTextStream strStr(&str);
-            strStr << "\t" << byteindex << ": " << int(*it_dataset1) << ", " << int(*it_dataset2);
-            LOG.Debug(str);
-
-
-        } else {
-            inDiffSection = false;
         }
-
-        it_dataset1++;
-        it_dataset2++;
     }
 
     return compareResult::SUCCESS;
@@ -9,11 +9,13 @@
 #include <QMutex>
 #include <vector>
 #include <memory>
+#include <functional>
 
 
 #include "log.h"
 #include "indexrange.h"
 #include "defensivecoding.h"
+#include "decompressor.h"
 
 /*
     Represents the contents of a loaded file as a set of bytes
@@ -26,14 +28,48 @@ class dataSet : public QObject
 public:
     dataSet();
 
+    //a region of a file: length bytes starting at offset
+    class fileWindow {
+    public:
+        unsigned long long offset;
+        unsigned long long length;
+    };
+
     //load a file
+    // windows: only load these regions of the file, one after another (empty: the whole file)
     enum class loadFileResult {
         SUCCESS,
         ERROR_ActiveDataReadLock,
         ERROR_FileDoesNotExist,
-        ERROR_FileReadFailure
+        ERROR_FileReadFailure,
+        ERROR_Aborted,
+        ERROR_UnsupportedCompression    //the file is compressed in a format this build can't decompress
     };
-    loadFileResult loadFile(const QString fileName);
+    loadFileResult loadFile(const QString fileName, const std::vector<fileWindow>& windows = std::vector<fileWindow>());
+
+    //reads a file into data in chunks, without using any dataSet
+    // (so a file can be read on a worker thread, then published to a dataSet with loadFileData)
+    // compressed files (see decompressor) are decompressed into data; progress is then based on the compressed bytes read
+    // windows: the regions to read (empty: the whole file); on success, set to the regions that were read (clipped to the file)
+    // progress (if set) is called after each chunk; reading stops with ERROR_Aborted when abortRequested (if set) returns true
+    typedef std::function<void(unsigned long long bytesRead, unsigned long long fileSize)> progressFunction;
+    typedef std::function<bool()> abortFunction;
+    static loadFileResult readFile(const QString fileName,
+                                   std::vector<fileWindow>& windows,
+                                   std::vector<unsigned char>& data,
+                                   abortFunction abortRequested = nullptr,
+                                   progressFunction progress = nullptr);
+
+    //replaces the dataSet's contents with data read from fileName (by readFile, with windows as it returned them)
+    loadFileResult loadFileData(const QString fileName,
+                                std::unique_ptr<std::vector<unsigned char>> data,
+                                const std::vector<fileWindow>& windows = std::vector<fileWindow>());
+
+    static const unsigned int READ_CHUNK_SIZE = 1 << 20;    //bytes per read when reading a file (small enough to stay in the cache)
+
+    //parses windows from text: "offset:length" pairs separated by commas (e.g. "0x4000000:0x4000000, 0:512")
+    // returns false if text isn't valid (or has no windows)
+    static bool parseWindows(const QString text, std::vector<fileWindow>& windows);
 
     //load a data set from memory
     enum class loadFromMemoryResult {
@@ -105,10 +141,33 @@ public:
     bool isLoaded() const;
     const sourceInfo getSourceInfo() const;
 
+    //the loaded file windows (empty if the whole file, or no file, is loaded)
+    const std::vector<fileWindow> getWindows() const;
+
+    //the offset in the loaded file of the byte at index (index itself if the whole file is loaded)
+    unsigned long long getFileOffset(const unsigned int index) const;
+    unsigned long long getLastFileOffset() const;   //of the last loaded byte
+
 private:
+    //readFile for compressed files (file is open, at its start)
+    static loadFileResult readCompressedFile(QFile& file,
+                                             const decompressor::format compression,
+                                             std::vector<unsigned char>& data,
+                                             abortFunction abortRequested,
+                                             progressFunction progress);
+
+    //removes the parts of windows past fileSize (and empty windows); totalSize: their total length
+    // returns false if the total is too large to load
+    static bool clipWindows(std::vector<fileWindow>& windows, const unsigned long long fileSize, unsigned long long& totalSize);
+
+    //replaces data with the bytes of its windows (clipped to data)
+    static loadFileResult extractWindows(std::vector<fileWindow>& windows, std::vector<unsigned char>& data);
+
     mutable QMutex m_mutex;
     std::vector<unsigned char> m_data;
     QString m_fileName;
+    std::vector<fileWindow> m_windows;              //the loaded regions of m_fileName (empty: all of it)
+    std::vector<unsigned int> m_windowDataStarts;   //the m_data index of the start of each window
     sourceType m_sourceType;
     bool m_loaded;
 
@@ -36,9 +36,14 @@ dataSetView::dataSetView(QSharedPointer<dataSet>& theDataSet)
       byteGridColumn_UpTo_N(8),
       byteGridScrollingMode(ByteGridScrollingMode::FixedRows),
       m_dataSet(theDataSet),
-      m_highlightSets(),
+      m_highlights(),
+      m_highlightStyles(),
+      m_highlightStyleIndices(),
+      m_byteColorStyles(),
       m_subset(),
-      m_bytesPerRow(0)
+      m_bytesPerRow(0),
+      m_gridGeometry(),
+      m_renderedRows(INITIAL_RENDERED_ROW_CAPACITY)
 {
 }
 
@@ -61,7 +66,47 @@ void dataSetView::setSubsetStart(unsigned int start)
 
 void dataSetView::addHighlightSet(const highlightSet& hSet)
 {
-    m_highlightSets.append(hSet);
+    if (!hSet.m_ranges) {
+        return;
+    }
+
+    m_renderedRows.clear();
+
+    const unsigned int style = getHighlightStyleIndex(hSet);
+
+    for (const indexRange& range : *hSet.m_ranges) {
+        m_highlights.add(range, style);
+    }
+}
+
+unsigned int dataSetView::getHighlightStyleIndex(const highlightSet& hSet)
+{
+    return getHighlightStyleIndex(highlightStyle{   hSet.m_applyForeground,
+                                                    hSet.m_applyBackground,
+                                                    hSet.m_foreground.rgb(),
+                                                    hSet.m_background.rgb() });
+}
+
+unsigned int dataSetView::getHighlightStyleIndex(const highlightStyle& style)
+{
+    //colors that aren't applied don't distinguish styles
+    const QRgb foreground = style.applyForeground ? style.foreground : 0;
+    const QRgb background = style.applyBackground ? style.background : 0;
+
+    const auto key = std::make_tuple(style.applyForeground, style.applyBackground, foreground, background);
+
+    auto found = m_highlightStyleIndices.find(key);
+    if (found != m_highlightStyleIndices.end()) {
+        return found->second;
+    }
+
+    ASSERT_LE_UINT_MAX(m_highlightStyles.size());
+    const unsigned int index = static_cast<unsigned int>(m_highlightStyles.size());
+
+    m_highlightStyles.push_back(highlightStyle{style.applyForeground, style.applyBackground, foreground, background});
+    m_highlightStyleIndices[key] = index;
+
+    return index;
 }
 
 unsigned int dataSetView::getBytesPerRow()
@@ -69,35 +114,121 @@ unsigned int dataSetView::getBytesPerRow()
     return m_bytesPerRow;
 }
 
-void dataSetView::updateByteGridDimensions(QTextEdit* textEdit)
+unsigned int dataSetView::getAddressLength() const
 {
-    //note: this code only works for MONOSPACE FONTS
+    QSharedPointer<dataSet> theDataSet = m_dataSet.lock();
+    const unsigned long long lastAddress = theDataSet ? theDataSet->getLastFileOffset() : 0;
+
+    return 2 + hexFormat::getAddressDigitCount(lastAddress);
+}
 
+QString dataSetView::getVisibleRowsText() const
+{
+    QSharedPointer<dataSet> theDataSet = m_dataSet.lock();
+    if (!theDataSet || 0 == m_bytesPerRow) {
+        return QString();
+    }
+
+    const dataSet::DataReadLock& DRL = theDataSet->getReadLock();
+    const std::vector<unsigned char>& theData = DRL.getData();
+
+    ASSERT_LE_UINT_MAX(theData.size());
+    const unsigned int dataSize = static_cast<unsigned int>(theData.size());
+    const indexRange visible = m_subset.getIntersection(indexRange(0, dataSize));
+    if (0 == visible.count()) {
+        return QString();
+    }
+
+    //addresses as in the address column
+    const unsigned int digitCount = hexFormat::getAddressDigitCount(theDataSet->getLastFileOffset());
+
+    //all rows are formatted into one buffer (each followed by a newline), then converted to a QString once
+    const unsigned int rowCount = (visible.count() - 1)/m_bytesPerRow + 1;
+    std::vector<char> text(static_cast<size_t>(hexFormat::getRowLength(m_bytesPerRow, digitCount) + 1) * rowCount);
+    char* pos = text.data();
+
+    for (unsigned int row = 0; row < rowCount; ++row) {
+        const indexRange rowRange = getRowRange(visible.start + row*m_bytesPerRow, visible.end);
+
+        pos += hexFormat::formatRow(theData, rowRange, m_bytesPerRow, theDataSet->getFileOffset(rowRange.start), digitCount, pos);
+        *pos++ = '\n';
+    }
+
+    ASSERT_LE_INT_MAX(pos - text.data());
+    return QString::fromLatin1(text.data(), static_cast<int>(pos - text.data()));
+}
+
+void dataSetView::updateByteGridDimensions(hexField* byteGrid)
+{
     //no-op values: only update at the end if everything goes well
     m_bytesPerRow = 0;
     m_subset.end = m_subset.start;  //set m_subset size to 0 without moving start
 
 
-    //calculate the pixel size of the draw area in the QTextEdit that is available
-    //  to draw the byte grid:
-    //  The drawable area is textEdit->viewport().
-    //  Text starts a bit inside this area; we can see where by moving the cursor
-    //  to the start of the control and measuring the cursor location.
-    textEdit->moveCursor(QTextCursor::Start);
-    QPoint topLeftCornerOfFirstChar = textEdit->cursorRect().topLeft();
-    //
-    int areaWidth_px  = textEdit->viewport()->width()  - topLeftCornerOfFirstChar.x();
-    int areaHeight_px = textEdit->viewport()->height() - topLeftCornerOfFirstChar.y();
-    //
+    //this is called continuously while a window is resized:
+    // the layout is only recalculated when the draw area size, font or column mode has changed
+    gridGeometry geometry = gridGeometry();
+    geometry.drawAreaSize        = byteGrid->getDrawArea().size();
+    geometry.byteCellSize        = getByteCellSize(byteGrid->font());
+    geometry.columnMode          = byteGridColumnMode;
+    geometry.largestMultipleOf_N = byteGridColumn_LargestMultipleOf_N;
+    geometry.upTo_N              = byteGridColumn_UpTo_N;
 
+    if (!geometry.hasSameInputs(m_gridGeometry)) {
+        calculateGridGeometry(geometry);
+        m_gridGeometry = geometry;
+
+        //room for the displayed page, the pages above and below it, and one more page of recently displayed rows
+        if (m_gridGeometry.rowCount) {
+            ASSERT_LE_UINT_MAX(4ULL*m_gridGeometry.rowCount);
+            m_renderedRows.setCapacity(4*m_gridGeometry.rowCount);
+        }
+    }
 
-    QFontMetrics qfm(textEdit->font());
-    int byteWidth_px = qfm.width("00 ");    //width of one displayed byte value in pixels
+
+    //calculate total visible byte count
+    const unsigned long long byteCount = static_cast<unsigned long long>(m_gridGeometry.rowCount) * m_gridGeometry.bytesPerRow;
+
+    if (0 >= byteCount) {return;}
+    ASSERT_LE_UINT_MAX(byteCount);
+
+
+    m_bytesPerRow = m_gridGeometry.bytesPerRow;
+    ASSERT(noSumOverflow(m_subset.start,static_cast<unsigned int>(byteCount)));
+    m_subset.end = m_subset.start + static_cast<unsigned int>(byteCount);
+
+}
+
+bool dataSetView::gridGeometry::hasSameInputs(const gridGeometry& g) const
+{
+    return     drawAreaSize        == g.drawAreaSize
+            && byteCellSize        == g.byteCellSize
+            && columnMode          == g.columnMode
+            && largestMultipleOf_N == g.largestMultipleOf_N
+            && upTo_N              == g.upTo_N;
+}
+
+/*static*/ void dataSetView::calculateGridGeometry(gridGeometry& geometry)
+{
+    //note: this code only works for MONOSPACE FONTS
+
+    //no-op values: only update at the end if everything goes well
+    geometry.bytesPerRow = 0;
+    geometry.rowCount = 0;
+
+
+    //the pixel size of the area in the hexField that is available to draw the byte grid
+    int areaWidth_px  = geometry.drawAreaSize.width();
+    int areaHeight_px = geometry.drawAreaSize.height();
+
+    int byteWidth_px = geometry.byteCellSize.width();    //width of one displayed byte value in pixels
 
     if (0 >= byteWidth_px) {return;}
+    if (0 >= areaWidth_px) {return;}
 
 
     //calculate visible bytes per row
+    // (bytes are drawn at exact multiples of byteWidth_px, so a full row is always rowBytes*byteWidth_px wide)
     unsigned int rowBytes;
     {
         int val = areaWidth_px/byteWidth_px;
@@ -105,39 +236,18 @@ void dataSetView::updateByteGridDimensions(QTextEdit* textEdit)
         rowBytes = static_cast<unsigned int>(val);
     }
 
-    //Decrease bytes per row if it won't fit in the draw area:
-    //  this can happen because the single byte string width is slightly underreported
-    //  (QFontMetrics::width returns int, so it may be truncating fractions)
-    //
-    //assemble a test string as long as a full row of bytes (again, assuming MONOSPACE FONTS)
-    QString fullRow;
-    for (unsigned int i = 0; i < rowBytes; ++i) {
-        fullRow += "00 ";
-    }
-    //
-    //get the pixel width of the full row string
-    int rowWidth_px = qfm.width(fullRow);
-    //reduce the row count by one byte until it fits
-    while ((rowWidth_px >= areaWidth_px)
-        && (rowBytes > 0))
-    {
-        rowWidth_px -= byteWidth_px;
-        --rowBytes;
-    }
-    //
-
     if (0 >= rowBytes) {return;}
 
     //reduce bytes per row, if necessary, to implement ByteGridColumnMode
-    switch (byteGridColumnMode)
+    switch (geometry.columnMode)
     {
         case ByteGridColumnMode::Fill:
             //already filled to the limit, do nothing
             break;
 
         case ByteGridColumnMode::LargestMultipleOfN:
-            if(byteGridColumn_LargestMultipleOf_N){
-                rowBytes -= rowBytes%byteGridColumn_LargestMultipleOf_N;
+            if(geometry.largestMultipleOf_N){
+                rowBytes -= rowBytes%geometry.largestMultipleOf_N;
             } else {
                 LOG.Error("invalid byteGridColumn_LargestMultipleOf_N value");
             }
@@ -149,11 +259,10 @@ void dataSetView::updateByteGridDimensions(QTextEdit* textEdit)
             break;
 
         case ByteGridColumnMode::UpToN:
-            if(rowBytes > byteGridColumn_UpTo_N) {
-                rowBytes = byteGridColumn_UpTo_N;
+            if(rowBytes > geometry.upTo_N) {
+                rowBytes = geometry.upTo_N;
             }
             break;
-
         case ByteGridColumnMode::LargestPowerOf2:
             {
                 unsigned int val = 1;
@@ -187,46 +296,29 @@ void dataSetView::updateByteGridDimensions(QTextEdit* textEdit)
     if (0 >= rowBytes) {return;}
 
 
-    //calculate total visible byte count
+    //calculate visible row count
 
-    int rowHeight_px;  //height of one displayed byte row in pixels
-    //
-    // rowHeight_px could be calculated with
-    //      QFontMetrics::lineSpacing()
-    //      QFontMetrics::height()
-    // or   QFontMetrics::boundingRect(QString).height()
-    //
-    // (These all return ints)
-    // None of these values reliably predict the pixel height of a number of rows through simple multiplication.
-    // I chose QFontMetrics::boundingRect(QString).height() because it is typically >= the others,
-    //  so error is likely to leave a row of screen space empty, instead of partially occluding the bottom row.
-    //
-    QRect qr = qfm.boundingRect("00_");
-    rowHeight_px = qr.height();
-    //
+    int rowHeight_px = geometry.byteCellSize.height();  //height of one displayed byte row in pixels
 
     if (0 >= rowHeight_px) {return;}
     if (0 >= areaHeight_px) {return;}
 
     int rowCount = areaHeight_px/rowHeight_px;
     ASSERT_NOT_NEGATIVE(rowCount);
-    unsigned int byteCount = static_cast<unsigned int>(rowCount) * rowBytes;
-
-    if (0 >= byteCount) {return;}
 
+    if (0 >= rowCount) {return;}
 
-    m_bytesPerRow = rowBytes;
-    ASSERT(noSumOverflow(m_subset.start,byteCount));
-    m_subset.end = m_subset.start + byteCount;
 
+    geometry.bytesPerRow = rowBytes;
+    geometry.rowCount = static_cast<unsigned int>(rowCount);
 }
 
-bool dataSetView::printByteGrid(QTextEdit* textEdit, QTextEdit* addressColumn)
+bool dataSetView::printByteGrid(hexField* byteGrid, hexField* addressColumn)
 {
-    //clear any existing text
-    //  (at the start of the function, so errors will show blank controls rather than stale data)
-    textEdit->clear();
-    addressColumn->clear();
+    //clear the hexFields first
+    //  (so errors will show blank controls rather than stale data)
+    byteGrid->setDataSetView(nullptr);
+    addressColumn->setDataSetView(nullptr);
 
     QSharedPointer<dataSet> theDataSet = m_dataSet.lock();
 
@@ -240,113 +332,325 @@ bool dataSetView::printByteGrid(QTextEdit* textEdit, QTextEdit* addressColumn)
         return false;
     }
 
+    //the hexFields draw the visible rows when they are repainted
+    byteGrid->setDisplayMode(hexField::DisplayMode::ByteGrid);
+    byteGrid->setDataSetView(this);
+
+    addressColumn->setDisplayMode(hexField::DisplayMode::AddressColumn);
+    addressColumn->setDataSetView(this);
+
+    //page up/down will probably display these next
+    prefetchAdjacentPages();
+
+    return true;
+}
+
+void dataSetView::paintByteGrid(QPainter& painter, const QRect& drawArea, const QRect& updateRect) const
+{
+    QSharedPointer<dataSet> theDataSet = m_dataSet.lock();
+
+    //ensure that weak pointer lock succeeded
+    if ( !theDataSet ){
+        return;
+    }
+
+    //skip no-print situations
+    if (0 == m_bytesPerRow || 0 == m_subset.count()) {
+        return;
+    }
 
-    QString displayText = "";   //text for the main data display area
-    QString addressText = "";   //text for the address column area
+    const QSize byteCellSize = getByteCellSize(painter.font());
+    if (byteCellSize.isEmpty()) {
+        return;
+    }
 
     //get the data to be displayed
     const dataSet::DataReadLock& DRL = theDataSet->getReadLock();
     const std::vector<unsigned char>& theData = DRL.getData();
 
-    unsigned int bytesPrinted = 0;
-    ASSERT_LE_INT_MAX(m_subset.end);  //ensure static_cast<int>(i) in loop is safe
-    for (unsigned int i = m_subset.start; i < m_subset.end; i++) {
+    ASSERT_LE_UINT_MAX(theData.size());
+    const indexRange rows = getRowsToPaint(drawArea, updateRect, byteCellSize.height(), static_cast<unsigned int>(theData.size()));
+    if (0 == rows.count()) {
+        return;
+    }
+
+    //the byte indices to draw
+    // (the data may end before the subset does: this can happen if the file is smaller than the display area's capacity)
+    const indexRange paintRange =
+            m_subset.getIntersection(indexRange(0, static_cast<unsigned int>(theData.size())))
+                    .getIntersection(indexRange(m_subset.start + rows.start*m_bytesPerRow,
+                                                m_subset.start + rows.end  *m_bytesPerRow));
+    if (0 == paintRange.count()) {
+        return;
+    }
 
-        if (static_cast<unsigned long>(i) >= theData.size()) {
-            //break if we've exhausted the data
-            //(this can happen if the file is smaller than the display area's capacity)
-            break;
-        }
+    //the on-screen rectangle of the bytes in [start, end) (they must be in the same row)
+    auto getCellsRect = [&](const unsigned int start, const unsigned int end) -> QRect {
+        const unsigned int index = start - m_subset.start;   //index in currently displayed byte range
+        ASSERT_LE_INT_MAX(index/m_bytesPerRow);
+        ASSERT_LE_INT_MAX(index%m_bytesPerRow);
+        ASSERT_LE_INT_MAX(end - start);
+        return QRect(drawArea.left() + static_cast<int>(index%m_bytesPerRow)*byteCellSize.width(),
+                     drawArea.top()  + static_cast<int>(index/m_bytesPerRow)*byteCellSize.height(),
+                     static_cast<int>(end - start)*byteCellSize.width(),
+                     byteCellSize.height());
+    };
 
-        if (0 == bytesPrinted%m_bytesPerRow) {
+    //one pass over each painted row's bytes, in runs with the same background:
+    // fill the run's background, then draw its byte values from the prepared glyphs (no per-byte text layout)
+    // (the rows' highlight styles are usually rendered already: see prefetchAdjacentPages)
+    const std::vector<QStaticText>& hexGlyphs = getHexGlyphs();
+    const QColor defaultTextColor = QColor::fromRgb(0,0,0);
 
-            if (i != m_subset.start) {  //add newlines (unless starting the first row)
-                displayText += "\n";
-                addressText += "\n";
+    unsigned int penStyle = 0;
+    painter.setPen(defaultTextColor);
+
+    for (unsigned int rowStart = paintRange.start; rowStart < paintRange.end; rowStart += m_bytesPerRow) {
+
+        const indexRange rowRange = getRowRange(rowStart, static_cast<unsigned int>(theData.size()));
+        const std::shared_ptr<const renderedRowCache::row> rendered = getRenderedRow(rowRange);
+
+        unsigned int runStart = rowRange.start;
+        while (runStart < rowRange.end) {
+
+            const unsigned int backgroundStyle = rendered->backgroundStyles[runStart - rowRange.start];
+
+            unsigned int runEnd = runStart + 1;
+            while (runEnd < rowRange.end && rendered->backgroundStyles[runEnd - rowRange.start] == backgroundStyle) {
+                ++runEnd;
             }
 
-            //list byte address for the start of this row
-            //                              length 8, base 16, padded with '0's
-            addressText += QString("0x%1  ").arg(i,8,16,QChar('0'));
-        }
+            if (backgroundStyle) {
+                painter.fillRect(getCellsRect(runStart, runEnd), QColor(m_highlightStyles[backgroundStyle - 1].background));
+            }
 
-        //add the next byte
-        if (!(theData[static_cast<unsigned long>(i)] & 0xF0)){
-            displayText += "0"; //add a leading 0 for a most-significant half-byte of zero
-        }
-        displayText +=  QString::number(theData[static_cast<unsigned long>(i)], 16 ).toUpper() + " ";   //display in hex w/capital letters
+            for (unsigned int i = runStart; i < runEnd; ++i) {
+
+                const unsigned int foregroundStyle = rendered->foregroundStyles[i - rowRange.start];
+                if (foregroundStyle != penStyle) {
+                    penStyle = foregroundStyle;
+                    painter.setPen(penStyle ? QColor(m_highlightStyles[penStyle - 1].foreground) : defaultTextColor);
+                }
 
-        ++bytesPrinted;
+                painter.drawStaticText(getCellsRect(i, i + 1).topLeft(), hexGlyphs[theData[i]]);
+            }
+
+            runStart = runEnd;
+        }
     }
+}
 
-    //write strings to view areas
-    textEdit->setTextColor(QColor::fromRgb(0,0,0));
-    textEdit->insertPlainText(displayText);
+indexRange dataSetView::getRowRange(const unsigned int rowStart, const unsigned int dataSize) const
+{
+    const unsigned long long rowEnd = static_cast<unsigned long long>(rowStart) + m_bytesPerRow;
+    return indexRange(rowStart, static_cast<unsigned int>(qMin(rowEnd, static_cast<unsigned long long>(dataSize))));
+}
 
-    addressColumn->setTextColor(QColor::fromRgb(64,64,128));
-    addressColumn->insertPlainText(addressText);
+void dataSetView::renderRow(const indexRange& range, renderedRowCache::row& rendered) const
+{
+    //the highlight style of each byte in range, as (index in m_highlightStyles) + 1, or 0 if none:
+    // foreground and background are resolved separately (a byte gets each from the last highlight that applies it)
+    // (the data is only read for byte colors, which prefetchAdjacentPages doesn't render on the worker thread)
+    rendered.foregroundStyles.assign(range.count(), 0);
+    rendered.backgroundStyles.assign(range.count(), 0);
+
+    if (!m_byteColorStyles.empty()) {
+        QSharedPointer<dataSet> theDataSet = m_dataSet.lock();
+        if (theDataSet) {
+            const dataSet::DataReadLock& DRL = theDataSet->getReadLock();
+            const std::vector<unsigned char>& theData = DRL.getData();
+
+            //byte color highlighting: every byte starts with the style for its value
+            const unsigned int end = qMin(range.end, static_cast<unsigned int>(theData.size()));
+            for (unsigned int i = range.start; i < end; ++i) {
+                rendered.foregroundStyles[i - range.start] = m_byteColorStyles[theData[i]] + 1;
+            }
+            rendered.backgroundStyles = rendered.foregroundStyles;
+        }
+    }
 
     //apply highlights for colored byte text regions
-    for (highlightSet hSet : m_highlightSets)
+    // (only ranges in this row are visited; in the order they were added: later ranges are drawn over earlier ones)
+    std::vector<highlightIndex::entry> highlights;
     {
-        highlightByteGrid(textEdit, hSet);
+        std::lock_guard<std::mutex> lock(m_highlightsMutex);
+        m_highlights.getOverlapping(range, highlights);
     }
 
-    return true;
+    for (const highlightIndex::entry& highlight : highlights) {
+
+        const indexRange visibleRange = highlight.range.getIntersection(range);
+        const highlightStyle& style = m_highlightStyles[highlight.style];
+
+        const unsigned int first = visibleRange.start - range.start;
+        const unsigned int last  = visibleRange.end   - range.start;
+
+        if (style.applyForeground) {
+            std::fill(rendered.foregroundStyles.begin() + first, rendered.foregroundStyles.begin() + last, highlight.style + 1);
+        }
+
+        if (style.applyBackground) {
+            std::fill(rendered.backgroundStyles.begin() + first, rendered.backgroundStyles.begin() + last, highlight.style + 1);
+        }
+    }
 }
 
-bool dataSetView::highlightByteGrid(QTextEdit* textEdit, highlightSet& hSet)
+std::shared_ptr<const renderedRowCache::row> dataSetView::getRenderedRow(const indexRange& range) const
 {
-    //highlight/color byte text on the supplied ranges
-    QList<QTextEdit::ExtraSelection> selectionList = textEdit->extraSelections();   //get the list of existing selections
-    unsigned int rowWidth = m_bytesPerRow*3 + 1;
+    std::shared_ptr<const renderedRowCache::row> rendered = m_renderedRows.get(range);
 
-    //text highlighting helper function:
-    //get the cursor index of the beginning of a byte's text
-    auto getByteCursorIndex = [=](unsigned int byteIndex, bool endOfSelection = false)->int{
-        unsigned int index = byteIndex - m_subset.start;     //index in currently displayed byte range
-        unsigned int ret = (index/m_bytesPerRow)*rowWidth + 3*(index%m_bytesPerRow);
+    if (!rendered) {
+        auto newRow = std::make_shared<renderedRowCache::row>();
+        renderRow(range, *newRow);
+        m_renderedRows.put(range, newRow);
+        rendered = newRow;
+    }
+    return rendered;
+}
 
-        //if this cursor index will be the end of a selection, don't select the newline at the end of a line
-        //  (prevents cursor out-of-bounds qt complaint at end of displayed byte range,
-        //  and looks nicer with colored backgrounds at the other line ends)
-        if ( endOfSelection && (0 == (index%m_bytesPerRow)) && ret > 0) {
-            ret -= 1;
-        }
-        ASSERT_LE_INT_MAX(ret);
-        return static_cast<int>(ret); //return int for QTextCursor::setPosition
-    };
+void dataSetView::prefetchAdjacentPages()
+{
+    //byte colors are rendered from the data, which the worker thread shouldn't hold a DataReadLock on
+    // (a file load into the dataSet would fail): those rows are only rendered when they're painted
+    if (!m_byteColorStyles.empty()) {
+        return;
+    }
+
+    QSharedPointer<dataSet> theDataSet = m_dataSet.lock();
+    if (!theDataSet || 0 == m_bytesPerRow) {
+        return;
+    }
+
+    const unsigned int dataSize = theDataSet->getSize();
+    const unsigned int pageRows = m_subset.count()/m_bytesPerRow;
 
-    //use QTextEdit::ExtraSelections to highlight ranges
-    for (indexRange& range : *hSet.m_ranges.data()) {
+    std::vector<indexRange> rows;
 
-        if (range.end <= m_subset.start
-         || m_subset.end <= range.start)
-        {
-            continue;   //skip ranges in addresses that aren't being displayed
+    //the next page first (the usual scrolling direction), then the previous page
+    for (unsigned int row = 0; row < pageRows; ++row) {
+        const unsigned long long rowStart = m_subset.end + static_cast<unsigned long long>(row)*m_bytesPerRow;
+        if (rowStart >= dataSize) {
+            break;
+        }
+        rows.push_back(getRowRange(static_cast<unsigned int>(rowStart), dataSize));
+    }
+    for (unsigned int row = 1; row <= pageRows; ++row) {
+        const unsigned long long rowOffset = static_cast<unsigned long long>(row)*m_bytesPerRow;
+        if (rowOffset > m_subset.start) {
+            break;
         }
+        rows.push_back(getRowRange(m_subset.start - static_cast<unsigned int>(rowOffset), dataSize));
+    }
 
-        QTextEdit::ExtraSelection selection;
-        textEdit->moveCursor(QTextCursor::Start);
-        selection.cursor = textEdit->textCursor();
+    m_renderedRows.prefetch(rows, [this](const indexRange& range, renderedRowCache::row& rendered) {
+        renderRow(range, rendered);
+    });
+}
 
-        selection.cursor.setPosition(getByteCursorIndex(qMax(range.start, m_subset.start)        ),  QTextCursor::MoveAnchor);
-        selection.cursor.setPosition(getByteCursorIndex(qMin(range.end,   m_subset.end),   true  ),  QTextCursor::KeepAnchor);
+void dataSetView::paintAddressColumn(QPainter& painter, const QRect& drawArea, const QRect& updateRect) const
+{
+    QSharedPointer<dataSet> theDataSet = m_dataSet.lock();
 
-        if (hSet.m_applyForeground) {   //apply foreground color if specified
-            selection.format.setForeground(hSet.m_foreground);
-        }
+    //ensure that weak pointer lock succeeded
+    if ( !theDataSet ){
+        return;
+    }
 
-        if (hSet.m_applyBackground) {   //apply background color if specified
-            selection.format.setBackground(hSet.m_background);
-        }
+    //skip no-print situations
+    if (0 == m_bytesPerRow || 0 == m_subset.count()) {
+        return;
+    }
 
-        selectionList.append(selection);
+    //rows must line up with the byte grid's rows
+    const int rowHeight_px = getByteCellSize(painter.font()).height();
+    if (0 >= rowHeight_px) {
+        return;
     }
 
-    textEdit->setExtraSelections(selectionList);
+    const indexRange rows = getRowsToPaint(drawArea, updateRect, rowHeight_px, theDataSet->getSize());
 
-    return true;
+    painter.setPen(QColor::fromRgb(64,64,128));
+
+    //addresses are offsets in the loaded file (which may be a window of a larger file)
+    const unsigned int digitCount = hexFormat::getAddressDigitCount(theDataSet->getLastFileOffset());
+    char addressText[hexFormat::MAX_ADDRESS_LENGTH];
+
+    for (unsigned int row = rows.start; row < rows.end; ++row) {
+
+        //byte address for the start of this row
+        const unsigned int index = m_subset.start + row*m_bytesPerRow;
+        const unsigned long long address = theDataSet->getFileOffset(index);
+        ASSERT_LE_INT_MAX(row);
+
+        //"0x" and (at least 8) lowercase hex digits
+        const unsigned int length = hexFormat::formatAddress(address, digitCount, addressText);
+        painter.drawText(QPoint(drawArea.left(), drawArea.top() + static_cast<int>(row)*rowHeight_px + painter.fontMetrics().ascent()),
+                         QString::fromLatin1(addressText, static_cast<int>(length)));
+    }
+}
+
+/*static*/ QSize dataSetView::getByteCellSize(const QFont& font)
+{
+    //measuring text is slow compared to comparing fonts, and this is needed for every resize and paint
+    // (all views normally use the same font, so only the last measured font is kept; GUI thread only)
+    static QFont measuredFont;
+    static QSize measuredSize;
+    static bool measured = false;
+
+    if (!measured || font != measuredFont) {
+        const QFontMetrics fontMetrics(font);
+
+        //rows are drawn at exact multiples of the line spacing, so they can't overlap
+        measuredSize = QSize(fontMetrics.width("00 "), fontMetrics.lineSpacing());
+        measuredFont = font;
+        measured = true;
+    }
+
+    return measuredSize;
+}
+
+indexRange dataSetView::getRowsToPaint(const QRect& drawArea, const QRect& updateRect, const int rowHeight_px, const unsigned int dataSize) const
+{
+    if (0 == m_bytesPerRow || 0 >= rowHeight_px || dataSize <= m_subset.start) {
+        return indexRange(0,0);
+    }
+
+    //rows in the displayed subset that have data
+    const unsigned int displayedBytes = qMin(m_subset.end, dataSize) - m_subset.start;
+    const unsigned int rowCount = displayedBytes/m_bytesPerRow + (displayedBytes%m_bytesPerRow ? 1 : 0);
+
+    //rows that intersect updateRect
+    const int first = qMax(0, (updateRect.top()    - drawArea.top())/rowHeight_px);
+    const int last  = qMax(0, (updateRect.bottom() - drawArea.top())/rowHeight_px + 1);
+
+    return indexRange(0, rowCount).getIntersection(indexRange(static_cast<unsigned int>(first), static_cast<unsigned int>(last)));
+}
+
+/*static*/ const std::vector<QStaticText>& dataSetView::getHexGlyphs()
+{
+    static const std::vector<QStaticText> glyphs = []() {
+
+        std::vector<QStaticText> ret;
+        ret.reserve(256);
+
+        //display in hex w/capital letters
+        unsigned char values[256];
+        for (unsigned int value = 0; value < 256; ++value) {
+            values[value] = static_cast<unsigned char>(value);
+        }
+        char digits[512];
+        hexFormat::formatHex(values, 256, digits);
+
+        for (unsigned int value = 0; value < 256; ++value) {
+            QStaticText glyph(QString::fromLatin1(digits + 2*value, 2));
+            glyph.setTextFormat(Qt::PlainText);
+            glyph.setPerformanceHint(QStaticText::AggressiveCaching);
+            ret.push_back(glyph);
+        }
+        return ret;
+    } ();
+
+    return glyphs;
 }
 
 void dataSetView::addHighlighting(const std::multiset<blockMatchSet>& matches, bool useFirstDataSet)
@@ -366,13 +670,13 @@ void dataSetView::addHighlighting(const std::multiset<blockMatchSet>& matches, b
 
     for (const blockMatchSet& match : matches) {
 
-        const std::vector<unsigned int>& indices =
+        const indexRunList& indices =
             useFirstDataSet ? match.data1_BlockStartIndices
                             : match.data2_BlockStartIndices;
 
         auto indexRanges = QSharedPointer<QVector<indexRange>>::create();
 
-        for (auto& index : indices) {
+        for (unsigned int index : indices) {
             ASSERT(noSumOverflow(                        index,match.blockSize));
             indexRanges.data()->append(indexRange(index, index+match.blockSize));
         }
@@ -469,36 +773,16 @@ void dataSetView::addDiffHighlighting(const std::list<indexRange>& ranges)
 
 void dataSetView::addByteColorHighlighting()
 {
-    if ( !m_dataSet ){
-        FAIL();
-        return;
-    }
-
-    QSharedPointer<dataSet> theDataSet = m_dataSet.lock();
-
-    //ensure that weak pointer lock succeeded
-    if ( !theDataSet ){
-        FAIL();
-        return;
-    }
-
-    //skip no-print situations
-    if (0 == m_bytesPerRow || 0 == m_subset.count()) {
-        return;
-    }
-
-
-    QString displayText = "";   //text for the main data display area
-    QString addressText = "";   //text for the address column area
-
-    //get the data to be displayed
-    const dataSet::DataReadLock& DRL = theDataSet->getReadLock();
-    const std::vector<unsigned char>& theData = DRL.getData();
+    //byte colors cover every byte (foreground and background), so highlights added before this are hidden:
+    // discard them (highlights added after this are drawn over the byte colors)
+    m_renderedRows.clear();
+    m_highlights.clear();
 
+    //byte colors are looked up from the byte values when rows are painted,
+    // so nothing is done here for each byte (or run of equal bytes) in the dataSet
+    m_byteColorStyles.resize(256);
 
-    auto addHighlightSetFromByteRange = [this]( unsigned char value,
-                                                unsigned int  endIndex, //index after last index in range
-                                                unsigned int  count      ) {
+    for (unsigned int value = 0; value < 256; ++value) {
 
         //use bits from value to fill most significant bits of rgb channels
         // 3 bits -> r, 3 bits -> g, 2 bits -> b
@@ -507,52 +791,19 @@ void dataSetView::addByteColorHighlighting()
         unsigned char g = static_cast<unsigned char>( 0x1F | ( (value & 0x1C) << 3 ));
         unsigned char b = static_cast<unsigned char>( 0x3F | ( (value & 0x03) << 6 ));
 
-        //create range, add it to a highlight set, and add the highlight set to the dataSetView
-        indexRange range(endIndex - count, endIndex);
-        auto indexRanges = QSharedPointer<QVector<indexRange>>::create();
-        indexRanges->push_back(range);
-
-        dataSetView::highlightSet hSet(indexRanges);
         //guarantee contrast: flip the most significant bit of each color channel
-        hSet.setForegroundColor(QColor::fromRgb(0x80^r,0x80^g,0x80^b));
-        hSet.setBackgroundColor(QColor::fromRgb(r,g,b));
-        this->addHighlightSet(hSet);
-    };
-
-
-    //iterate through data, make single-range highlightSets and apply them
-    unsigned char value = 0;
-    unsigned int count = 0;
-
-    for (unsigned int i = 0; i < theData.size(); ++i) {
-
-        if (0 < count) {
-
-            if (theData[i] == value) {
-                //extend existing range
-                ++count;
-                continue;
-            }
-            else {
-                //range ended:
-                // add highlightSet
-                addHighlightSetFromByteRange(value, i, count);
-            }
-        }
-
-        //open new range
-        value = theData[i];
-        count = 1;
-    }
-
-    if (0 < count) {
-        //add the final range
-        ASSERT_LE_UINT_MAX(theData.size());
-        addHighlightSetFromByteRange(value, static_cast<unsigned int>(theData.size()), count);
+        m_byteColorStyles[value] = getHighlightStyleIndex(highlightStyle{   true,
+                                                                            true,
+                                                                            qRgb(0x80^r,0x80^g,0x80^b),
+                                                                            qRgb(r,g,b) });
     }
 }
 
 void dataSetView::clearHighlighting()
 {
-    m_highlightSets.clear();
+    m_renderedRows.clear();
+    m_byteColorStyles.clear();
+    m_highlights.clear();
+    m_highlightStyles.clear();
+    m_highlightStyleIndices.clear();
 }
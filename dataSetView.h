@@ -5,15 +5,25 @@
 #include <QWeakPointer>
 #include <QVector>
 #include <QString>
-#include <QTextEdit>
+#include <QPainter>
+#include <QStaticText>
+#include <QFont>
 #include <QtGlobal>
 
 #include <set>
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <memory>
 
 #include "dataSet.h"
 #include "indexrange.h"
 #include "defensivecoding.h"
 #include "blockmatchset.h"
+#include "hexfield.h"
+#include "highlightindex.h"
+#include "renderedrowcache.h"
+#include "hexformat.h"
 
 /*
     displays a dataSet in the QT interface
@@ -67,8 +77,17 @@ public:
 
     dataSetView(QSharedPointer<dataSet>& theDataSet);
 
-    void updateByteGridDimensions(QTextEdit* textEdit);
-    bool printByteGrid(QTextEdit* textEdit, QTextEdit* addressColumn);
+    void updateByteGridDimensions(hexField* byteGrid);
+
+    //displays this dataSetView in the supplied hexFields (they are repainted from its current subset)
+    // returns false (and clears the hexFields) if there is nothing to display
+    bool printByteGrid(hexField* byteGrid, hexField* addressColumn);
+
+    //draw the visible rows of the byte grid / address column (called by hexField::paintEvent)
+    // drawArea: where the first row starts, and the available space
+    // updateRect: rows outside this don't need to be drawn
+    void paintByteGrid(QPainter& painter, const QRect& drawArea, const QRect& updateRect) const;
+    void paintAddressColumn(QPainter& painter, const QRect& drawArea, const QRect& updateRect) const;
 
     //gets the subset of the dataSet being displayed
     indexRange getSubset() const;
@@ -88,16 +107,96 @@ public:
 
     unsigned int getBytesPerRow();
 
+    //the characters in each address column address (addresses are offsets in the loaded file)
+    unsigned int getAddressLength() const;
+
+    //the displayed rows as text (see hexFormat::formatRow), one line per row
+    QString getVisibleRowsText() const;
+
 signals:
     void subsetChanged(indexRange subset);   //was used for debugging dataSetView, should this be removed?
 
 private:
-    bool highlightByteGrid(QTextEdit* textEdit, highlightSet& hSet);
+    //the pixel size of one byte in the byte grid: its 2 hex digits and a trailing space (assuming MONOSPACE FONTS)
+    static QSize getByteCellSize(const QFont& font);
+
+    //the byte grid layout for a draw area size, font and column mode
+    // (a value-initialized gridGeometry has no inputs and empty results)
+    class gridGeometry {
+    public:
+        //inputs
+        QSize drawAreaSize;
+        QSize byteCellSize;
+        ByteGridColumnMode columnMode;
+        unsigned int largestMultipleOf_N;
+        unsigned int upTo_N;
+
+        //results (0 if nothing fits)
+        unsigned int bytesPerRow;
+        unsigned int rowCount;
+
+        bool hasSameInputs(const gridGeometry& g) const;
+    };
+
+    //calculates the results of geometry from its inputs
+    static void calculateGridGeometry(gridGeometry& geometry);
+
+    //the displayed rows that intersect updateRect
+    indexRange getRowsToPaint(const QRect& drawArea, const QRect& updateRect, const int rowHeight_px, const unsigned int dataSize) const;
+
+    //"00" to "FF": prepared text for each byte value
+    static const std::vector<QStaticText>& getHexGlyphs();
+
+    //the byte grid row starting at rowStart (the last row may be partial)
+    indexRange getRowRange(const unsigned int rowStart, const unsigned int dataSize) const;
+
+    //resolves the highlight style of each byte in range (called on the GUI thread, and on m_renderedRows' worker thread)
+    void renderRow(const indexRange& range, renderedRowCache::row& rendered) const;
+
+    //the rendered row for range: from m_renderedRows, or rendered now (and cached) if it isn't there
+    std::shared_ptr<const renderedRowCache::row> getRenderedRow(const indexRange& range) const;
+
+    //renders the rows of the pages above and below the displayed subset in the background
+    void prefetchAdjacentPages();
+
+    //the colors applied by a highlightSet
+    class highlightStyle {
+    public:
+        bool applyForeground;
+        bool applyBackground;
+        QRgb foreground;
+        QRgb background;
+    };
+
+    //returns the index in m_highlightStyles of this style (adding it if it's new)
+    unsigned int getHighlightStyleIndex(const highlightSet& hSet);
+    unsigned int getHighlightStyleIndex(const highlightStyle& style);
 
     QWeakPointer<dataSet> m_dataSet;            //the dataSet that this dataSetView will display
-    QVector<highlightSet> m_highlightSets;      //highlight regions which color the text
+
+    //highlight regions which color the text:
+    // the ranges of all added highlightSets, indexed so painting only visits ranges in the painted rows
+    // (mutable: the index is sorted when it's first queried after ranges are added;
+    //  queries lock m_highlightsMutex, since rows are also rendered on m_renderedRows' worker thread)
+    mutable highlightIndex m_highlights;
+    mutable std::mutex m_highlightsMutex;
+    std::vector<highlightStyle> m_highlightStyles;                                      //m_highlights style indices refer to these
+    std::map<std::tuple<bool,bool,QRgb,QRgb>, unsigned int> m_highlightStyleIndices;   //m_highlightStyles indices by style
+
+    //byte color highlighting (see addByteColorHighlighting): the m_highlightStyles index for each byte value,
+    // or empty if byte colors are off
+    std::vector<unsigned int> m_byteColorStyles;
+
     indexRange m_subset;                        //the subset of the dataSet that is displayed by this dataSetView
     unsigned int m_bytesPerRow;                 //bytes per row in byte display grid
+    gridGeometry m_gridGeometry;                //the layout from the last updateByteGridDimensions (reused until its inputs change)
+
+    static const unsigned int INITIAL_RENDERED_ROW_CAPACITY = 256;     //until the byte grid dimensions are known
+
+    //rendered rows of the displayed page and the pages around it
+    // (declared last: it's destroyed first, which stops its worker thread before the members it reads are destroyed;
+    //  it must be cleared before highlights or styles are changed)
+    mutable renderedRowCache m_renderedRows;
 
 };
 
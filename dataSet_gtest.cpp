@@ -56,3 +56,98 @@ TEST(dataSet, LoadAndCompareSameSizeFiles){
 
     EXPECT_EQ(expected, diffs) << "wrong diffs detected";
 }
+
+TEST(dataSet, ReadFileThenPublish){
+    std::unique_ptr<std::vector<unsigned char>> data(new std::vector<unsigned char>());
+    std::vector<dataSet::fileWindow> windows;
+
+    unsigned long long lastBytesRead = 0;
+    unsigned long long reportedSize = 0;
+    dataSet::loadFileResult res = dataSet::readFile(gtestDefs::testFilePath % "test2_1", windows, *data, nullptr,
+                                                    [&](unsigned long long bytesRead, unsigned long long fileSize) {
+                                                        EXPECT_LT(lastBytesRead, bytesRead);
+                                                        lastBytesRead = bytesRead;
+                                                        reportedSize = fileSize;
+                                                    });
+    EXPECT_EQ(dataSet::loadFileResult::SUCCESS, res);
+    EXPECT_EQ(data->size(), reportedSize);
+    EXPECT_EQ(data->size(), lastBytesRead) << "progress didn't reach the end of the file";
+    EXPECT_TRUE(windows.empty());
+
+    const std::vector<unsigned char> readData = *data;
+
+    dataSet dataSet1;
+    EXPECT_EQ(dataSet::loadFileResult::SUCCESS, dataSet1.loadFileData(gtestDefs::testFilePath % "test2_1", std::move(data)));
+    EXPECT_TRUE(dataSet1.isLoaded());
+    EXPECT_EQ(dataSet::sourceType::file, dataSet1.getSourceInfo().type);
+    EXPECT_EQ(readData, dataSet1.getReadLock().getData());
+
+    //the same as loading the file directly
+    dataSet dataSet2;
+    EXPECT_EQ(dataSet::loadFileResult::SUCCESS, dataSet2.loadFile(gtestDefs::testFilePath % "test2_1"));
+    EXPECT_EQ(readData, dataSet2.getReadLock().getData());
+}
+
+TEST(dataSet, ReadFileAborted){
+    std::vector<unsigned char> data;
+    std::vector<dataSet::fileWindow> windows;
+    dataSet::loadFileResult res = dataSet::readFile(gtestDefs::testFilePath % "test2_1", windows, data, [](){ return true; });
+    EXPECT_EQ(dataSet::loadFileResult::ERROR_Aborted, res);
+    EXPECT_TRUE(data.empty());
+
+    res = dataSet::readFile("thisfiledoesnotexist", windows, data);
+    EXPECT_EQ(dataSet::loadFileResult::ERROR_FileDoesNotExist, res);
+}
+
+TEST(dataSet, LoadFileWindows){
+    dataSet whole;
+    ASSERT_EQ(dataSet::loadFileResult::SUCCESS, whole.loadFile(gtestDefs::testFilePath % "test2_1"));
+    const std::vector<unsigned char> wholeData = whole.getReadLock().getData();
+    const unsigned long long fileSize = wholeData.size();
+    ASSERT_LT(600u, fileSize);
+
+    //2 windows (out of order), and one that runs past the end of the file
+    const std::vector<dataSet::fileWindow> windows = { {500, 100}, {10, 20}, {fileSize - 5, 100}, {fileSize + 10, 10} };
+
+    dataSet windowed;
+    ASSERT_EQ(dataSet::loadFileResult::SUCCESS, windowed.loadFile(gtestDefs::testFilePath % "test2_1", windows));
+    ASSERT_EQ(125u, windowed.getSize());
+
+    //the windows' bytes, one after another
+    std::vector<unsigned char> expected;
+    expected.insert(expected.end(), wholeData.begin() + 500, wholeData.begin() + 600);
+    expected.insert(expected.end(), wholeData.begin() +  10, wholeData.begin() +  30);
+    expected.insert(expected.end(), wholeData.end() - 5, wholeData.end());
+    EXPECT_EQ(expected, windowed.getReadLock().getData());
+
+    //the loaded windows are clipped to the file
+    const std::vector<dataSet::fileWindow> loaded = windowed.getWindows();
+    ASSERT_EQ(3u, loaded.size());
+    EXPECT_EQ(5u, loaded[2].length);
+
+    //data indices map to the original file offsets
+    EXPECT_EQ(500u, windowed.getFileOffset(0));
+    EXPECT_EQ(599u, windowed.getFileOffset(99));
+    EXPECT_EQ( 10u, windowed.getFileOffset(100));
+    EXPECT_EQ(fileSize - 5, windowed.getFileOffset(120));
+    EXPECT_EQ(fileSize - 1, windowed.getLastFileOffset());
+
+    //without windows, indices are offsets
+    EXPECT_EQ(123u, whole.getFileOffset(123));
+    EXPECT_TRUE(whole.getWindows().empty());
+}
+
+TEST(dataSet, ParseWindows){
+    std::vector<dataSet::fileWindow> windows;
+    ASSERT_TRUE(dataSet::parseWindows("0x4000000:0x4000000, 16:512", windows));
+    ASSERT_EQ(2u, windows.size());
+    EXPECT_EQ(0x4000000u, windows[0].offset);
+    EXPECT_EQ(0x4000000u, windows[0].length);
+    EXPECT_EQ(16u,  windows[1].offset);
+    EXPECT_EQ(512u, windows[1].length);
+
+    EXPECT_FALSE(dataSet::parseWindows("", windows));
+    EXPECT_FALSE(dataSet::parseWindows("100", windows));
+    EXPECT_FALSE(dataSet::parseWindows("100:0", windows));
+    EXPECT_FALSE(dataSet::parseWindows("x:10", windows));
+}
@@ -0,0 +1,376 @@
+#include "decompressor.h"
+
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+
+namespace {
+
+//reads compressed chunks on a worker thread, up to QUEUED_CHUNK_COUNT ahead of the decoder
+class chunkReader
+{
+public:
+    explicit chunkReader(decompressor::readFunction read)
+        :   m_read(read),
+            m_mutex(),
+            m_changed(),
+            m_chunks(),
+            m_done(false),
+            m_failed(false),
+            m_stop(false),
+            m_thread(&chunkReader::readLoop, this)
+    {
+    }
+
+    ~chunkReader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_changed.notify_all();
+        m_thread.join();
+    }
+
+    chunkReader(const chunkReader&) = delete;
+    chunkReader& operator=(const chunkReader&) = delete;
+
+    //waits for the next chunk: returns false at the end of the data (or after a read error, see failed())
+    bool next(std::vector<unsigned char>& chunk)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [this]{ return !m_chunks.empty() || m_done; });
+
+        if (m_chunks.empty()) {
+            return false;
+        }
+
+        chunk.swap(m_chunks.front());
+        m_chunks.pop_front();
+        m_changed.notify_all();
+
+        return true;
+    }
+
+    bool failed()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_failed;
+    }
+
+private:
+    void readLoop()
+    {
+        while (true) {
+            std::vector<unsigned char> chunk(decompressor::READ_CHUNK_SIZE);
+            const long long count = m_read(chunk.data(), chunk.size());
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            if (0 >= count) {
+                m_failed = (0 > count);
+                m_done = true;
+                m_changed.notify_all();
+                return;
+            }
+
+            chunk.resize(static_cast<std::size_t>(count));
+            m_chunks.push_back(std::move(chunk));
+            m_changed.notify_all();
+
+            m_changed.wait(lock, [this]{ return m_stop || m_chunks.size() < decompressor::QUEUED_CHUNK_COUNT; });
+            if (m_stop) {
+                return;
+            }
+        }
+    }
+
+    decompressor::readFunction m_read;
+
+    std::mutex m_mutex;
+    std::condition_variable m_changed;      //signals both threads: a chunk was added or taken, or reading ended or was stopped
+    std::deque<std::vector<unsigned char>> m_chunks;
+    bool m_done;
+    bool m_failed;
+    bool m_stop;
+
+    std::thread m_thread;                   //declared last: started after the other members are constructed
+};
+
+#if defined(HAVE_ZLIB) || defined(HAVE_LZMA)
+//makes room for at least OUTPUT_CHUNK_SIZE more bytes after the produced bytes of out (up to maxSize)
+// returns false if produced has reached maxSize
+bool growOutput(std::vector<unsigned char>& out, const std::size_t produced, const unsigned long long maxSize)
+{
+    if (produced >= maxSize) {
+        return false;
+    }
+
+    if (out.size() - produced < decompressor::OUTPUT_CHUNK_SIZE) {
+        //grows a chunk at a time (the vector's capacity grows geometrically):
+        // the zero-filled bytes are still in the cache when the decoder overwrites them
+        out.resize(static_cast<std::size_t>(std::min<unsigned long long>(maxSize, produced + decompressor::OUTPUT_CHUNK_SIZE)));
+    }
+
+    return true;
+}
+#endif
+
+}
+
+/*static*/ decompressor::format decompressor::detectFormat(const unsigned char* header, const std::size_t count)
+{
+    static const unsigned char GZIP_MAGIC[] = {0x1F, 0x8B};
+    static const unsigned char XZ_MAGIC[]   = {0xFD, 0x37, 0x7A, 0x58, 0x5A, 0x00};
+    static const unsigned char ZSTD_MAGIC[] = {0x28, 0xB5, 0x2F, 0xFD};
+
+    auto startsWith = [&](const unsigned char* magic, const std::size_t magicSize) {
+        return count >= magicSize && 0 == std::memcmp(header, magic, magicSize);
+    };
+
+    if (startsWith(GZIP_MAGIC, sizeof(GZIP_MAGIC))) {
+        return format::gzip;
+    }
+    if (startsWith(XZ_MAGIC, sizeof(XZ_MAGIC))) {
+        return format::xz;
+    }
+    if (startsWith(ZSTD_MAGIC, sizeof(ZSTD_MAGIC))) {
+        return format::zstd;
+    }
+
+    return format::none;
+}
+
+/*static*/ bool decompressor::isSupported(const format f)
+{
+    switch (f) {
+        case format::none:
+            return true;
+
+        case format::gzip:
+#ifdef HAVE_ZLIB
+            return true;
+#else
+            return false;
+#endif
+
+        case format::xz:
+#ifdef HAVE_LZMA
+            return true;
+#else
+            return false;
+#endif
+
+        case format::zstd:
+            return false;
+
+        default:
+            FAIL();
+            return false;
+    }
+}
+
+/*static*/ const char* decompressor::getName(const format f)
+{
+    switch (f) {
+        case format::none:  return "uncompressed";
+        case format::gzip:  return "gzip";
+        case format::xz:    return "xz";
+        case format::zstd:  return "zstd";
+        default:
+            FAIL();
+            return "";
+    }
+}
+
+/*static*/ decompressor::result decompressor::decompress(   const format f,
+                                                            readFunction read,
+                                                            std::vector<unsigned char>& out,
+                                                            const unsigned long long maxSize,
+                                                            abortFunction abortRequested /*= nullptr*/,
+                                                            progressFunction progress /*= nullptr*/ )
+{
+    out.clear();
+
+    if (format::none == f || !isSupported(f)) {
+        return result::ERROR_Unsupported;
+    }
+
+    chunkReader reader(read);
+    std::vector<unsigned char> chunk;
+    unsigned long long compressedBytesRead = 0;
+    std::size_t produced = 0;
+
+    //takes the next chunk (sets inputEnded instead at the end of the data)
+    bool inputEnded = false;
+    auto nextChunk = [&]() -> bool {
+        if (!reader.next(chunk)) {
+            chunk.clear();
+            inputEnded = true;
+            return false;
+        }
+        compressedBytesRead += chunk.size();
+        if (progress) {
+            progress(compressedBytesRead);
+        }
+        return true;
+    };
+
+    result res = result::ERROR_Unsupported;
+
+#if !defined(HAVE_ZLIB) && !defined(HAVE_LZMA)
+    //no decoders in this build
+    (void)nextChunk;
+    (void)maxSize;
+    (void)abortRequested;
+#endif
+
+#ifdef HAVE_ZLIB
+    if (format::gzip == f) {
+        z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+
+        //15: the largest window, +32: detect the gzip (or zlib) header
+        if (Z_OK != inflateInit2(&zs, 15 + 32)) {
+            return result::ERROR_Corrupt;
+        }
+
+        bool streamEnded = false;
+        res = result::SUCCESS;
+
+        while (result::SUCCESS == res) {
+            if (0 == zs.avail_in && !inputEnded) {
+                if (nextChunk()) {
+                    zs.next_in  = chunk.data();
+                    zs.avail_in = static_cast<uInt>(chunk.size());
+                }
+            }
+
+            if (abortRequested && abortRequested()) {
+                res = result::ERROR_Aborted;
+                break;
+            }
+
+            if (streamEnded) {
+                if (0 == zs.avail_in) {
+                    break;  //the end of the last gzip member
+                }
+
+                //another gzip member follows (concatenated files)
+                inflateReset(&zs);
+                streamEnded = false;
+            }
+
+            if (!growOutput(out, produced, maxSize)) {
+                res = result::ERROR_TooLarge;
+                break;
+            }
+            zs.next_out  = out.data() + produced;
+            zs.avail_out = static_cast<uInt>(out.size() - produced);
+
+            const int ret = inflate(&zs, Z_NO_FLUSH);
+            produced = static_cast<std::size_t>(zs.next_out - out.data());
+
+            if (Z_STREAM_END == ret) {
+                streamEnded = true;
+            }
+            else if (Z_BUF_ERROR == ret) {
+                //no progress was possible: more input is needed
+                if (inputEnded) {
+                    break;  //truncated
+                }
+            }
+            else if (Z_OK != ret) {
+                res = result::ERROR_Corrupt;
+            }
+        }
+
+        inflateEnd(&zs);
+
+        if (result::SUCCESS == res && !streamEnded) {
+            res = result::ERROR_Corrupt;    //truncated
+        }
+    }
+#endif
+
+#ifdef HAVE_LZMA
+    if (format::xz == f) {
+        lzma_stream ls = LZMA_STREAM_INIT;
+
+#if LZMA_VERSION >= 50040002
+        //multi-threaded decoding (for files with multiple blocks, e.g. from xz -T)
+        lzma_mt mt;
+        std::memset(&mt, 0, sizeof(mt));
+        mt.flags = LZMA_CONCATENATED;
+        mt.threads = std::max(1u, std::thread::hardware_concurrency());
+        mt.memlimit_threading = lzma_physmem()/4;
+        mt.memlimit_stop = UINT64_MAX;
+        const lzma_ret initRet = lzma_stream_decoder_mt(&ls, &mt);
+#else
+        const lzma_ret initRet = lzma_stream_decoder(&ls, UINT64_MAX, LZMA_CONCATENATED);
+#endif
+        if (LZMA_OK != initRet) {
+            return result::ERROR_Corrupt;
+        }
+
+        res = result::SUCCESS;
+
+        while (result::SUCCESS == res) {
+            if (0 == ls.avail_in && !inputEnded) {
+                if (nextChunk()) {
+                    ls.next_in  = chunk.data();
+                    ls.avail_in = chunk.size();
+                }
+            }
+
+            if (abortRequested && abortRequested()) {
+                res = result::ERROR_Aborted;
+                break;
+            }
+
+            if (!growOutput(out, produced, maxSize)) {
+                res = result::ERROR_TooLarge;
+                break;
+            }
+            ls.next_out  = out.data() + produced;
+            ls.avail_out = out.size() - produced;
+
+            const lzma_ret ret = lzma_code(&ls, inputEnded ? LZMA_FINISH : LZMA_RUN);
+            produced = static_cast<std::size_t>(ls.next_out - out.data());
+
+            if (LZMA_STREAM_END == ret) {
+                break;
+            }
+            else if (LZMA_OK != ret) {
+                res = result::ERROR_Corrupt;    //including truncated data (LZMA_BUF_ERROR)
+            }
+        }
+
+        lzma_end(&ls);
+    }
+#endif
+
+    if (reader.failed()) {
+        res = result::ERROR_ReadFailure;
+    }
+
+    if (result::SUCCESS == res) {
+        out.resize(produced);
+    }
+    else {
+        std::vector<unsigned char>().swap(out);
+    }
+
+    return res;
+}
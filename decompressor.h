@@ -0,0 +1,73 @@
+#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+#include "defensivecoding.h"
+
+/*
+    detects compressed file formats, and decompresses them into memory while the compressed data is read
+
+    reading and decoding are pipelined: compressed chunks are read on a worker thread while the calling thread decodes
+     (xz data with multiple blocks is also decoded on multiple threads)
+
+    supported formats depend on the libraries available at build time:
+        gzip    zlib        (HAVE_ZLIB)
+        xz      liblzma     (HAVE_LZMA)
+        zstd    detected, but not supported yet
+*/
+
+class decompressor
+{
+public:
+    decompressor() = delete;    //static functions only
+
+    enum class format {
+        none,   //not compressed (or an unknown format)
+        gzip,
+        xz,
+        zstd
+    };
+
+    enum class result {
+        SUCCESS,
+        ERROR_Unsupported,  //format isn't supported by this build
+        ERROR_Corrupt,      //the compressed data is invalid or truncated
+        ERROR_ReadFailure,
+        ERROR_TooLarge,     //the decompressed data is larger than maxSize
+        ERROR_Aborted
+    };
+
+    //the number of leading bytes detectFormat needs to recognize every format
+    static const std::size_t HEADER_SIZE = 6;
+
+    //recognizes a format by the magic number at the start of a file (header: its first count bytes)
+    static format detectFormat(const unsigned char* header, const std::size_t count);
+
+    static bool isSupported(const format f);
+    static const char* getName(const format f);
+
+    //reads up to size bytes of compressed data into buffer: returns the number of bytes read, 0 at the end, or -1 on error
+    // (called on the reader thread)
+    typedef std::function<long long(unsigned char* buffer, unsigned long long size)> readFunction;
+    typedef std::function<bool()> abortFunction;
+    typedef std::function<void(unsigned long long compressedBytesRead)> progressFunction;
+
+    //decompresses everything read by read into out
+    // progress (if set) is called as compressed chunks are decoded; decoding stops with ERROR_Aborted when abortRequested (if set) returns true
+    static result decompress(   const format f,
+                                readFunction read,
+                                std::vector<unsigned char>& out,
+                                const unsigned long long maxSize,
+                                abortFunction abortRequested = nullptr,
+                                progressFunction progress = nullptr );
+
+    static const unsigned int READ_CHUNK_SIZE = 1 << 20;    //compressed bytes per read
+    static const unsigned int QUEUED_CHUNK_COUNT = 4;       //chunks the reader thread can read ahead of the decoder
+    static const unsigned int OUTPUT_CHUNK_SIZE = 1 << 20;  //out grows by at least this much before each decode step
+
+};
+
+#endif // DECOMPRESSOR_H
@@ -0,0 +1,182 @@
+#include "decompressor.h"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+
+#include "gtestDefs.h"
+#include <gtest.h>
+
+namespace {
+
+std::vector<unsigned char> makeData(const unsigned int size)
+{
+    //compressible, but not trivially
+    std::srand(43);
+    std::vector<unsigned char> data(size);
+    for (unsigned char& byte : data) {
+        byte = static_cast<unsigned char>(std::rand() % 16);
+    }
+    return data;
+}
+
+//reads compressed from memory, at most maxRead bytes at a time
+decompressor::readFunction readFrom(const std::vector<unsigned char>& compressed, const unsigned long long maxRead = ~0ULL)
+{
+    auto position = std::make_shared<std::size_t>(0);
+    return [&compressed, position, maxRead](unsigned char* buffer, unsigned long long size) -> long long {
+        const std::size_t count = static_cast<std::size_t>(std::min<unsigned long long>({size, maxRead, compressed.size() - *position}));
+        std::memcpy(buffer, compressed.data() + *position, count);
+        *position += count;
+        return static_cast<long long>(count);
+    };
+}
+
+#ifdef HAVE_ZLIB
+std::vector<unsigned char> gzipCompress(const std::vector<unsigned char>& data)
+{
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);  //+16: gzip header
+
+    std::vector<unsigned char> compressed(deflateBound(&zs, static_cast<uLong>(data.size())) + 32);
+    zs.next_in   = const_cast<unsigned char*>(data.data());
+    zs.avail_in  = static_cast<uInt>(data.size());
+    zs.next_out  = compressed.data();
+    zs.avail_out = static_cast<uInt>(compressed.size());
+    EXPECT_EQ(Z_STREAM_END, deflate(&zs, Z_FINISH));
+
+    compressed.resize(zs.total_out);
+    deflateEnd(&zs);
+    return compressed;
+}
+#endif
+
+#ifdef HAVE_LZMA
+std::vector<unsigned char> xzCompress(const std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> compressed(lzma_stream_buffer_bound(data.size()));
+    std::size_t size = 0;
+    EXPECT_EQ(LZMA_OK, lzma_easy_buffer_encode(1, LZMA_CHECK_CRC64, nullptr, data.data(), data.size(),
+                                               compressed.data(), &size, compressed.size()));
+    compressed.resize(size);
+    return compressed;
+}
+#endif
+
+}
+
+TEST(decompressor, detectFormat){
+    const unsigned char gzip[] = {0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00};
+    const unsigned char xz[]   = {0xFD, 0x37, 0x7A, 0x58, 0x5A, 0x00};
+    const unsigned char zstd[] = {0x28, 0xB5, 0x2F, 0xFD, 0x00, 0x00};
+    const unsigned char text[] = {'h', 'e', 'l', 'l', 'o', '!'};
+
+    EXPECT_EQ(decompressor::format::gzip, decompressor::detectFormat(gzip, sizeof(gzip)));
+    EXPECT_EQ(decompressor::format::xz,   decompressor::detectFormat(xz,   sizeof(xz)));
+    EXPECT_EQ(decompressor::format::zstd, decompressor::detectFormat(zstd, sizeof(zstd)));
+    EXPECT_EQ(decompressor::format::none, decompressor::detectFormat(text, sizeof(text)));
+
+    //too short to match
+    EXPECT_EQ(decompressor::format::none, decompressor::detectFormat(xz, 5));
+    EXPECT_EQ(decompressor::format::none, decompressor::detectFormat(gzip, 0));
+}
+
+TEST(decompressor, unsupported){
+    std::vector<unsigned char> compressed = {0x28, 0xB5, 0x2F, 0xFD};
+    std::vector<unsigned char> out;
+    EXPECT_FALSE(decompressor::isSupported(decompressor::format::zstd));
+    EXPECT_EQ(decompressor::result::ERROR_Unsupported,
+              decompressor::decompress(decompressor::format::zstd, readFrom(compressed), out, ~0ULL));
+}
+
+#ifdef HAVE_ZLIB
+TEST(decompressor, gzip){
+    //larger than several read and output chunks
+    const std::vector<unsigned char> data = makeData(5*decompressor::OUTPUT_CHUNK_SIZE + 123);
+    const std::vector<unsigned char> compressed = gzipCompress(data);
+    ASSERT_EQ(decompressor::format::gzip, decompressor::detectFormat(compressed.data(), compressed.size()));
+
+    unsigned long long lastProgress = 0;
+    std::vector<unsigned char> out;
+    EXPECT_EQ(decompressor::result::SUCCESS,
+              decompressor::decompress(decompressor::format::gzip, readFrom(compressed, 1000), out, ~0ULL, nullptr,
+                                       [&](unsigned long long compressedBytesRead) {
+                                           EXPECT_LT(lastProgress, compressedBytesRead);
+                                           lastProgress = compressedBytesRead;
+                                       }));
+    EXPECT_EQ(compressed.size(), lastProgress);
+    EXPECT_TRUE(data == out);
+}
+
+TEST(decompressor, gzipConcatenated){
+    const std::vector<unsigned char> data1 = makeData(1000);
+    const std::vector<unsigned char> data2(500, 0x55);
+
+    std::vector<unsigned char> compressed = gzipCompress(data1);
+    const std::vector<unsigned char> compressed2 = gzipCompress(data2);
+    compressed.insert(compressed.end(), compressed2.begin(), compressed2.end());
+
+    std::vector<unsigned char> expected = data1;
+    expected.insert(expected.end(), data2.begin(), data2.end());
+
+    std::vector<unsigned char> out;
+    EXPECT_EQ(decompressor::result::SUCCESS,
+              decompressor::decompress(decompressor::format::gzip, readFrom(compressed), out, ~0ULL));
+    EXPECT_TRUE(expected == out);
+}
+
+TEST(decompressor, gzipErrors){
+    const std::vector<unsigned char> data = makeData(100000);
+    std::vector<unsigned char> compressed = gzipCompress(data);
+    std::vector<unsigned char> out;
+
+    //too large
+    EXPECT_EQ(decompressor::result::ERROR_TooLarge,
+              decompressor::decompress(decompressor::format::gzip, readFrom(compressed), out, 50000));
+    EXPECT_TRUE(out.empty());
+
+    //aborted
+    EXPECT_EQ(decompressor::result::ERROR_Aborted,
+              decompressor::decompress(decompressor::format::gzip, readFrom(compressed), out, ~0ULL, [](){ return true; }));
+
+    //read failure
+    EXPECT_EQ(decompressor::result::ERROR_ReadFailure,
+              decompressor::decompress(decompressor::format::gzip, [](unsigned char*, unsigned long long){ return -1LL; }, out, ~0ULL));
+
+    //truncated
+    compressed.resize(compressed.size()/2);
+    EXPECT_EQ(decompressor::result::ERROR_Corrupt,
+              decompressor::decompress(decompressor::format::gzip, readFrom(compressed), out, ~0ULL));
+}
+#endif
+
+#ifdef HAVE_LZMA
+TEST(decompressor, xz){
+    const std::vector<unsigned char> data = makeData(3*decompressor::OUTPUT_CHUNK_SIZE + 45);
+    const std::vector<unsigned char> compressed = xzCompress(data);
+    ASSERT_EQ(decompressor::format::xz, decompressor::detectFormat(compressed.data(), compressed.size()));
+
+    std::vector<unsigned char> out;
+    EXPECT_EQ(decompressor::result::SUCCESS,
+              decompressor::decompress(decompressor::format::xz, readFrom(compressed, 777), out, ~0ULL));
+    EXPECT_TRUE(data == out);
+}
+
+TEST(decompressor, xzTruncated){
+    std::vector<unsigned char> compressed = xzCompress(makeData(100000));
+    compressed.resize(compressed.size() - 10);
+
+    std::vector<unsigned char> out;
+    EXPECT_EQ(decompressor::result::ERROR_Corrupt,
+              decompressor::decompress(decompressor::format::xz, readFrom(compressed), out, ~0ULL));
+    EXPECT_TRUE(out.empty());
+}
+#endif
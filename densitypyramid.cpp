@@ -0,0 +1,150 @@
+#include "densitypyramid.h"
+
+densityPyramid::densityPyramid(const unsigned int dataSize, const unsigned int maxBaseBucketCount)
+    :   m_dataSize(dataSize),
+        m_baseShift(0),
+        m_levels()
+{
+    ASSERT(maxBaseBucketCount > 0);
+
+    while ( ((static_cast<unsigned long long>(m_dataSize) + (1ULL << m_baseShift) - 1) >> m_baseShift) > maxBaseBucketCount ) {
+        ++m_baseShift;
+    }
+
+    //add levels until one bucket holds the whole data set
+    do {
+        m_levels.emplace_back();
+        const unsigned int level = static_cast<unsigned int>(m_levels.size() - 1);
+        m_levels.back().resize(static_cast<size_t>(getBucketCount(level))*CATEGORY_COUNT, 0);
+    } while (getBucketCount(static_cast<unsigned int>(m_levels.size() - 1)) > 1);
+}
+
+unsigned int densityPyramid::getDataSize() const
+{
+    return m_dataSize;
+}
+
+unsigned int densityPyramid::getLevelCount() const
+{
+    ASSERT_LE_UINT_MAX(m_levels.size());
+    return static_cast<unsigned int>(m_levels.size());
+}
+
+unsigned long long densityPyramid::getBucketSize(const unsigned int level) const
+{
+    ASSERT(level < m_levels.size());
+    return 1ULL << (m_baseShift + level);
+}
+
+unsigned int densityPyramid::getBucketCount(const unsigned int level) const
+{
+    const unsigned long long bucketSize = getBucketSize(level);
+    const unsigned long long count = (static_cast<unsigned long long>(m_dataSize) + bucketSize - 1) / bucketSize;
+
+    ASSERT_LE_UINT_MAX(count);
+    return std::max(1u, static_cast<unsigned int>(count));
+}
+
+indexRange densityPyramid::getBucketRange(const unsigned int level, const unsigned int bucket) const
+{
+    const unsigned long long bucketSize = getBucketSize(level);
+    const unsigned long long start = std::min(static_cast<unsigned long long>(m_dataSize), bucket*bucketSize);
+    const unsigned long long end   = std::min(static_cast<unsigned long long>(m_dataSize), start + bucketSize);
+
+    return indexRange(static_cast<unsigned int>(start), static_cast<unsigned int>(end));
+}
+
+unsigned int densityPyramid::getCount(const unsigned int level, const unsigned int bucket, const category c) const
+{
+    ASSERT(level < m_levels.size());
+    ASSERT(bucket < getBucketCount(level));
+
+    return m_levels[level][static_cast<size_t>(bucket)*CATEGORY_COUNT + static_cast<size_t>(c)];
+}
+
+void densityPyramid::add(const indexRange& range, const category c)
+{
+    const indexRange r = range.getIntersection(indexRange(0, m_dataSize));
+    if (0 == r.count()) {
+        return;
+    }
+
+    for (unsigned int level = 0; level < m_levels.size(); ++level) {
+        const unsigned int shift = m_baseShift + level;
+        const unsigned int firstBucket = static_cast<unsigned int>(static_cast<unsigned long long>(r.start    ) >> shift);
+        const unsigned int lastBucket  = static_cast<unsigned int>(static_cast<unsigned long long>(r.end - 1) >> shift);
+
+        for (unsigned int bucket = firstBucket; bucket <= lastBucket; ++bucket) {
+            unsigned int& count = m_levels[level][static_cast<size_t>(bucket)*CATEGORY_COUNT + static_cast<size_t>(c)];
+            const unsigned int overlap = r.getIntersection(getBucketRange(level, bucket)).count();
+
+            ASSERT(noSumOverflow(count, overlap));
+            count += overlap;
+        }
+    }
+}
+
+void densityPyramid::clear()
+{
+    for (std::vector<unsigned int>& level : m_levels) {
+        std::fill(level.begin(), level.end(), 0);
+    }
+}
+
+densityPyramid::density densityPyramid::getDensity(const indexRange& range) const
+{
+    density result;
+
+    const indexRange r = range.getIntersection(indexRange(0, m_dataSize));
+    if (0 == r.count()) {
+        return result;
+    }
+
+    double matchCount      = 0;
+    double differenceCount = 0;
+
+    auto addBucket = [&](const unsigned int level, const unsigned int bucket, const double fraction) {
+        matchCount      += fraction * getCount(level, bucket, category::match);
+        differenceCount += fraction * getCount(level, bucket, category::difference);
+    };
+
+    //level 0 buckets partly inside the range contribute in proportion to their overlap
+    unsigned int first = static_cast<unsigned int>(static_cast<unsigned long long>(r.start) >> m_baseShift);
+    unsigned int last  = static_cast<unsigned int>(static_cast<unsigned long long>(r.end)   >> m_baseShift);
+
+    auto addPartialBucket = [&](const unsigned int bucket) {
+        const indexRange bucketRange = getBucketRange(0, bucket);
+        addBucket(0, bucket, static_cast<double>(r.getIntersection(bucketRange).count()) / bucketRange.count());
+    };
+
+    if (first == last) {
+        addPartialBucket(first);
+    }
+    else {
+        if (getBucketRange(0, first).start != r.start) {
+            addPartialBucket(first++);
+        }
+        if (last < getBucketCount(0) && getBucketRange(0, last).start != r.end) {
+            addPartialBucket(last);
+        }
+
+        //whole buckets [first, last): at most two per level
+        // (a bucket whose pair is also inside the range is counted by their parent at the next level)
+        for (unsigned int level = 0; first < last; ++level) {
+            if (first & 1) {
+                addBucket(level, first++, 1);
+            }
+            if (last & 1) {
+                addBucket(level, --last, 1);
+            }
+            first >>= 1;
+            last  >>= 1;
+        }
+    }
+
+    result.match      = matchCount      / r.count();
+    result.difference = differenceCount / r.count();
+    result.unmatched  = std::max(0.0, 1.0 - result.match - result.difference);
+
+    return result;
+}
@@ -0,0 +1,80 @@
+#ifndef DENSITYPYRAMID_H
+#define DENSITYPYRAMID_H
+
+#include <vector>
+
+#include "indexrange.h"
+#include "defensivecoding.h"
+
+/*
+    counts of matching and differing indices in a data set, per bucket of 2^k indices, at every k from a base size up
+     (level 0 buckets hold 2^(base shift) indices, each higher level's buckets hold two buckets of the level below,
+      and the top level has a single bucket for the whole data set)
+
+    indices that are neither matching nor differing are unmatched
+
+    a density query reads at most two buckets per level (whole buckets are summed at the coarsest level that covers them),
+     so it takes logarithmic time, regardless of the range size
+     (an overview of the whole data set is drawn in time proportional to its pixel count)
+
+    ranges can be added in any order
+*/
+
+class densityPyramid
+{
+public:
+    enum class category
+    {
+        match,
+        difference
+    };
+
+    class density {
+    public:
+        double match;       //the fraction of indices in each category
+        double difference;
+        double unmatched;
+
+        density() : match(0), difference(0), unmatched(0) {}
+    };
+
+    //level 0 has at most this many buckets (the base bucket size is the smallest power of 2 that allows this)
+    static const unsigned int DEFAULT_MAX_BASE_BUCKET_COUNT = 1 << 16;
+
+    explicit densityPyramid(const unsigned int dataSize = 0,
+                            const unsigned int maxBaseBucketCount = DEFAULT_MAX_BASE_BUCKET_COUNT);
+
+    unsigned int getDataSize() const;
+    unsigned int getLevelCount() const;
+    unsigned long long getBucketSize(const unsigned int level) const;     //indices per bucket (the last bucket of a level may be partial)
+
+    //the number of indices in bucket (at level) that were added as category c
+    unsigned int getCount(const unsigned int level, const unsigned int bucket, const category c) const;
+
+    //counts the indices in range (limited to the data size) as category c
+    // (ranges shouldn't overlap previously added ranges)
+    void add(const indexRange& range, const category c);
+
+    //sets all counts to zero
+    void clear();
+
+    //the fraction of indices in range in each category
+    // (level 0 buckets partly inside range contribute in proportion to their overlap,
+    //  so this is exact when range starts and ends on level 0 bucket boundaries)
+    density getDensity(const indexRange& range) const;
+
+private:
+    static const unsigned int CATEGORY_COUNT = 2;
+
+    unsigned int getBucketCount(const unsigned int level) const;
+
+    //the indices in bucket at level (the last bucket of a level may be partial)
+    indexRange getBucketRange(const unsigned int level, const unsigned int bucket) const;
+
+    unsigned int m_dataSize;
+    unsigned int m_baseShift;   //level 0 buckets hold 2^m_baseShift indices
+
+    std::vector<std::vector<unsigned int>> m_levels;   //m_levels[level][bucket*CATEGORY_COUNT + category]: index count
+};
+
+#endif // DENSITYPYRAMID_H
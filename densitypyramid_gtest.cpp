@@ -0,0 +1,98 @@
+#include <random>
+
+#include "densitypyramid.h"
+#include "gtestDefs.h"
+#include <gtest.h>
+
+TEST(densityPyramid, levels){
+    densityPyramid pyramid(1000, 16);
+
+    //base buckets: the smallest power of 2 giving at most 16 buckets (64 -> 16 buckets)
+    EXPECT_EQ(64u, pyramid.getBucketSize(0));
+    EXPECT_EQ(5u, pyramid.getLevelCount());    //16, 8, 4, 2, 1 buckets
+    EXPECT_EQ(1024u, pyramid.getBucketSize(4));
+
+    densityPyramid empty;
+    EXPECT_EQ(1u, empty.getLevelCount());
+    EXPECT_EQ(0.0, empty.getDensity(indexRange(0,100)).match);
+}
+
+TEST(densityPyramid, countsAtEveryLevel){
+    densityPyramid pyramid(1000, 16);
+    pyramid.add(indexRange(  0, 100), densityPyramid::category::match);
+    pyramid.add(indexRange(100, 130), densityPyramid::category::difference);
+    pyramid.add(indexRange(990,2000), densityPyramid::category::match);    //limited to the data size
+
+    EXPECT_EQ(64u, pyramid.getCount(0, 0, densityPyramid::category::match));
+    EXPECT_EQ(36u, pyramid.getCount(0, 1, densityPyramid::category::match));
+    EXPECT_EQ(28u, pyramid.getCount(0, 1, densityPyramid::category::difference));
+    EXPECT_EQ( 2u, pyramid.getCount(0, 2, densityPyramid::category::difference));
+    EXPECT_EQ(10u, pyramid.getCount(0,15, densityPyramid::category::match));
+
+    EXPECT_EQ(100u, pyramid.getCount(1, 0, densityPyramid::category::match));
+    EXPECT_EQ(110u, pyramid.getCount(4, 0, densityPyramid::category::match));
+    EXPECT_EQ( 30u, pyramid.getCount(4, 0, densityPyramid::category::difference));
+
+    pyramid.clear();
+    EXPECT_EQ(0u, pyramid.getCount(4, 0, densityPyramid::category::match));
+}
+
+TEST(densityPyramid, getDensity){
+    const unsigned int dataSize = 100000;
+
+    //random non-overlapping ranges, added in random order
+    std::mt19937 generator(1);
+    std::vector<std::pair<indexRange, densityPyramid::category>> ranges;
+    for (unsigned int start = 0; start < dataSize; ) {
+        const unsigned int end = std::min(dataSize, start + 1 + static_cast<unsigned int>(generator() % 2000));
+        const unsigned int kind = generator() % 3;
+        if (kind < 2) {
+            const auto c = (0 == kind) ? densityPyramid::category::match : densityPyramid::category::difference;
+            ranges.push_back(std::make_pair(indexRange(start, end), c));
+        }
+        start = end;
+    }
+    std::shuffle(ranges.begin(), ranges.end(), generator);
+
+    densityPyramid pyramid(dataSize, 256);
+    for (const auto& r : ranges) {
+        pyramid.add(r.first, r.second);
+    }
+
+    //exact counts
+    auto expectedDensity = [&](const indexRange& query) {
+        densityPyramid::density d;
+        for (const auto& r : ranges) {
+            const double count = r.first.getIntersection(query).count();
+            (densityPyramid::category::match == r.second ? d.match : d.difference) += count / query.count();
+        }
+        d.unmatched = 1.0 - d.match - d.difference;
+        return d;
+    };
+
+    //aligned to level 0 buckets: exact
+    const unsigned int bucketSize = static_cast<unsigned int>(pyramid.getBucketSize(0));
+    for (const indexRange& query : { indexRange(0, dataSize),
+                                     indexRange(bucketSize, 9*bucketSize),
+                                     indexRange(64*bucketSize, 128*bucketSize) }) {
+
+        const densityPyramid::density expected = expectedDensity(query);
+        const densityPyramid::density actual   = pyramid.getDensity(query);
+        EXPECT_NEAR(expected.match,      actual.match,      1e-9);
+        EXPECT_NEAR(expected.difference, actual.difference, 1e-9);
+        EXPECT_NEAR(expected.unmatched,  actual.unmatched,  1e-9);
+    }
+
+    //unaligned: an estimate, off by at most the partial level 0 buckets at each end
+    for (unsigned int k = 0; k < 200; ++k) {
+        const unsigned int start = generator() % dataSize;
+        const unsigned int count = 1 + generator() % (dataSize - start);
+        const indexRange query(start, start + count);
+
+        const densityPyramid::density expected = expectedDensity(query);
+        const densityPyramid::density actual   = pyramid.getDensity(query);
+        EXPECT_NEAR(expected.match,      actual.match,      2.0 * bucketSize / count);
+        EXPECT_NEAR(expected.difference, actual.difference, 2.0 * bucketSize / count);
+        EXPECT_GE(actual.unmatched, 0.0);
+    }
+}
@@ -0,0 +1,402 @@
+#include "diagonalmatchindex.h"
+#include "utilities.h"
+
+#include <cstring>
+
+namespace {
+
+    inline unsigned int popCount64(unsigned long long x)
+    {
+#if defined(__GNUC__)
+        return static_cast<unsigned int>(__builtin_popcountll(x));
+#else
+        unsigned int count = 0;
+        for ( ; x; x &= x - 1) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    //index of the highest set bit (x must be nonzero)
+    inline unsigned int highestSetBit64(unsigned long long x)
+    {
+#if defined(__GNUC__)
+        return 63 - static_cast<unsigned int>(__builtin_clzll(x));
+#else
+        unsigned int index = 0;
+        while (x >>= 1) {
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    //index of the lowest set bit (x must be nonzero)
+    inline unsigned int lowestSetBit64(unsigned long long x)
+    {
+#if defined(__GNUC__)
+        return static_cast<unsigned int>(__builtin_ctzll(x));
+#else
+        unsigned int index = 0;
+        while (!(x & 1)) {
+            x >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    //the bits below bitCount (bitCount < 64)
+    inline unsigned long long lowBits64(const unsigned int bitCount)
+    {
+        return (1ULL << bitCount) - 1;
+    }
+
+    //match bits for 8 index pairs: bit k is set iff a[k] == b[k]
+    inline unsigned int matchBits8(const unsigned char* a, const unsigned char* b)
+    {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        unsigned long long x;
+        unsigned long long y;
+        std::memcpy(&x, a, 8);
+        std::memcpy(&y, b, 8);
+
+        //matching bytes are zero bytes in x ^ y
+        const unsigned long long diff = x ^ y;
+        const unsigned long long low7 = 0x7F7F7F7F7F7F7F7FULL;
+
+        //the high bit of each byte is set iff that byte of diff is zero
+        const unsigned long long zeroBytes = ~(((diff & low7) + low7) | diff | low7);
+
+        //gather the high bits: byte k -> bit k
+        return static_cast<unsigned int>(((zeroBytes >> 7) * 0x0102040810204080ULL) >> 56);
+#else
+        unsigned int bits = 0;
+        for (unsigned int k = 0; k < 8; ++k) {
+            if (a[k] == b[k]) {
+                bits |= 1u << k;
+            }
+        }
+        return bits;
+#endif
+    }
+
+    //alignment range size queries track (2 * matches - compared index pairs), the "balance":
+    // an alignment range ends when the balance drops below zero.
+    //for each 8 bit group of match bits: the balance change, and the lowest balance reached within the group
+    struct walkStep {
+        int delta;
+        int minPrefix;
+    };
+
+    const std::vector<walkStep>& walkTable()
+    {
+        static const std::vector<walkStep> table = []() {
+
+            std::vector<walkStep> t(256);
+            for (unsigned int bits = 0; bits < 256; ++bits) {
+
+                int balance = 0;
+                int lowest = 0;
+                for (unsigned int k = 0; k < 8; ++k) {
+                    balance += ((bits >> k) & 1) ? 1 : -1;
+                    lowest = std::min(lowest, balance);
+                }
+                t[bits].delta = balance;
+                t[bits].minPrefix = lowest;
+            }
+            return t;
+        } ();
+
+        return table;
+    }
+}
+
+diagonalMatchIndex::diagonalMatchIndex( const byteSpan& source,
+                                        const byteSpan& target,
+                                        const long long diagonal )
+    :   m_source(source),
+        m_target(target),
+        m_diagonal(diagonal),
+        m_sourceRange(
+            [&]() -> indexRange {
+                //source indices i with a target index i + diagonal
+                ASSERT_LE_UINT_MAX(source.size());
+                ASSERT_LE_UINT_MAX(target.size());
+                const long long start = std::max(0LL, -diagonal);
+                const long long end   = std::min( static_cast<long long>(source.size()),
+                                                  static_cast<long long>(target.size()) - diagonal );
+                if (end <= start) {
+                    return indexRange(0,0);
+                }
+                return indexRange(static_cast<unsigned int>(start), static_cast<unsigned int>(end));
+            } ()),
+        m_firstWord(0),
+        m_words(),
+        m_prefixCounts(1, 0)
+{
+}
+
+long long diagonalMatchIndex::getDiagonal() const
+{
+    return m_diagonal;
+}
+
+indexRange diagonalMatchIndex::getSourceRange() const
+{
+    return m_sourceRange;
+}
+
+bool diagonalMatchIndex::isMatch(const unsigned int sourceIndex)
+{
+    if (!m_sourceRange.contains(sourceIndex)) {
+        return false;
+    }
+
+    const unsigned int bit = sourceIndex - m_sourceRange.start;
+    return (getWord(bit/64) >> (bit%64)) & 1;
+}
+
+unsigned int diagonalMatchIndex::countMatches(const unsigned int sourceStart, const unsigned int count)
+{
+    const indexRange countRange = m_sourceRange.getIntersection(indexRange(sourceStart, utilities::addClampToMax(sourceStart, count)));
+
+    if (0 == countRange.count()) {
+        return 0;
+    }
+
+    //bit range in the bitmap
+    const unsigned int bitStart = countRange.start - m_sourceRange.start;
+    const unsigned int bitEnd   = countRange.end   - m_sourceRange.start;
+
+    //matches before bitStart and bitEnd, from the start of the first stored word
+    auto matchesBefore = [this](const unsigned int bit) -> unsigned int {
+
+        unsigned int matches = getPrefixCount(bit/64);
+        if (bit%64) {
+            matches += popCount64(getWord(bit/64) & lowBits64(bit%64));
+        }
+        return matches;
+    };
+
+    const unsigned int before = matchesBefore(bitStart);
+    return matchesBefore(bitEnd) - before;
+}
+
+unsigned int diagonalMatchIndex::findNext(const unsigned int sourceStart, const unsigned int sourceEnd, const bool match)
+{
+    const indexRange searchRange = m_sourceRange.getIntersection(indexRange(sourceStart, std::max(sourceStart, sourceEnd)));
+
+    if (0 == searchRange.count()) {
+        return std::max(sourceStart, std::min(sourceEnd, m_sourceRange.end));
+    }
+
+    const unsigned int bitEnd = searchRange.end - m_sourceRange.start;
+    unsigned int bit = searchRange.start - m_sourceRange.start;
+
+    while (bit < bitEnd) {
+
+        //the bits still to be searched in this word, set where isMatch() == match
+        unsigned long long candidates = getWord(bit/64) >> (bit%64);
+        if (!match) {
+            candidates = ~candidates;
+        }
+        if (bit%64) {
+            candidates &= lowBits64(64 - bit%64);
+        }
+
+        if (candidates) {
+            const unsigned int found = bit + lowestSetBit64(candidates);
+            return m_sourceRange.start + std::min(found, bitEnd);
+        }
+
+        bit += 64 - bit%64;
+    }
+
+    return searchRange.end;
+}
+
+unsigned int diagonalMatchIndex::getAlignmentRangeSize(const unsigned int sourceStart, const unsigned int searchLimit)
+{
+    ASSERT(m_sourceRange.contains(sourceStart));
+    if (!m_sourceRange.contains(sourceStart)) {
+        return 0;
+    }
+
+    const std::vector<walkStep>& table = walkTable();
+
+    const unsigned int startBit = sourceStart - m_sourceRange.start;
+    const unsigned int endBit   = startBit + std::min(searchLimit, m_sourceRange.end - sourceStart);
+
+    if (startBit == endBit) {
+        return 0;
+    }
+
+    //most start indices don't have an alignment range: a leading non-match ends the search immediately
+    if ( !((getWord(startBit/64) >> (startBit%64)) & 1) ) {
+        return 0;
+    }
+
+    long long balance = 0;      //2 * matches - compared index pairs
+    unsigned int rangeSize = 0; //the result: index pairs compared up to and including the last match
+
+    unsigned int bit = startBit;
+    while (bit < endBit) {
+
+        const unsigned long long word = getWord(bit/64);
+        const unsigned int bitInWord = bit%64;
+
+        //whole word: the balance can't drop below zero in 64 steps
+        if (0 == bitInWord && 64 <= endBit - bit && 64 <= balance) {
+
+            balance += 2*static_cast<long long>(popCount64(word)) - 64;
+            if (word) {
+                rangeSize = bit - startBit + highestSetBit64(word) + 1;
+            }
+            bit += 64;
+            continue;
+        }
+
+        //8 bit group: use the walk table to see if the balance drops below zero in it
+        if (0 == bitInWord%8 && 8 <= endBit - bit) {
+
+            const unsigned int bits = static_cast<unsigned int>(word >> bitInWord) & 0xFF;
+            const walkStep& step = table[bits];
+
+            if (0 <= balance + step.minPrefix) {
+
+                balance += step.delta;
+                if (bits) {
+                    rangeSize = bit - startBit + highestSetBit64(bits) + 1;
+                }
+                bit += 8;
+                continue;
+            }
+        }
+
+        //single bit
+        if ((word >> bitInWord) & 1) {
+            ++balance;
+            rangeSize = bit - startBit + 1;
+        }
+        else {
+            --balance;
+
+            //if the match ratio just dropped below 50%, the range has ended (or never started)
+            if (balance < 0) {
+                break;
+            }
+        }
+        ++bit;
+    }
+
+    return rangeSize;
+}
+
+void diagonalMatchIndex::releaseBefore(const unsigned int sourceIndex)
+{
+    if (sourceIndex <= m_sourceRange.start) {
+        return;
+    }
+
+    const unsigned int word = (sourceIndex - m_sourceRange.start)/64;
+
+    //release in large steps, so erasing from the front of the vectors stays cheap
+    const unsigned int releaseStep = 1024;
+    if (word < m_firstWord + releaseStep) {
+        return;
+    }
+
+    const unsigned int releaseCount = std::min( static_cast<unsigned int>(m_words.size()), word - m_firstWord );
+
+    m_words.erase(m_words.begin(), m_words.begin() + releaseCount);
+    m_prefixCounts.erase(m_prefixCounts.begin(), m_prefixCounts.begin() + releaseCount);
+    m_firstWord += releaseCount;
+}
+
+unsigned long long diagonalMatchIndex::getWord(const unsigned int word)
+{
+    buildTo(word);
+    return m_words[word - m_firstWord];
+}
+
+unsigned int diagonalMatchIndex::getPrefixCount(const unsigned int word)
+{
+    //the count before a word is available once the previous word is built
+    if (word <= m_firstWord) {
+        buildTo(word);
+    } else {
+        buildTo(word - 1);
+    }
+    return m_prefixCounts[word - m_firstWord];
+}
+
+void diagonalMatchIndex::buildTo(const unsigned int word)
+{
+    if (m_words.empty()) {
+        //nothing built yet: start from here
+        // (the words before it are only built if a later query needs them)
+        m_firstWord = word;
+        m_prefixCounts.assign(1, 0);
+    }
+    else if (word < m_firstWord) {
+        //words before the stored words (not built yet, or released): prepend them
+        std::vector<unsigned long long> words;
+        for (unsigned int w = word; w < m_firstWord; ++w) {
+            words.push_back(buildWord(w));
+        }
+
+        //prefix counts of the new words, counting back from the old first word
+        std::vector<unsigned int> prefixCounts(words.size());
+        unsigned int prefixCount = m_prefixCounts.front();
+        for (size_t k = words.size(); k-- > 0; ) {
+            prefixCount -= popCount64(words[k]);
+            prefixCounts[k] = prefixCount;
+        }
+
+        m_words.insert(m_words.begin(), words.begin(), words.end());
+        m_prefixCounts.insert(m_prefixCounts.begin(), prefixCounts.begin(), prefixCounts.end());
+        m_firstWord = word;
+    }
+
+    while (m_firstWord + m_words.size() <= word) {
+
+        const unsigned int nextWord = m_firstWord + static_cast<unsigned int>(m_words.size());
+        const unsigned long long bits = buildWord(nextWord);
+
+        m_words.push_back(bits);
+        m_prefixCounts.push_back(m_prefixCounts.back() + popCount64(bits));
+    }
+}
+
+unsigned long long diagonalMatchIndex::buildWord(const unsigned int word) const
+{
+    ASSERT(noSumOverflow(m_sourceRange.start, word*64));
+    const unsigned int sourceIndex = m_sourceRange.start + word*64;
+
+    unsigned long long bits = 0;
+
+    if (m_sourceRange.contains(sourceIndex)) {
+
+        const unsigned char* s = m_source.data() + sourceIndex;
+        const unsigned char* t = m_target.data() + (sourceIndex + m_diagonal);
+        const unsigned int count = std::min(64u, m_sourceRange.end - sourceIndex);
+
+        if (64 == count) {
+            for (unsigned int k = 0; k < 8; ++k) {
+                bits |= static_cast<unsigned long long>(matchBits8(s + 8*k, t + 8*k)) << (8*k);
+            }
+        }
+        else {
+            //partial word at the end of the diagonal: bits past the end stay 0
+            for (unsigned int k = 0; k < count; ++k) {
+                if (s[k] == t[k]) {
+                    bits |= 1ULL << k;
+                }
+            }
+        }
+    }
+
+    return bits;
+}
@@ -0,0 +1,77 @@
+#ifndef DIAGONALMATCHINDEX_H
+#define DIAGONALMATCHINDEX_H
+
+#include <vector>
+
+#include "indexrange.h"
+#include "bytespan.h"
+#include "defensivecoding.h"
+
+/*
+    match bitmap for one alignment diagonal between two data sets
+    (diagonal: target index - source index)
+
+    bit n of the bitmap is set iff source[i] == target[i + diagonal], for source index i = (first source index on the diagonal) + n
+
+    the bitmap is built on demand, 64 bytes (one bitmap word) at a time, as queries reach further along the diagonal,
+     and the match count before each bitmap word is recorded (prefix sums), so:
+        match counts for any range on the diagonal take constant time
+        alignment range size queries step through the bitmap 8 or 64 bytes at a time,
+         and repeated queries from nearby start indices don't compare any bytes again
+*/
+
+class diagonalMatchIndex
+{
+public:
+    diagonalMatchIndex( const byteSpan& source,
+                        const byteSpan& target,
+                        const long long diagonal );
+
+    long long getDiagonal() const;
+
+    //the source indices that are on this diagonal (i.e., that have a paired target index)
+    indexRange getSourceRange() const;
+
+    //true iff source[sourceIndex] == target[sourceIndex + diagonal]
+    bool isMatch(const unsigned int sourceIndex);
+
+    //the number of matching index pairs in [sourceStart, sourceStart + count) on this diagonal
+    // (the range is limited to getSourceRange())
+    unsigned int countMatches(const unsigned int sourceStart, const unsigned int count);
+
+    //the first source index in [sourceStart, sourceEnd) where isMatch() == match, or sourceEnd if there isn't one
+    // (sourceEnd is limited to getSourceRange())
+    unsigned int findNext(const unsigned int sourceStart, const unsigned int sourceEnd, const bool match);
+
+    //returns the size of the alignment range starting at sourceStart on this diagonal, extending at most searchLimit bytes:
+    // same definition and result as offsetMetrics::getAlignmentRangeSizeAtIndices
+    unsigned int getAlignmentRangeSize(const unsigned int sourceStart, const unsigned int searchLimit);
+
+    //allows bitmap storage before sourceIndex to be released
+    // (later queries there still work, but the bitmap is rebuilt from that point)
+    void releaseBefore(const unsigned int sourceIndex);
+
+private:
+    unsigned long long getWord(const unsigned int word);
+    unsigned int getPrefixCount(const unsigned int word);
+
+    //builds bitmap words until m_words includes word
+    // (starting from word itself if no words are stored yet; words before the stored words are prepended)
+    void buildTo(const unsigned int word);
+
+    //compares the index pairs of one bitmap word
+    unsigned long long buildWord(const unsigned int word) const;
+
+    const byteSpan m_source;
+    const byteSpan m_target;
+    const long long m_diagonal;
+    const indexRange m_sourceRange;
+
+    unsigned int m_firstWord;                   //the bitmap word index of m_words[0] (earlier words may not be built, or may be released)
+    std::vector<unsigned long long> m_words;    //the match bitmap, 64 index pairs per word (lowest bit first)
+    std::vector<unsigned int> m_prefixCounts;   //m_prefixCounts[w]: match count before m_words[w], relative to an arbitrary base
+                                                // (only differences are meaningful: prepending words moves the base below zero,
+                                                //  which wraps around, but differences are still correct)
+};
+
+#endif // DIAGONALMATCHINDEX_H
@@ -0,0 +1,176 @@
+#include <random>
+
+#include "diagonalmatchindex.h"
+#include "diagonalmatchindexcache.h"
+#include "utilities.h"
+#include "gtestDefs.h"
+#include <gtest.h>
+
+namespace {
+
+    //byte-by-byte alignment range size (the definition used by offsetMetrics)
+    unsigned int alignmentRangeSize(const std::vector<unsigned char>& source,
+                                    const std::vector<unsigned char>& target,
+                                    const unsigned int sourceStart,
+                                    const unsigned int targetStart,
+                                    const unsigned int searchLimit)
+    {
+        unsigned int rangeSize = 0;
+        unsigned int matchCount = 0;
+        for (unsigned int i = 0; i < searchLimit; ++i) {
+            if (source[sourceStart + i] == target[targetStart + i]) {
+                rangeSize = i + 1;
+                ++matchCount;
+            }
+            else if (matchCount*2 < i + 1) {
+                break;
+            }
+        }
+        return rangeSize;
+    }
+}
+
+TEST(diagonalMatchIndex, sourceRange){
+    std::vector<unsigned char> source(100);
+    std::vector<unsigned char> target(50);
+
+    EXPECT_EQ(indexRange( 0, 50), diagonalMatchIndex(source, target,   0).getSourceRange());
+    EXPECT_EQ(indexRange( 0, 40), diagonalMatchIndex(source, target,  10).getSourceRange());
+    EXPECT_EQ(indexRange(10, 60), diagonalMatchIndex(source, target, -10).getSourceRange());
+    EXPECT_EQ(indexRange( 0,  0), diagonalMatchIndex(source, target,  50).getSourceRange());
+    EXPECT_EQ(indexRange( 0,  0), diagonalMatchIndex(source, target,-100).getSourceRange());
+}
+
+TEST(diagonalMatchIndex, isMatch){
+    std::vector<unsigned char> source = gtestDefs::makeTestData(300, 1, 2);
+    std::vector<unsigned char> target = gtestDefs::makeTestData(300, 2, 2);
+
+    for (long long diagonal : {-7LL, 0LL, 13LL}) {
+        diagonalMatchIndex index(source, target, diagonal);
+        const indexRange range = index.getSourceRange();
+
+        for (unsigned int i = range.start; i < range.end; ++i) {
+            EXPECT_EQ(source[i] == target[i + diagonal], index.isMatch(i)) << "diagonal " << diagonal << ", index " << i;
+        }
+        EXPECT_FALSE(index.isMatch(range.end));
+    }
+}
+
+TEST(diagonalMatchIndex, countMatches){
+    std::vector<unsigned char> source = gtestDefs::makeTestData(1000, 3, 3);
+    std::vector<unsigned char> target = gtestDefs::makeTestData( 900, 4, 3);
+
+    for (long long diagonal : {-70LL, 0LL, 65LL}) {
+        diagonalMatchIndex index(source, target, diagonal);
+        const indexRange range = index.getSourceRange();
+
+        for (unsigned int start = range.start; start < range.end; start += 37) {
+            for (unsigned int count : {0u, 1u, 63u, 64u, 65u, 200u, 1000u}) {
+
+                const unsigned int clampedCount = std::min(count, range.end - start);
+                const unsigned int expected = utilities::countMatchingIndices(
+                                                    source, target,
+                                                    indexRange(start, start + clampedCount),
+                                                    indexRange(static_cast<unsigned int>(start + diagonal),
+                                                               static_cast<unsigned int>(start + diagonal + clampedCount)));
+
+                EXPECT_EQ(expected, index.countMatches(start, count)) << "diagonal " << diagonal << ", start " << start << ", count " << count;
+            }
+        }
+    }
+}
+
+TEST(diagonalMatchIndex, findNext){
+    std::vector<unsigned char> source = gtestDefs::makeTestData(700, 9, 2);
+    std::vector<unsigned char> target = source;
+    //a long difference run, and a long match run
+    for (unsigned int i = 100; i < 300; ++i) {
+        target[i] ^= 1;
+    }
+
+    diagonalMatchIndex index(source, target, 0);
+
+    for (unsigned int start = 0; start < 700; start += 11) {
+        for (unsigned int end : {start, start + 1, start + 70, 700u, 1000u}) {
+            for (bool match : {true, false}) {
+
+                unsigned int expected = start;
+                while (expected < std::min(end, 700u) && index.isMatch(expected) != match) {
+                    ++expected;
+                }
+                EXPECT_EQ(std::max(start, std::min(expected, end)), index.findNext(start, end, match))
+                        << "start " << start << ", end " << end << ", match " << match;
+            }
+        }
+    }
+}
+
+TEST(diagonalMatchIndex, getAlignmentRangeSize){
+    //long matching runs with scattered differences, and short random runs
+    std::vector<unsigned char> source = gtestDefs::makeTestData(5000, 5, 2);
+    std::vector<unsigned char> target = source;
+    std::mt19937 generator(6);
+    for (unsigned int i = 0; i < 300; ++i) {
+        target[generator() % target.size()] ^= 1;
+    }
+
+    for (long long diagonal : {0LL, 1LL, -3LL}) {
+        diagonalMatchIndex index(source, target, diagonal);
+        const indexRange range = index.getSourceRange();
+
+        for (unsigned int start = range.start; start < range.end; start += 7) {
+            for (unsigned int searchLimit : {1u, 9u, 100u, range.end - start}) {
+
+                const unsigned int limit = std::min(searchLimit, range.end - start);
+                EXPECT_EQ(  alignmentRangeSize(source, target, start, static_cast<unsigned int>(start + diagonal), limit),
+                            index.getAlignmentRangeSize(start, searchLimit)  )
+                        << "diagonal " << diagonal << ", start " << start << ", limit " << searchLimit;
+            }
+        }
+    }
+}
+
+TEST(diagonalMatchIndex, releaseBefore){
+    std::vector<unsigned char> source = gtestDefs::makeTestData(200000, 7, 2);
+    std::vector<unsigned char> target = gtestDefs::makeTestData(200000, 8, 2);
+
+    diagonalMatchIndex index(source, target, 5);
+    const unsigned int before = index.countMatches(1000, 100000);
+
+    //queries before the released part rebuild it
+    index.releaseBefore(150000);
+    EXPECT_EQ(before, index.countMatches(1000, 100000));
+    EXPECT_EQ(source[1234] == target[1239], index.isMatch(1234));
+}
+
+TEST(diagonalMatchIndex, queriesBeforeBuiltWords){
+    std::vector<unsigned char> source = gtestDefs::makeTestData(20000, 10, 3);
+    std::vector<unsigned char> target = gtestDefs::makeTestData(20000, 11, 3);
+
+    //queries moving backward: words are prepended to the bitmap
+    diagonalMatchIndex index(source, target, -2);
+    for (unsigned int start = 19000; start >= 1000; start -= 1000) {
+
+        const unsigned int expected = utilities::countMatchingIndices(  source, target,
+                                                                        indexRange(start, start + 500),
+                                                                        indexRange(start - 2, start + 498));
+        EXPECT_EQ(expected, index.countMatches(start, 500)) << "start " << start;
+    }
+}
+
+TEST(diagonalMatchIndexCache, leastRecentlyUsed){
+    std::vector<unsigned char> source(100);
+    std::vector<unsigned char> target(100);
+
+    diagonalMatchIndexCache cache(source, target, 2);
+
+    diagonalMatchIndex* first = &cache.get(1);
+    cache.get(2);
+    EXPECT_EQ(first, &cache.get(1));   //cached: 1 is now the most recently used
+    cache.get(3);                       //discards 2
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_EQ(first, &cache.get(1));
+    EXPECT_EQ(3, cache.get(3).getDiagonal());
+    EXPECT_EQ(2, cache.get(2).getDiagonal());
+    EXPECT_EQ(2u, cache.size());
+}
@@ -0,0 +1,44 @@
+#include "diagonalmatchindexcache.h"
+
+diagonalMatchIndexCache::diagonalMatchIndexCache(   const byteSpan& source,
+                                                    const byteSpan& target,
+                                                    const unsigned int capacity )
+    :   m_source(source),
+        m_target(target),
+        m_capacity(std::max(1u, capacity)),
+        m_indices(),
+        m_indicesByDiagonal()
+{
+}
+
+diagonalMatchIndex& diagonalMatchIndexCache::get(const long long diagonal)
+{
+    auto found = m_indicesByDiagonal.find(diagonal);
+
+    if (found != m_indicesByDiagonal.end()) {
+        //move to the front of the list (most recently used)
+        m_indices.splice(m_indices.begin(), m_indices, found->second);
+        return *m_indices.front();
+    }
+
+    if (m_indices.size() >= m_capacity) {
+        //discard the least recently used
+        m_indicesByDiagonal.erase(m_indices.back()->getDiagonal());
+        m_indices.pop_back();
+    }
+
+    m_indices.emplace_front(new diagonalMatchIndex(m_source, m_target, diagonal));
+    m_indicesByDiagonal[diagonal] = m_indices.begin();
+
+    return *m_indices.front();
+}
+
+unsigned int diagonalMatchIndexCache::getCapacity() const
+{
+    return m_capacity;
+}
+
+unsigned int diagonalMatchIndexCache::size() const
+{
+    return static_cast<unsigned int>(m_indices.size());
+}
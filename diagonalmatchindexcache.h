@@ -0,0 +1,46 @@
+#ifndef DIAGONALMATCHINDEXCACHE_H
+#define DIAGONALMATCHINDEXCACHE_H
+
+#include <vector>
+#include <memory>
+#include <list>
+#include <unordered_map>
+
+#include "diagonalmatchindex.h"
+#include "defensivecoding.h"
+
+/*
+    the diagonalMatchIndex instances for the most recently used diagonals between two data sets
+
+    match count queries for index ranges on the same diagonal (which the alignment range search and
+     its truncation tests make many of) are answered from the diagonal's prefix sums,
+     so the bytes are only compared once while the diagonal stays in the cache
+
+    when the cache is full, the least recently used diagonal is discarded
+*/
+
+class diagonalMatchIndexCache
+{
+public:
+    diagonalMatchIndexCache(const byteSpan& source,
+                            const byteSpan& target,
+                            const unsigned int capacity );
+
+    //returns the index for this diagonal (target index - source index), creating it if it isn't cached:
+    // the reference is valid until capacity other diagonals have been requested
+    diagonalMatchIndex& get(const long long diagonal);
+
+    unsigned int getCapacity() const;
+    unsigned int size() const;
+
+private:
+    const byteSpan m_source;
+    const byteSpan m_target;
+    const unsigned int m_capacity;
+
+    //most recently used first
+    std::list<std::unique_ptr<diagonalMatchIndex>> m_indices;
+    std::unordered_map<long long, std::list<std::unique_ptr<diagonalMatchIndex>>::iterator> m_indicesByDiagonal;
+};
+
+#endif // DIAGONALMATCHINDEXCACHE_H
@@ -0,0 +1,108 @@
+#include "fileloaderthread.h"
+
+fileLoaderThread::fileLoaderThread(QObject* parent/*= nullptr*/)
+  : QThread (parent),
+    m_mutex(),
+    m_abort(false),
+    m_fileName(),
+    m_windows(),
+    m_hasResult(false),
+    m_result(dataSet::loadFileResult::SUCCESS),
+    m_data(nullptr)
+{
+}
+
+fileLoaderThread::~fileLoaderThread()
+{
+    abort();
+    wait(); //returns when run() is not running
+}
+
+bool fileLoaderThread::startThread(const QString fileName, const std::vector<dataSet::fileWindow>& windows /*= std::vector<dataSet::fileWindow>()*/)
+{
+    QMutexLocker lock(&m_mutex);
+
+    if (isRunning()) {
+        return false;
+    }
+
+    m_fileName = fileName;
+    m_windows = windows;
+    m_abort = false;
+    m_hasResult = false;
+    m_data = nullptr;
+
+    start();
+
+    return true;
+}
+
+void fileLoaderThread::abort()
+{
+    m_abort = true;
+}
+
+bool fileLoaderThread::isLoading()
+{
+    QMutexLocker lock(&m_mutex);
+
+    //(the result is stored at the end of run(), so there's no gap between the two)
+    return isRunning() || m_hasResult;
+}
+
+bool fileLoaderThread::getResult(   QString& fileName,
+                                    std::vector<dataSet::fileWindow>& windows,
+                                    dataSet::loadFileResult& res,
+                                    std::unique_ptr<std::vector<unsigned char>>& data )
+{
+    QMutexLocker lock(&m_mutex);
+
+    //(the result is complete once it's stored: the finished signal can be handled before isFinished() is true)
+    if (!m_hasResult) {
+        return false;
+    }
+
+    fileName = m_fileName;
+    windows = m_windows;
+    res = m_result;
+    data = std::move(m_data);
+    m_hasResult = false;
+
+    return true;
+}
+
+void fileLoaderThread::run()
+{
+    //m_mutex isn't held while reading, so startThread/getResult calls from the GUI thread don't wait for the read
+    QString fileName;
+    std::vector<dataSet::fileWindow> windows;
+    {
+        QMutexLocker lock(&m_mutex);
+        fileName = m_fileName;
+        windows = m_windows;
+    }
+
+    std::unique_ptr<std::vector<unsigned char>> data(new std::vector<unsigned char>());
+
+    unsigned int lastPercent = 0;
+    emit progress(lastPercent);
+
+    const dataSet::loadFileResult res =
+            dataSet::readFile(fileName, windows, *data,
+                              [this]() {
+                                  return m_abort.load();
+                              },
+                              [this, &lastPercent](unsigned long long bytesRead, unsigned long long fileSize) {
+                                  const unsigned int percent = static_cast<unsigned int>((100*bytesRead)/fileSize);
+                                  if (percent != lastPercent) {
+                                      lastPercent = percent;
+                                      emit progress(percent);
+                                  }
+                              });
+
+    QMutexLocker lock(&m_mutex);
+    m_windows = windows;
+    m_result = res;
+    m_data = std::move(data);
+    m_hasResult = true;
+}
@@ -0,0 +1,71 @@
+#ifndef FILELOADERTHREAD_H
+#define FILELOADERTHREAD_H
+
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+
+#include <vector>
+#include <memory>
+#include <atomic>
+
+#include "dataSet.h"
+
+/*
+    reads a file on a worker thread (in chunks, with progress and cancellation),
+     so the GUI stays responsive while a large file loads
+
+    the read data is published to a dataSet on the GUI thread when the thread finishes
+     (see getResult and dataSet::loadFileData)
+*/
+
+class fileLoaderThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    fileLoaderThread(   QObject* parent = nullptr   );
+    ~fileLoaderThread();
+
+    //returns false if a file is already being read
+    // windows: only read these regions of the file (empty: the whole file)
+    bool startThread(const QString fileName, const std::vector<dataSet::fileWindow>& windows = std::vector<dataSet::fileWindow>());
+    void abort();
+
+    //true from startThread until the result is taken by getResult
+    bool isLoading();
+
+    //moves the result of the finished read to fileName, windows (the regions read), res and data
+    // returns false if there is no result (the thread is running, or the result was already taken)
+    bool getResult( QString& fileName,
+                    std::vector<dataSet::fileWindow>& windows,
+                    dataSet::loadFileResult& res,
+                    std::unique_ptr<std::vector<unsigned char>>& data );
+
+
+signals:
+    void progress(unsigned int percent);    //emitted when the read percentage changes
+
+
+protected:
+    void run() override;
+
+
+private:
+    QMutex m_mutex;
+
+    std::atomic<bool> m_abort;  //checked between chunks (set without locking m_mutex)
+
+    //input
+    QString m_fileName;
+    std::vector<dataSet::fileWindow> m_windows;     //(set to the regions read when the thread finishes)
+
+    //output
+    bool m_hasResult;
+    dataSet::loadFileResult m_result;
+    std::unique_ptr<std::vector<unsigned char>> m_data;
+
+};
+
+#endif // FILELOADERTHREAD_H
@@ -5,9 +5,36 @@
 #include <QString>
 #include <QStringBuilder>
 
+#include <cstdlib>
+#include <random>
+#include <vector>
+
 namespace gtestDefs
 {
     const QString testFilePath = "TestFiles/";
+
+    //pseudorandom bytes (from std::rand, seeded with seed)
+    inline std::vector<unsigned char> randomData(const unsigned int size, const unsigned int seed)
+    {
+        std::srand(seed);
+        std::vector<unsigned char> data(size);
+        for (unsigned char& byte : data) {
+            byte = static_cast<unsigned char>(std::rand());
+        }
+        return data;
+    }
+
+    //pseudorandom bytes from [firstByte, firstByte + alphabetSize) (a small alphabet gives plenty of matches)
+    inline std::vector<unsigned char> makeTestData(const unsigned int size, const unsigned int seed,
+                                                   const unsigned int alphabetSize, const unsigned int firstByte = 0)
+    {
+        std::mt19937 generator(seed);
+        std::vector<unsigned char> data(size);
+        for (unsigned char& c : data) {
+            c = static_cast<unsigned char>(firstByte + generator() % alphabetSize);
+        }
+        return data;
+    }
 }
 
 
@@ -1,9 +1,63 @@
 #include "hexfield.h"
+#include "dataSetView.h"
+
+#include <QPainter>
 
 hexField::hexField(QWidget* parent) :
-    QTextEdit(parent)
+    QFrame(parent),
+    m_displayMode(DisplayMode::ByteGrid),
+    m_dataSetView()
 {
     setAcceptDrops(true);
+    setFrameStyle(QFrame::StyledPanel | QFrame::Sunken);
+
+    //paintEvent fills the whole widget
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void hexField::setDisplayMode(DisplayMode mode)
+{
+    m_displayMode = mode;
+    update();
+}
+
+void hexField::setDataSetView(dataSetView* view)
+{
+    m_dataSetView = view;
+    update();
+}
+
+QRect hexField::getDrawArea() const
+{
+    return contentsRect().adjusted(MARGIN_px, MARGIN_px, -MARGIN_px, -MARGIN_px);
+}
+
+void hexField::paintEvent(QPaintEvent *e)
+{
+    {
+        QPainter painter(this);
+        painter.fillRect(contentsRect(), palette().base());
+        painter.setFont(font());
+
+        if (m_dataSetView) {
+            switch (m_displayMode)
+            {
+                case DisplayMode::ByteGrid:
+                    m_dataSetView->paintByteGrid(painter, getDrawArea(), e->rect());
+                    break;
+
+                case DisplayMode::AddressColumn:
+                    m_dataSetView->paintAddressColumn(painter, getDrawArea(), e->rect());
+                    break;
+
+                default:    //this should never happen
+                    FAIL();
+            }
+        }
+    }
+
+    //draw the frame over the contents
+    QFrame::paintEvent(e);
 }
 
 void hexField::dropEvent(QDropEvent *e)
@@ -15,12 +69,24 @@ void hexField::dropEvent(QDropEvent *e)
         return; //no filename generated
     }
 
-    QString filename = urlList.first().toString();
+    //the dropped items that are files
+    QStringList filenames;
     QString prefix = "file://";
-    if (filename.startsWith(prefix))    //reject dropped items that aren't files
-    {
-        filename.remove(0,prefix.size());
-        emit filenameDropped(filename);
+    for (const QUrl& url : urlList) {
+        QString filename = url.toString();
+        if (filename.startsWith(prefix))    //reject dropped items that aren't files
+        {
+            filename.remove(0,prefix.size());
+            filenames.append(filename);
+        }
+    }
+
+    if (2 <= filenames.size()) {
+        //2 files dropped together: one for each side
+        emit filenamePairDropped(filenames.at(0), filenames.at(1));
+    }
+    else if (1 == filenames.size()) {
+        emit filenameDropped(filenames.first());
     }
 
     e->acceptProposedAction();
@@ -44,19 +110,19 @@ void hexField::dragLeaveEvent(QDragLeaveEvent *e)
 
 void hexField::changeEvent(QEvent *e)
 {
-    QTextEdit::changeEvent(e);
+    QFrame::changeEvent(e);
     emit fontChanged();
 }
 
 void hexField::resizeEvent(QResizeEvent *e)
 {
-    QTextEdit::resizeEvent(e);
+    QFrame::resizeEvent(e);
     emit resized();
 }
 
 void hexField::wheelEvent(QWheelEvent *e)
 {
-    //for some reason, hexfields are still scrolling despite QWheelEvents being filtered
-    //this ignore call prevents the unwanted scrolling
+    //wheel events are redirected to the main scrollbar by an event filter:
+    // ignore any that reach this widget, so they aren't handled twice
     e->ignore();
 }
@@ -3,12 +3,19 @@
 
 #include <QDragEnterEvent>
 #include <QDropEvent>
-#include <QTextEdit>
+#include <QFrame>
 #include <QMimeData>
+#include <QPaintEvent>
+#include <QPointer>
 #include <QString>
+#include <QStringList>
 
 /*
- *  extends QTextEdit to support file drag and drop
+ *  draws the displayed part of a dataSetView (its byte grid or its address column),
+ *  and supports file drag and drop
+ *
+ *  only the visible rows are drawn (by dataSetView, directly from the dataSet's data),
+ *  so scrolling only changes the dataSetView's subset and schedules a repaint
 */
 
 
@@ -19,13 +26,30 @@ class QDragMoveEvent;
 class QDragLeaveEvent;
 QT_END_NAMESPACE
 
-class hexField : public QTextEdit
+class dataSetView;
+
+class hexField : public QFrame
 {
     Q_OBJECT
 
 public:
+    //which part of the dataSetView is drawn
+    enum class DisplayMode
+    {
+        ByteGrid,       //the bytes in the displayed subset (default)
+        AddressColumn   //the start address of each byte grid row
+    };
+
     explicit hexField(QWidget* parent = nullptr);
 
+    void setDisplayMode(DisplayMode mode);
+
+    //sets the dataSetView to draw (nullptr: draw nothing) and schedules a repaint
+    void setDataSetView(dataSetView* view);
+
+    //the area that rows are drawn in (inside the frame and margins)
+    QRect getDrawArea() const;
+
     void dragEnterEvent(QDragEnterEvent *e) Q_DECL_OVERRIDE;
     void dropEvent(QDropEvent *e) Q_DECL_OVERRIDE;
     void dragMoveEvent(QDragMoveEvent *e) Q_DECL_OVERRIDE;
@@ -36,9 +60,18 @@ public:
 
 signals:
     void filenameDropped(QString filename);
+    void filenamePairDropped(QString filename1, QString filename2);     //2 (or more) files dropped together: the first 2
     void fontChanged();
     void resized();
 
+protected:
+    void paintEvent(QPaintEvent *e) Q_DECL_OVERRIDE;
+
+private:
+    static const int MARGIN_px = 4;     //space between the frame and the drawn rows
+
+    DisplayMode m_displayMode;
+    QPointer<dataSetView> m_dataSetView;    //cleared automatically if the dataSetView is deleted
 };
 
 #endif // HEXFIELD_H
@@ -0,0 +1,157 @@
+#include "hexformat.h"
+
+#include <cstring>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*static*/ const unsigned int hexFormat::ADDRESS_LENGTH;
+/*static*/ const unsigned int hexFormat::MAX_ADDRESS_LENGTH;
+
+/*static*/ const char* hexFormat::getDigitPairs(const letterCase letters)
+{
+    static const std::vector<char> upperPairs = []() {
+        std::vector<char> pairs(512);
+        const char digits[] = "0123456789ABCDEF";
+        for (unsigned int value = 0; value < 256; ++value) {
+            pairs[2*value    ] = digits[value >> 4];
+            pairs[2*value + 1] = digits[value & 0x0F];
+        }
+        return pairs;
+    } ();
+
+    static const std::vector<char> lowerPairs = []() {
+        std::vector<char> pairs(512);
+        const char digits[] = "0123456789abcdef";
+        for (unsigned int value = 0; value < 256; ++value) {
+            pairs[2*value    ] = digits[value >> 4];
+            pairs[2*value + 1] = digits[value & 0x0F];
+        }
+        return pairs;
+    } ();
+
+    return (letterCase::upper == letters) ? upperPairs.data() : lowerPairs.data();
+}
+
+/*static*/ unsigned int hexFormat::formatHex(   const unsigned char* data,
+                                                const unsigned int count,
+                                                char* out,
+                                                const letterCase letters /*= letterCase::upper*/ )
+{
+    ASSERT(count <= UINT_MAX/2);
+
+    unsigned int i = 0;
+
+#ifdef __SSE2__
+    //16 bytes at a time: split into nibbles, convert each nibble to its digit, then interleave high and low digits
+    {
+        const __m128i nibbleMask   = _mm_set1_epi8(0x0F);
+        const __m128i nine         = _mm_set1_epi8(9);
+        const __m128i digitZero    = _mm_set1_epi8('0');
+        const __m128i letterOffset = _mm_set1_epi8(static_cast<char>( ((letterCase::upper == letters) ? 'A' : 'a') - '0' - 10 ));
+
+        auto toDigits = [&](const __m128i nibbles) {
+            const __m128i isLetter = _mm_cmpgt_epi8(nibbles, nine);
+            return _mm_add_epi8(_mm_add_epi8(nibbles, digitZero), _mm_and_si128(isLetter, letterOffset));
+        };
+
+        for (; i + 16 <= count; i += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+            const __m128i high = toDigits(_mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask));
+            const __m128i low  = toDigits(_mm_and_si128(bytes, nibbleMask));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2*i     ), _mm_unpacklo_epi8(high, low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2*i + 16), _mm_unpackhi_epi8(high, low));
+        }
+    }
+#endif
+
+    //the rest (or everything, without SSE2): 2 digits per byte from the table
+    const char* digitPairs = getDigitPairs(letters);
+    for (; i < count; ++i) {
+        std::memcpy(out + 2*i, digitPairs + 2*data[i], 2);
+    }
+
+    return 2*count;
+}
+
+/*static*/ unsigned int hexFormat::formatAddress(   const unsigned long long address,
+                                                    const unsigned int digitCount,
+                                                    char* out,
+                                                    const letterCase letters /*= letterCase::lower*/ )
+{
+    ASSERT(0 == digitCount%2 && digitCount <= MAX_ADDRESS_LENGTH - 2);
+
+    //most significant byte first
+    unsigned char bytes[8];
+    const unsigned int byteCount = digitCount/2;
+    for (unsigned int i = 0; i < byteCount; ++i) {
+        bytes[i] = static_cast<unsigned char>(address >> (8*(byteCount - 1 - i)));
+    }
+
+    out[0] = '0';
+    out[1] = 'x';
+    formatHex(bytes, byteCount, out + 2, letters);
+
+    return 2 + digitCount;
+}
+
+/*static*/ unsigned int hexFormat::getAddressDigitCount(const unsigned long long lastAddress)
+{
+    unsigned int digitCount = ADDRESS_LENGTH - 2;
+    while (digitCount < MAX_ADDRESS_LENGTH - 2 && (lastAddress >> (4*digitCount))) {
+        digitCount += 2;
+    }
+    return digitCount;
+}
+
+/*static*/ unsigned int hexFormat::getRowLength(const unsigned int columnCount, const unsigned int addressDigitCount)
+{
+    //address, 2 spaces, 3 characters per column, a space, 1 character per column
+    ASSERT(addressDigitCount <= MAX_ADDRESS_LENGTH - 2);
+    ASSERT(columnCount <= (UINT_MAX - MAX_ADDRESS_LENGTH - 3)/4);
+    return 2 + addressDigitCount + 2 + 3*columnCount + 1 + columnCount;
+}
+
+/*static*/ unsigned int hexFormat::formatRow(   const byteSpan& data,
+                                                const indexRange& range,
+                                                const unsigned int columnCount,
+                                                const unsigned long long address,
+                                                const unsigned int addressDigitCount,
+                                                char* out )
+{
+    ASSERT_LE_UINT_MAX(data.size());
+    const indexRange rowRange = range.getIntersection(indexRange(0, static_cast<unsigned int>(data.size())));
+    const unsigned int count = std::min(rowRange.count(), columnCount);
+
+    char* pos = out;
+    pos += formatAddress(address, addressDigitCount, pos);
+    *pos++ = ' ';
+    *pos++ = ' ';
+
+    //hex digits for the whole row first, then spread them into columns (from the end, so they don't overwrite each other)
+    char* columns = pos;
+    if (count) {
+        formatHex(data.data() + rowRange.start, count, columns);
+    }
+
+    for (unsigned int column = count; column-- > 0; ) {
+        columns[3*column + 2] = ' ';
+        columns[3*column + 1] = columns[2*column + 1];
+        columns[3*column    ] = columns[2*column    ];
+    }
+    std::memset(columns + 3*count, ' ', 3*(columnCount - count));
+    pos += 3*columnCount;
+
+    *pos++ = ' ';
+
+    for (unsigned int i = 0; i < count; ++i) {
+        const unsigned char c = data[rowRange.start + i];
+        *pos++ = (0x20 <= c && c < 0x7F) ? static_cast<char>(c) : '.';
+    }
+
+    return static_cast<unsigned int>(pos - out);
+}
@@ -0,0 +1,71 @@
+#ifndef HEXFORMAT_H
+#define HEXFORMAT_H
+
+#include "indexrange.h"
+#include "bytespan.h"
+#include "defensivecoding.h"
+
+/*
+    formats bytes as hex text into caller-supplied buffers (no allocation per byte or row)
+
+    byte values are converted through a 512-byte table (2 digits for each byte value),
+     or 16 bytes at a time with SSE2 where it's available
+
+    row layout (for text output of the byte grid, see dataSetView::getVisibleRowsText):
+        0x00000010  48 65 6C 6C 6F 2C 20 77 6F 72 6C 64 21 0A 00 00  Hello, world!...
+        (address, 2 spaces, 3 characters per column (missing bytes in a partial row are spaces), a space, then ASCII:
+         printable characters as themselves, others as '.')
+*/
+
+class hexFormat
+{
+public:
+    hexFormat() = delete;   //static functions only
+
+    enum class letterCase
+    {
+        upper,  //"0A"
+        lower   //"0a"
+    };
+
+    //writes 2 hex digits per byte (no separators) to out, which must have room for 2*count characters
+    // returns the number of characters written
+    static unsigned int formatHex(  const unsigned char* data,
+                                    const unsigned int count,
+                                    char* out,
+                                    const letterCase letters = letterCase::upper );
+
+    //writes "0x" and digitCount hex digits (an even number, at most 16) to out, which must have room for 2 + digitCount characters
+    // (for addresses that may not fit in 8 digits, see getAddressDigitCount)
+    // returns 2 + digitCount
+    static unsigned int formatAddress(  const unsigned long long address,
+                                        const unsigned int digitCount,
+                                        char* out,
+                                        const letterCase letters = letterCase::lower );
+
+    //the digits formatAddress needs for addresses up to lastAddress (at least 8)
+    static unsigned int getAddressDigitCount(const unsigned long long lastAddress);
+
+    //writes the row layout for the bytes of data in range (at most columnCount bytes) to out,
+    // with address as its address (addressDigitCount digits, as for formatAddress)
+    // out must have room for getRowLength(columnCount, addressDigitCount) characters
+    // returns the number of characters written
+    static unsigned int formatRow(  const byteSpan& data,
+                                    const indexRange& range,
+                                    const unsigned int columnCount,
+                                    const unsigned long long address,
+                                    const unsigned int addressDigitCount,
+                                    char* out );
+
+    //the longest row formatRow writes for this many columns and address digits
+    static unsigned int getRowLength(const unsigned int columnCount, const unsigned int addressDigitCount);
+
+    static const unsigned int ADDRESS_LENGTH = 10;    //"0x" and 8 digits: the shortest formatAddress output
+    static const unsigned int MAX_ADDRESS_LENGTH = 18;
+
+private:
+    //"000102...FF": the 2 digits of each byte value
+    static const char* getDigitPairs(const letterCase letters);
+};
+
+#endif // HEXFORMAT_H
@@ -0,0 +1,216 @@
+#include "hexformat.h"
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <functional>
+#include "gtestDefs.h"
+#include <gtest.h>
+
+namespace {
+
+std::string referenceHex(const std::vector<unsigned char>& data, const char* byteFormat)
+{
+    std::string ret;
+    char digits[3];
+    for (const unsigned char byte : data) {
+        std::snprintf(digits, sizeof(digits), byteFormat, byte);
+        ret += digits;
+    }
+    return ret;
+}
+
+std::string formatRow(const std::vector<unsigned char>& data, const indexRange& range, const unsigned int columnCount,
+                      const unsigned int addressDigitCount = 8)
+{
+    std::string row(hexFormat::getRowLength(columnCount, addressDigitCount), '#');
+    const unsigned int length = hexFormat::formatRow(data, range, columnCount, range.start, addressDigitCount, &row[0]);
+    EXPECT_LE(length, row.size());
+    row.resize(length);
+    return row;
+}
+
+//a row formatted one byte at a time with snprintf (the way text output is usually written)
+std::string referenceRow(const std::vector<unsigned char>& data, const indexRange& range, const unsigned int columnCount)
+{
+    char text[16];
+    std::snprintf(text, sizeof(text), "0x%08x  ", range.start);
+    std::string row(text);
+
+    std::string ascii;
+    for (unsigned int column = 0; column < columnCount; ++column) {
+        const unsigned int i = range.start + column;
+        if (i < range.end && i < data.size()) {
+            std::snprintf(text, sizeof(text), "%02X ", data[i]);
+            row += text;
+            ascii += (0x20 <= data[i] && data[i] < 0x7F) ? static_cast<char>(data[i]) : '.';
+        }
+        else {
+            row += "   ";
+        }
+    }
+    return row + " " + ascii;
+}
+
+}
+
+TEST(hexFormat, allByteValues){
+    std::vector<unsigned char> data;
+    for (unsigned int value = 0; value < 256; ++value) {
+        data.push_back(static_cast<unsigned char>(value));
+    }
+
+    std::string upper(512, '#');
+    EXPECT_EQ(512u, hexFormat::formatHex(data.data(), 256, &upper[0]));
+    EXPECT_EQ(referenceHex(data, "%02X"), upper);
+
+    std::string lower(512, '#');
+    EXPECT_EQ(512u, hexFormat::formatHex(data.data(), 256, &lower[0], hexFormat::letterCase::lower));
+    EXPECT_EQ(referenceHex(data, "%02x"), lower);
+}
+
+TEST(hexFormat, randomLengths){
+    std::srand(39);
+    for (unsigned int count = 0; count < 100; ++count) {
+        std::vector<unsigned char> data(count);
+        for (unsigned char& byte : data) {
+            byte = static_cast<unsigned char>(std::rand());
+        }
+
+        //one character past the end, to check nothing is written there
+        std::string out(2*count + 1, '#');
+        EXPECT_EQ(2*count, hexFormat::formatHex(data.data(), count, &out[0]));
+        EXPECT_EQ(referenceHex(data, "%02X") + "#", out);
+    }
+}
+
+TEST(hexFormat, address){
+    char out[hexFormat::ADDRESS_LENGTH];
+    EXPECT_EQ(hexFormat::ADDRESS_LENGTH, hexFormat::formatAddress(0x0012abcd, 8, out));
+    EXPECT_EQ("0x0012abcd", std::string(out, hexFormat::ADDRESS_LENGTH));
+
+    hexFormat::formatAddress(0xFFFFFFFF, 8, out, hexFormat::letterCase::upper);
+    EXPECT_EQ("0xFFFFFFFF", std::string(out, hexFormat::ADDRESS_LENGTH));
+
+    hexFormat::formatAddress(0, 8, out);
+    EXPECT_EQ("0x00000000", std::string(out, hexFormat::ADDRESS_LENGTH));
+}
+
+TEST(hexFormat, longAddress){
+    char out[hexFormat::MAX_ADDRESS_LENGTH];
+    EXPECT_EQ(12u, hexFormat::formatAddress(0x3ffffff00ULL, 10, out));
+    EXPECT_EQ("0x03ffffff00", std::string(out, 12));
+
+    EXPECT_EQ(hexFormat::MAX_ADDRESS_LENGTH, hexFormat::formatAddress(0x0123456789abcdefULL, 16, out));
+    EXPECT_EQ("0x0123456789abcdef", std::string(out, hexFormat::MAX_ADDRESS_LENGTH));
+
+    EXPECT_EQ( 8u, hexFormat::getAddressDigitCount(0));
+    EXPECT_EQ( 8u, hexFormat::getAddressDigitCount(0xFFFFFFFFULL));
+    EXPECT_EQ(10u, hexFormat::getAddressDigitCount(0x100000000ULL));
+    EXPECT_EQ(10u, hexFormat::getAddressDigitCount(0x3FFFFFFFFULL));   //a 16 GB file
+    EXPECT_EQ(16u, hexFormat::getAddressDigitCount(~0ULL));
+}
+
+TEST(hexFormat, row){
+    const std::string text = "Hello, world!\n\x7F\x80";
+    const std::vector<unsigned char> data(text.begin(), text.end());
+
+    EXPECT_EQ(10u + 2 + 3*16 + 1 + 16, hexFormat::getRowLength(16, 8));
+    EXPECT_EQ("0x00000000  48 65 6C 6C 6F 2C 20 77 6F 72 6C 64 21 0A 7F 80  Hello, world!...",
+              formatRow(data, indexRange(0, 16), 16));
+
+    //a row that doesn't start at 0
+    EXPECT_EQ("0x00000004  6F 2C 20 77  o, w",
+              formatRow(data, indexRange(4, 8), 4));
+
+    //a longer address
+    EXPECT_EQ(12u + 2 + 3*4 + 1 + 4, hexFormat::getRowLength(4, 10));
+    EXPECT_EQ("0x0000000004  6F 2C 20 77  o, w",
+              formatRow(data, indexRange(4, 8), 4, 10));
+}
+
+TEST(hexFormat, partialRow){
+    const std::vector<unsigned char> data = {0x41, 0x42, 0x00};
+
+    //missing bytes are spaces in the hex columns, and left out of the ASCII
+    EXPECT_EQ("0x00000000  41 42 00           AB.",
+              formatRow(data, indexRange(0, 6), 6));
+
+    EXPECT_EQ("0x00000002  00           .",
+              formatRow(data, indexRange(2, 6), 4));
+
+    //no bytes at all
+    EXPECT_EQ("0x00000010               ",
+              formatRow(data, indexRange(16, 20), 4));
+
+    //range longer than the column count
+    EXPECT_EQ("0x00000000  41 42  AB",
+              formatRow(data, indexRange(0, 3), 2));
+}
+
+TEST(hexFormat, randomRows){
+    std::srand(40);
+    std::vector<unsigned char> data(1000);
+    for (unsigned char& byte : data) {
+        byte = static_cast<unsigned char>(std::rand());
+    }
+
+    for (unsigned int k = 0; k < 200; ++k) {
+        const unsigned int columnCount = 1 + std::rand() % 64;
+        const unsigned int start = std::rand() % 1000;
+        const indexRange range(start, start + columnCount);
+        EXPECT_EQ(referenceRow(data, range, columnCount), formatRow(data, range, columnCount));
+    }
+}
+
+//a micro-benchmark (run with --gtest_also_run_disabled_tests):
+// formatting 16 MB as rows of 32 columns, with formatRow and with snprintf per byte
+TEST(hexFormat, DISABLED_rowBenchmark){
+    const unsigned int size = 1 << 24;
+    const unsigned int columnCount = 32;
+
+    std::vector<unsigned char> data(size);
+    std::srand(41);
+    for (unsigned char& byte : data) {
+        byte = static_cast<unsigned char>(std::rand());
+    }
+
+    auto measure = [&](const char* name, const std::function<size_t()>& formatAll) {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t length = formatAll();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-10s %6.1f MB/s (%zu characters)\n", name, size/seconds/1e6, length);
+        return length;
+    };
+
+    const size_t rowLength = hexFormat::getRowLength(columnCount, 8);
+    std::vector<char> text((rowLength + 1) * (size/columnCount));
+
+    const size_t formatRowLength = measure("formatRow", [&]() {
+        char* pos = text.data();
+        for (unsigned int start = 0; start < size; start += columnCount) {
+            pos += hexFormat::formatRow(data, indexRange(start, start + columnCount), columnCount, start, 8, pos);
+            *pos++ = '\n';
+        }
+        return static_cast<size_t>(pos - text.data());
+    });
+
+    const size_t snprintfLength = measure("snprintf", [&]() {
+        char* pos = text.data();
+        for (unsigned int start = 0; start < size; start += columnCount) {
+            pos += std::sprintf(pos, "0x%08x  ", start);
+            for (unsigned int i = start; i < start + columnCount; ++i) {
+                pos += std::sprintf(pos, "%02X ", data[i]);
+            }
+            *pos++ = ' ';
+            for (unsigned int i = start; i < start + columnCount; ++i) {
+                *pos++ = (0x20 <= data[i] && data[i] < 0x7F) ? static_cast<char>(data[i]) : '.';
+            }
+            *pos++ = '\n';
+        }
+        return static_cast<size_t>(pos - text.data());
+    });
+
+    EXPECT_EQ(formatRowLength, snprintfLength);
+}
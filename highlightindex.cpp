@@ -0,0 +1,173 @@
+#include "highlightindex.h"
+
+#include <algorithm>
+
+highlightIndex::highlightIndex()
+    :   m_entries(),
+        m_maxEnds(),
+        m_maxLevel(-1),
+        m_pending(),
+        m_nextOrder(0)
+{
+}
+
+void highlightIndex::add(const indexRange& range, const unsigned int style)
+{
+    if (0 == range.count()) {
+        return;
+    }
+
+    //merge with the previous range if it has the same style, and the two are contiguous
+    if (!m_pending.empty()) {
+        entry& previous = m_pending.back();
+
+        if (    previous.style == style
+             && previous.range.start <= range.end
+             && range.start <= previous.range.end ) {
+
+            previous.range = indexRange(std::min(previous.range.start, range.start),
+                                        std::max(previous.range.end,   range.end  ));
+            return;
+        }
+    }
+
+    ASSERT(m_nextOrder < UINT_MAX);
+    m_pending.push_back(entry{range, style, m_nextOrder++});
+}
+
+void highlightIndex::clear()
+{
+    m_entries.clear();
+    m_maxEnds.clear();
+    m_maxLevel = -1;
+    m_pending.clear();
+    m_nextOrder = 0;
+}
+
+unsigned int highlightIndex::size() const
+{
+    ASSERT_LE_UINT_MAX(m_entries.size() + m_pending.size());
+    return static_cast<unsigned int>(m_entries.size() + m_pending.size());
+}
+
+void highlightIndex::getOverlapping(const indexRange& queryRange, std::vector<entry>& overlapping)
+{
+    overlapping.clear();
+
+    if (!m_pending.empty()) {
+        update();
+    }
+
+    if (m_entries.empty() || 0 == queryRange.count()) {
+        return;
+    }
+
+    const long long n = static_cast<long long>(m_entries.size());
+
+    auto addIfOverlapping = [&](const long long i) {
+        const indexRange& range = m_entries[static_cast<size_t>(i)].range;
+        if (queryRange.start < range.end && range.start < queryRange.end) {
+            overlapping.push_back(m_entries[static_cast<size_t>(i)]);
+        }
+    };
+
+    /*
+    tree layout: the nodes at level k are the indices i with (i+1) divisible by 2^k but not 2^(k+1);
+     the children of node i at level k are i - 2^(k-1) and i + 2^(k-1)
+    */
+    class stackItem {
+    public:
+        long long node;
+        int level;
+        bool leftDone;  //true if the left subtree has been searched
+    };
+
+    std::vector<stackItem> stack;
+    stack.push_back(stackItem{(1LL << m_maxLevel) - 1, m_maxLevel, false});
+
+    while (!stack.empty()) {
+
+        const stackItem item = stack.back();
+        stack.pop_back();
+
+        if (item.level <= 3) {
+            //small subtree: check its ranges in order
+            const long long first = item.node >> item.level << item.level;
+            const long long last  = std::min(first + (1LL << (item.level + 1)) - 1, n);
+
+            for (long long i = first; i < last && m_entries[static_cast<size_t>(i)].range.start < queryRange.end; ++i) {
+                addIfOverlapping(i);
+            }
+        }
+        else if (!item.leftDone) {
+            //search the left subtree first, then come back to this node
+            stack.push_back(stackItem{item.node, item.level, true});
+
+            const long long left = item.node - (1LL << (item.level - 1));
+
+            //skip the left subtree if all of its ranges end before the query range
+            // (a left child past the end of the array has no recorded max end: its subtree may still have ranges)
+            if (left >= n || m_maxEnds[static_cast<size_t>(left)] > queryRange.start) {
+                stack.push_back(stackItem{left, item.level - 1, false});
+            }
+        }
+        else if (item.node < n && m_entries[static_cast<size_t>(item.node)].range.start < queryRange.end) {
+            //this node, then the right subtree (which only has ranges that start at or after this one)
+            addIfOverlapping(item.node);
+            stack.push_back(stackItem{item.node + (1LL << (item.level - 1)), item.level - 1, false});
+        }
+    }
+
+    std::sort(overlapping.begin(), overlapping.end(),
+              [](const entry& a, const entry& b) { return a.order < b.order; } );
+}
+
+void highlightIndex::update()
+{
+    m_entries.insert(m_entries.end(), m_pending.begin(), m_pending.end());
+    m_pending.clear();
+
+    std::sort(m_entries.begin(), m_entries.end(),
+              [](const entry& a, const entry& b) { return a.range.start < b.range.start; } );
+
+    const long long n = static_cast<long long>(m_entries.size());
+    m_maxEnds.assign(m_entries.size(), 0);
+
+    if (0 == n) {
+        m_maxLevel = -1;
+        return;
+    }
+
+    //leaves (level 0: the even indices)
+    long long lastNode = 0;             //the last node at the current level that is in the tree
+    unsigned int lastMaxEnd = 0;        //its subtree's max end
+    for (long long i = 0; i < n; i += 2) {
+        lastNode = i;
+        m_maxEnds[static_cast<size_t>(i)] = lastMaxEnd = m_entries[static_cast<size_t>(i)].range.end;
+    }
+
+    int level = 1;
+    for ( ; (1LL << level) <= n; ++level) {
+
+        const long long halfStep = 1LL << (level - 1);
+
+        for (long long i = (halfStep << 1) - 1; i < n; i += halfStep << 2) {
+
+            const unsigned int leftMaxEnd  = m_maxEnds[static_cast<size_t>(i - halfStep)];
+
+            //a right child past the end of the array: use the max end of the last subtree below it
+            const unsigned int rightMaxEnd = (i + halfStep < n) ? m_maxEnds[static_cast<size_t>(i + halfStep)] : lastMaxEnd;
+
+            m_maxEnds[static_cast<size_t>(i)] = std::max({m_entries[static_cast<size_t>(i)].range.end, leftMaxEnd, rightMaxEnd});
+        }
+
+        //the last node at this level: the parent of the last node at the level below
+        // (a right child's parent is below it, a left child's is above it, possibly past the end of the array)
+        lastNode = ((lastNode >> level) & 1) ? lastNode - halfStep : lastNode + halfStep;
+        if (lastNode < n && m_maxEnds[static_cast<size_t>(lastNode)] > lastMaxEnd) {
+            lastMaxEnd = m_maxEnds[static_cast<size_t>(lastNode)];
+        }
+    }
+
+    m_maxLevel = level - 1;
+}
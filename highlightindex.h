@@ -0,0 +1,55 @@
+#ifndef HIGHLIGHTINDEX_H
+#define HIGHLIGHTINDEX_H
+
+#include <vector>
+
+#include "indexrange.h"
+#include "defensivecoding.h"
+
+/*
+    stores highlighted index ranges, each with a style (an index into a style list kept by the user of this class)
+
+    ranges added later are drawn over earlier ones: overlap queries return ranges in the order they were added
+
+    ranges are kept sorted by start index as an implicit interval tree
+     (each tree node also records the largest end index in its subtree),
+     so an overlap query only visits ranges near the query range, regardless of how many are stored
+
+    a range that touches or overlaps the previously added range, with the same style, is merged into it
+     (nothing can be drawn between them, so the result is the same)
+*/
+
+class highlightIndex
+{
+public:
+    class entry {
+    public:
+        indexRange range;
+        unsigned int style;
+        unsigned int order;     //ranges with higher order are drawn over ranges with lower order
+    };
+
+    highlightIndex();
+
+    void add(const indexRange& range, const unsigned int style);
+    void clear();
+
+    //the number of stored ranges (after merging)
+    unsigned int size() const;
+
+    //replaces the contents of overlapping with the stored ranges that overlap queryRange, in the order they were added
+    void getOverlapping(const indexRange& queryRange, std::vector<entry>& overlapping);
+
+private:
+    //adds pending ranges to the sorted ranges, and rebuilds the tree
+    void update();
+
+    std::vector<entry> m_entries;           //sorted by range start (when there are no pending ranges)
+    std::vector<unsigned int> m_maxEnds;    //m_maxEnds[i]: the largest range end in the subtree at node i
+    int m_maxLevel;                         //the height of the tree (-1 if empty)
+
+    std::vector<entry> m_pending;           //ranges added since the last update (in the order they were added)
+    unsigned int m_nextOrder;
+};
+
+#endif // HIGHLIGHTINDEX_H
@@ -0,0 +1,158 @@
+#include <random>
+
+#include "highlightindex.h"
+#include "gtestDefs.h"
+#include <gtest.h>
+
+TEST(highlightIndex, empty){
+    highlightIndex index;
+    std::vector<highlightIndex::entry> overlapping;
+
+    index.getOverlapping(indexRange(0,100), overlapping);
+    EXPECT_TRUE(overlapping.empty());
+    EXPECT_EQ(0u, index.size());
+
+    index.add(indexRange(10,10), 0);    //empty ranges aren't stored
+    EXPECT_EQ(0u, index.size());
+}
+
+TEST(highlightIndex, mergesContiguousRangesWithTheSameStyle){
+    highlightIndex index;
+    index.add(indexRange( 0,10), 1);
+    index.add(indexRange(10,20), 1);    //merged: touches the previous range
+    index.add(indexRange(15,30), 1);    //merged: overlaps it
+    index.add(indexRange(40,50), 1);    //not contiguous
+    index.add(indexRange(50,60), 2);    //different style
+    index.add(indexRange(60,70), 1);    //not contiguous with the previous range with this style
+    EXPECT_EQ(4u, index.size());
+
+    std::vector<highlightIndex::entry> overlapping;
+    index.getOverlapping(indexRange(0,100), overlapping);
+    ASSERT_EQ(4u, overlapping.size());
+    EXPECT_EQ(indexRange( 0,30), overlapping[0].range);
+    EXPECT_EQ(indexRange(40,50), overlapping[1].range);
+    EXPECT_EQ(indexRange(50,60), overlapping[2].range);
+    EXPECT_EQ(indexRange(60,70), overlapping[3].range);
+}
+
+TEST(highlightIndex, getOverlapping){
+    std::mt19937 generator(1);
+
+    for (unsigned int count : {1u, 2u, 7u, 16u, 100u, 1000u, 5000u}) {
+
+        highlightIndex index;
+        std::vector<highlightIndex::entry> added;
+
+        for (unsigned int i = 0; i < count; ++i) {
+            //mostly short ranges, and a few long ones
+            const unsigned int start  = generator() % 100000;
+            const unsigned int length = (0 == generator() % 50) ? generator() % 50000 : 1 + generator() % 100;
+            const indexRange range(start, start + length);
+
+            //distinct styles, so nothing is merged
+            index.add(range, i);
+            added.push_back(highlightIndex::entry{range, i, 0});
+
+            //queries between additions
+            if (0 == i % 500) {
+                std::vector<highlightIndex::entry> overlapping;
+                index.getOverlapping(indexRange(0, 200000), overlapping);
+                EXPECT_EQ(i + 1, overlapping.size());
+            }
+        }
+
+        for (unsigned int q = 0; q < 200; ++q) {
+            const unsigned int start = generator() % 110000;
+            const indexRange queryRange(start, start + generator() % 2000);
+
+            std::vector<unsigned int> expected;
+            for (const highlightIndex::entry& e : added) {
+                if (e.range.start < queryRange.end && queryRange.start < e.range.end) {
+                    expected.push_back(e.style);
+                }
+            }
+
+            std::vector<highlightIndex::entry> overlapping;
+            index.getOverlapping(queryRange, overlapping);
+
+            std::vector<unsigned int> found;
+            for (const highlightIndex::entry& e : overlapping) {
+                found.push_back(e.style);
+            }
+
+            //the same ranges, in the order they were added
+            EXPECT_EQ(expected, found) << "count " << count << ", query " << queryRange.start << " " << queryRange.end;
+        }
+    }
+}
+
+TEST(highlightIndex, getOverlappingPastTheEndOfTheTree){
+    //42 ranges: the right children of some nodes are past the end of the array,
+    // so their subtree max ends come from the last node below them
+    const std::vector<indexRange> ranges = {
+        indexRange(26,28),  indexRange(53,55),  indexRange( 0, 1),  indexRange(51,54),  indexRange( 7, 9),  indexRange(10,13),
+        indexRange(54,55),  indexRange(40,41),  indexRange(29,82),  indexRange( 4, 7),  indexRange(18,20),  indexRange(46,114),
+        indexRange( 0, 2),  indexRange(31,32),  indexRange( 9,90),  indexRange(15,16),  indexRange(18,35),  indexRange(46,49),
+        indexRange(36,37),  indexRange(37,98),  indexRange(46,48),  indexRange(37,38),  indexRange(25,26),  indexRange(48,51),
+        indexRange(21,22),  indexRange(51,52),  indexRange(48,49),  indexRange(50,53),  indexRange(14,65),  indexRange(10,11),
+        indexRange( 2, 4),  indexRange(53,56),  indexRange(18,21),  indexRange(43,44),  indexRange(51,52),  indexRange(49,50),
+        indexRange(55,58),  indexRange(57,115), indexRange(37,83),  indexRange(15,17),  indexRange(18,21),  indexRange( 2, 5) };
+
+    highlightIndex index;
+    for (unsigned int i = 0; i < ranges.size(); ++i) {
+        index.add(ranges[i], i);
+    }
+
+    std::vector<highlightIndex::entry> overlapping;
+    index.getOverlapping(indexRange(67,70), overlapping);
+
+    std::vector<unsigned int> found;
+    for (const highlightIndex::entry& e : overlapping) {
+        found.push_back(e.style);
+    }
+    EXPECT_EQ(std::vector<unsigned int>({8, 11, 14, 19, 37, 38}), found);
+}
+
+TEST(highlightIndex, getOverlappingRandomSizes){
+    std::mt19937 generator(2);
+
+    for (unsigned int test = 0; test < 2000; ++test) {
+
+        const unsigned int count = 1 + generator() % 300;
+        const unsigned int span  = 1 + generator() % 1000;
+
+        highlightIndex index;
+        std::vector<indexRange> added;
+
+        for (unsigned int i = 0; i < count; ++i) {
+            const unsigned int start = generator() % span;
+            const indexRange range(start, start + 1 + generator() % (1 + span/4));
+
+            //distinct styles, so nothing is merged
+            index.add(range, i);
+            added.push_back(range);
+        }
+
+        for (unsigned int q = 0; q < 10; ++q) {
+            const unsigned int start = generator() % (span + span/4 + 1);
+            const indexRange queryRange(start, start + 1 + generator() % (1 + span/10));
+
+            std::vector<unsigned int> expected;
+            for (unsigned int i = 0; i < added.size(); ++i) {
+                if (added[i].start < queryRange.end && queryRange.start < added[i].end) {
+                    expected.push_back(i);
+                }
+            }
+
+            std::vector<highlightIndex::entry> overlapping;
+            index.getOverlapping(queryRange, overlapping);
+
+            std::vector<unsigned int> found;
+            for (const highlightIndex::entry& e : overlapping) {
+                found.push_back(e.style);
+            }
+
+            ASSERT_EQ(expected, found) << "count " << count << ", query " << queryRange.start << " " << queryRange.end;
+        }
+    }
+}
@@ -62,6 +62,25 @@ public:
         return false;
     }
 
+    //for a std::set or std::multiset of non-empty indexRanges that don't overlap each other:
+    // returns the range this overlaps, or indexRanges.end() if there isn't one
+    //  (the ranges are sorted by start, and so by end: only the last range starting before this ends can overlap it,
+    //   so this is a logarithmic search instead of overlapsAnyIn's linear one)
+    template <typename T>
+    typename T::const_iterator findOverlapInSorted(const T& indexRanges) const {
+        if (0 == count()) {
+            return indexRanges.end();
+        }
+
+        typename T::const_iterator it = indexRanges.lower_bound(indexRange(end, end));   //first range starting at or after end
+        if (it == indexRanges.begin()) {
+            return indexRanges.end();
+        }
+
+        --it;
+        return overlaps(*it) ? it : indexRanges.end();
+    }
+
 
     template <typename T>
     static bool isNonDecreasingAndNonOverlapping(const T& indexRanges) {
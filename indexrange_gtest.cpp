@@ -1,4 +1,5 @@
 #include "indexrange.h"
+#include <set>
 #include "gtestDefs.h"
 #include <gtest.h>
 
@@ -190,6 +191,25 @@ TEST(indexRange, overlapsAnyIn){
     }
 }
 
+TEST(indexRange, findOverlapInSorted){
+    std::multiset<indexRange> ranges = { indexRange(10,20), indexRange(30,40), indexRange(50,60) };
+
+    EXPECT_EQ(  ranges.end(),       indexRange( 0,10).findOverlapInSorted(ranges)  );
+    EXPECT_EQ(  ranges.end(),       indexRange(20,30).findOverlapInSorted(ranges)  );
+    EXPECT_EQ(  ranges.end(),       indexRange(60,70).findOverlapInSorted(ranges)  );
+    EXPECT_EQ(  ranges.end(),       indexRange(35,35).findOverlapInSorted(ranges)  );   //size 0 ranges can't overlap
+
+    EXPECT_EQ(  indexRange(10,20),  *indexRange( 5,11).findOverlapInSorted(ranges) );
+    EXPECT_EQ(  indexRange(30,40),  *indexRange(39,45).findOverlapInSorted(ranges) );
+    EXPECT_EQ(  indexRange(30,40),  *indexRange(32,35).findOverlapInSorted(ranges) );
+
+    //a range overlapping several finds the last one
+    EXPECT_EQ(  indexRange(50,60),  *indexRange(15,55).findOverlapInSorted(ranges) );
+
+    const std::multiset<indexRange> empty;
+    EXPECT_EQ(  empty.end(),        indexRange( 0,100).findOverlapInSorted(empty)  );
+}
+
 TEST(indexRange, isNonDecreasingAndNonOverlapping){
     {
         std::vector<indexRange> ranges = { indexRange(10,20), indexRange(20,30), indexRange(35,35), indexRange(35,45) };
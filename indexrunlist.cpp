@@ -0,0 +1,314 @@
+#include "indexrunlist.h"
+
+#include <algorithm>
+
+unsigned int indexRunList::run::getLast() const
+{
+    return start + (count - 1)*period;
+}
+
+
+indexRunList::runView::runView(const run* runs, const size_t count)
+    :   m_runs(runs),
+        m_count(count)
+{
+}
+
+const indexRunList::run* indexRunList::runView::begin() const
+{
+    return m_runs;
+}
+
+const indexRunList::run* indexRunList::runView::end() const
+{
+    return m_runs + m_count;
+}
+
+size_t indexRunList::runView::size() const
+{
+    return m_count;
+}
+
+bool indexRunList::runView::empty() const
+{
+    return 0 == m_count;
+}
+
+const indexRunList::run& indexRunList::runView::operator[](const size_t i) const
+{
+    ASSERT(i < m_count);
+    return m_runs[i];
+}
+
+const indexRunList::run& indexRunList::runView::back() const
+{
+    ASSERT(!empty());
+    return m_runs[m_count - 1];
+}
+
+
+indexRunList::const_iterator::const_iterator(const run* runs, const size_t runIndex, const unsigned int step)
+    :   m_runs(runs),
+        m_runIndex(runIndex),
+        m_step(step)
+{
+}
+
+unsigned int indexRunList::const_iterator::operator*() const
+{
+    const run& r = m_runs[m_runIndex];
+    return r.start + m_step*r.period;
+}
+
+indexRunList::const_iterator& indexRunList::const_iterator::operator++()
+{
+    if (++m_step == m_runs[m_runIndex].count) {
+        ++m_runIndex;
+        m_step = 0;
+    }
+    return *this;
+}
+
+indexRunList::const_iterator indexRunList::const_iterator::operator++(int)
+{
+    const_iterator ret = *this;
+    ++(*this);
+    return ret;
+}
+
+bool indexRunList::const_iterator::operator==(const const_iterator& rhs) const
+{
+    return m_runIndex == rhs.m_runIndex && m_step == rhs.m_step;
+}
+
+bool indexRunList::const_iterator::operator!=(const const_iterator& rhs) const
+{
+    return !(*this == rhs);
+}
+
+size_t indexRunList::const_iterator::getRunIndex() const
+{
+    return m_runIndex;
+}
+
+unsigned int indexRunList::const_iterator::getStep() const
+{
+    return m_step;
+}
+
+
+indexRunList::indexRunList()
+    :   m_inlineRun{0, 0, 0},
+        m_runs(),
+        m_runCount(0),
+        m_size(0)
+{
+}
+
+indexRunList::indexRunList(std::initializer_list<unsigned int> indices)
+    :   m_inlineRun{0, 0, 0},
+        m_runs(),
+        m_runCount(0),
+        m_size(0)
+{
+    for (unsigned int index : indices) {
+        push_back(index);
+    }
+}
+
+void indexRunList::push_back(const unsigned int index)
+{
+    ASSERT(empty() || index > back());
+    ASSERT(m_size < UINT_MAX);
+
+    ++m_size;
+
+    if (0 != m_runCount) {
+        run& last = lastRun();
+
+        //a second index sets the run's period
+        if (1 == last.count) {
+            last.period = index - last.start;
+            last.count = 2;
+            return;
+        }
+
+        //the next index in the run
+        if (index - last.getLast() == last.period) {
+            ++last.count;
+            return;
+        }
+    }
+
+    addRun(run{index, 0, 1});
+}
+
+void indexRunList::appendRun(const unsigned int start, const unsigned int period, const unsigned int count)
+{
+    if (0 == count) {
+        return;
+    }
+    if (1 == count || 0 == period) {
+        push_back(start);
+        return;
+    }
+
+    ASSERT(empty() || start > back());
+    ASSERT(noSumOverflow(m_size, count));
+    ASSERT(static_cast<unsigned long long>(start) + static_cast<unsigned long long>(count - 1)*period <= UINT_MAX);
+
+    //continues the last run?
+    if (0 != m_runCount) {
+        run& last = lastRun();
+        if (   (1 == last.count && start - last.start == period)
+            || (1 <  last.count && last.period == period && start - last.getLast() == period) )
+        {
+            last.period = period;
+            last.count += count;
+            m_size += count;
+            return;
+        }
+    }
+
+    addRun(run{start, period, count});
+    m_size += count;
+}
+
+unsigned int indexRunList::size() const
+{
+    return m_size;
+}
+
+bool indexRunList::empty() const
+{
+    return 0 == m_size;
+}
+
+unsigned int indexRunList::front() const
+{
+    ASSERT(!empty());
+    return getRunData()[0].start;
+}
+
+unsigned int indexRunList::back() const
+{
+    ASSERT(!empty());
+    return getRunData()[m_runCount - 1].getLast();
+}
+
+void indexRunList::resize(const unsigned int count)
+{
+    if (count >= m_size) {
+        return;
+    }
+
+    //drop whole runs from the end, then shorten the last one
+    unsigned int remaining = m_size;
+    while (remaining - lastRun().count >= count) {
+        remaining -= lastRun().count;
+        removeLastRun();
+        if (remaining == count) {
+            m_size = count;
+            return;
+        }
+    }
+
+    run& last = lastRun();
+    last.count -= remaining - count;
+    if (1 == last.count) {
+        last.period = 0;
+    }
+    m_size = count;
+}
+
+void indexRunList::clear()
+{
+    m_runs.clear();
+    m_runCount = 0;
+    m_size = 0;
+}
+
+void indexRunList::move(const unsigned int distance)
+{
+    run* runs = getRunData();
+    for (size_t i = 0; i < m_runCount; ++i) {
+        ASSERT(noSumOverflow(runs[i].getLast(), distance));
+        runs[i].start += distance;
+    }
+}
+
+indexRunList::runView indexRunList::getRuns() const
+{
+    return runView(getRunData(), m_runCount);
+}
+
+indexRunList::const_iterator indexRunList::begin() const
+{
+    return const_iterator(getRunData(), 0, 0);
+}
+
+indexRunList::const_iterator indexRunList::end() const
+{
+    return const_iterator(getRunData(), m_runCount, 0);
+}
+
+std::vector<unsigned int> indexRunList::toVector() const
+{
+    return std::vector<unsigned int>(begin(), end());
+}
+
+bool indexRunList::operator==(const indexRunList& rhs) const
+{
+    return m_size == rhs.m_size && std::equal(begin(), end(), rhs.begin());
+}
+
+bool indexRunList::operator!=(const indexRunList& rhs) const
+{
+    return !(*this == rhs);
+}
+
+const indexRunList::run* indexRunList::getRunData() const
+{
+    return m_runCount <= 1 ? &m_inlineRun : m_runs.data();
+}
+
+indexRunList::run* indexRunList::getRunData()
+{
+    return m_runCount <= 1 ? &m_inlineRun : m_runs.data();
+}
+
+indexRunList::run& indexRunList::lastRun()
+{
+    ASSERT(0 != m_runCount);
+    return getRunData()[m_runCount - 1];
+}
+
+void indexRunList::addRun(const run& r)
+{
+    if (0 == m_runCount) {
+        m_inlineRun = r;
+    }
+    else {
+        //a second run moves the list to the heap storage
+        if (1 == m_runCount) {
+            m_runs.push_back(m_inlineRun);
+        }
+        m_runs.push_back(r);
+    }
+    ++m_runCount;
+}
+
+void indexRunList::removeLastRun()
+{
+    ASSERT(0 != m_runCount);
+
+    if (2 == m_runCount) {
+        //back to the inline run
+        m_inlineRun = m_runs.front();
+        m_runs.clear();
+    }
+    else if (2 < m_runCount) {
+        m_runs.pop_back();
+    }
+    --m_runCount;
+}
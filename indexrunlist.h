@@ -0,0 +1,124 @@
+#ifndef INDEXRUNLIST_H
+#define INDEXRUNLIST_H
+
+#include <vector>
+#include <iterator>
+#include <initializer_list>
+#include <cstddef>
+
+#include "defensivecoding.h"
+
+/*
+    an increasing list of indices, stored as periodic runs:
+        (start, period, count) stands for start, start + period, ... start + (count-1)*period
+
+    indices are appended in increasing order; an index continuing the last run's period extends it,
+     so repetitive data (e.g. a block that matches at every index of a zero-filled region)
+     takes one run instead of one index per occurrence
+
+    iterating gives the indices one at a time (like a std::vector<unsigned int>)
+
+    a list with a single run (the common case: one index, or one repeated block) keeps it inline,
+     without a heap allocation
+*/
+
+class indexRunList
+{
+public:
+    class run {
+    public:
+        unsigned int start;
+        unsigned int period;    //0 if count is 1
+        unsigned int count;
+
+        unsigned int getLast() const;
+    };
+
+    //the runs, in order (an array in either the inline run or the heap storage)
+    class runView {
+    public:
+        runView(const run* runs, const size_t count);
+
+        const run* begin() const;
+        const run* end() const;
+        size_t size() const;
+        bool empty() const;
+        const run& operator[](const size_t i) const;
+        const run& back() const;
+
+    private:
+        const run* m_runs;
+        size_t m_count;
+    };
+
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag   iterator_category;
+        typedef unsigned int                value_type;
+        typedef std::ptrdiff_t              difference_type;
+        typedef const unsigned int*         pointer;
+        typedef unsigned int                reference;
+
+        const_iterator(const run* runs, const size_t runIndex, const unsigned int step);
+
+        unsigned int operator*() const;
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        bool operator==(const const_iterator& rhs) const;
+        bool operator!=(const const_iterator& rhs) const;
+
+        //the run the iterator is in, and the iterator's position in it
+        size_t getRunIndex() const;
+        unsigned int getStep() const;
+
+    private:
+        const run* m_runs;
+        size_t m_runIndex;
+        unsigned int m_step;
+    };
+
+    indexRunList();
+    indexRunList(std::initializer_list<unsigned int> indices);
+
+    //index must be greater than back()
+    void push_back(const unsigned int index);
+
+    //appends count indices: start, start + period, ... (start must be greater than back())
+    void appendRun(const unsigned int start, const unsigned int period, const unsigned int count);
+
+    unsigned int size() const;
+    bool empty() const;
+    unsigned int front() const;
+    unsigned int back() const;
+
+    //keeps the first count indices
+    void resize(const unsigned int count);
+    void clear();
+
+    //adds distance to every index
+    void move(const unsigned int distance);
+
+    runView getRuns() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    std::vector<unsigned int> toVector() const;
+
+    bool operator==(const indexRunList& rhs) const; //same indices (however they're stored)
+    bool operator!=(const indexRunList& rhs) const;
+
+private:
+    run m_inlineRun;            //the run, while there's only one
+    std::vector<run> m_runs;    //all the runs, once there's more than one
+    size_t m_runCount;
+    unsigned int m_size;
+
+    const run* getRunData() const;
+    run* getRunData();
+    run& lastRun();
+    void addRun(const run& r);
+    void removeLastRun();
+};
+
+#endif // INDEXRUNLIST_H
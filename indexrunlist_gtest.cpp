@@ -0,0 +1,96 @@
+#include "indexrunlist.h"
+#include "gtestDefs.h"
+#include <gtest.h>
+
+TEST(indexRunList, runsFromIndices){
+    indexRunList list;
+    EXPECT_TRUE(list.empty());
+
+    //a run of period 1, then a run of period 5, then a lone index
+    for (unsigned int i = 10; i < 20; ++i) {
+        list.push_back(i);
+    }
+    for (unsigned int i = 100; i < 150; i += 5) {
+        list.push_back(i);
+    }
+    list.push_back(1000);
+
+    EXPECT_EQ(21u, list.size());
+    EXPECT_EQ(10u, list.front());
+    EXPECT_EQ(1000u, list.back());
+
+    //(19 is followed by 100, which starts a new run)
+    ASSERT_EQ(3u, list.getRuns().size());
+    EXPECT_EQ(1u, list.getRuns()[0].period);
+    EXPECT_EQ(10u, list.getRuns()[0].count);
+    EXPECT_EQ(5u, list.getRuns()[1].period);
+    EXPECT_EQ(10u, list.getRuns()[1].count);
+    EXPECT_EQ(1u, list.getRuns()[2].count);
+
+    std::vector<unsigned int> expected;
+    for (unsigned int i = 10; i < 20; ++i) {
+        expected.push_back(i);
+    }
+    for (unsigned int i = 100; i < 150; i += 5) {
+        expected.push_back(i);
+    }
+    expected.push_back(1000);
+    EXPECT_EQ(expected, list.toVector());
+}
+
+TEST(indexRunList, appendRun){
+    indexRunList list;
+    list.appendRun(0, 4, 1000000);
+    list.appendRun(4000000, 4, 10);     //continues the run
+    list.appendRun(5000000, 1, 3);
+
+    EXPECT_EQ(1000013u, list.size());
+    ASSERT_EQ(2u, list.getRuns().size());
+    EXPECT_EQ(4000036u, list.getRuns()[0].getLast());
+
+    EXPECT_EQ(indexRunList({5, 6, 7}), [](){ indexRunList l; l.appendRun(5, 1, 3); return l; } ());
+    EXPECT_NE(indexRunList({5, 6, 7}), indexRunList({5, 6, 8}));
+}
+
+TEST(indexRunList, resizeAndMove){
+    indexRunList list = {1, 2, 3, 4, 10, 20, 30, 31};
+
+    list.resize(6);
+    EXPECT_EQ(std::vector<unsigned int>({1, 2, 3, 4, 10, 20}), list.toVector());
+
+    list.resize(3);
+    EXPECT_EQ(std::vector<unsigned int>({1, 2, 3}), list.toVector());
+
+    list.move(100);
+    EXPECT_EQ(std::vector<unsigned int>({101, 102, 103}), list.toVector());
+
+    //a shortened run can be continued with a different period
+    list.resize(1);
+    list.push_back(200);
+    list.push_back(299);
+    EXPECT_EQ(std::vector<unsigned int>({101, 200, 299}), list.toVector());
+
+    list.resize(0);
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.begin(), list.end());
+}
+
+TEST(indexRunList, copies){
+    //a single run (stored inline) and several runs (stored on the heap)
+    const indexRunList single = {3, 5, 7, 9};
+    const indexRunList several = {3, 5, 7, 100, 1000};
+
+    indexRunList copy(single);
+    copy.push_back(11);
+    EXPECT_EQ(std::vector<unsigned int>({3, 5, 7, 9}), single.toVector());
+    EXPECT_EQ(std::vector<unsigned int>({3, 5, 7, 9, 11}), copy.toVector());
+
+    copy = several;
+    copy.move(1);
+    EXPECT_EQ(std::vector<unsigned int>({3, 5, 7, 100, 1000}), several.toVector());
+    EXPECT_EQ(std::vector<unsigned int>({4, 6, 8, 101, 1001}), copy.toVector());
+
+    indexRunList moved(std::move(copy));
+    EXPECT_EQ(2u, moved.getRuns().size());   //(4, 6, 8 and 101, 1001)
+    EXPECT_EQ(1001u, moved.back());
+}
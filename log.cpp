@@ -2,6 +2,8 @@
 
 Log LOG;    //global log object
 
+/*static*/ std::atomic_bool Log::m_detailedDebugEnabled(false);
+
 void Log::Info(QString str)
 {
     sendMessage(str, QColor(96,96,128));
@@ -27,6 +29,23 @@ void Log::Defensive(QString str)
     sendMessage(str, QColor(64,192,64));
 }
 
+void Log::DetailedDebug(QString str)
+{
+    if (m_detailedDebugEnabled) {
+        sendMessage(str, QColor(128,32,128));
+    }
+}
+
+/*static*/ void Log::setDetailedDebugEnabled(const bool enabled)
+{
+    m_detailedDebugEnabled = enabled;
+}
+
+/*static*/ bool Log::isDetailedDebugEnabled()
+{
+    return m_detailedDebugEnabled;
+}
+
 void Log::sendMessage(QString str, QColor color, bool timestamp)
 {
     QString outStr;
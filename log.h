@@ -6,6 +6,8 @@
 #include <QColor>
 #include <QDateTime>
 
+#include <atomic>
+
 class Log : public QObject
 {
 
@@ -27,6 +29,12 @@ public:
     void Debug(QString str);
     void Defensive(QString str);
 
+    //for messages too numerous to log by default (e.g. one for every differing byte):
+    // only logged while detailed debug messages are enabled
+    void DetailedDebug(QString str);
+    static void setDetailedDebugEnabled(const bool enabled);
+    static bool isDetailedDebugEnabled();   //check before building many messages
+
     void sendMessage(QString str = "", QColor color = QColor(0,0,0), bool timestamp = true);
 
     static void strMessageLvl1(const std::string& str);
@@ -36,6 +44,9 @@ public:
 signals:
     void message(QString str, QColor color);
 
+private:
+    static std::atomic_bool m_detailedDebugEnabled;
+
 };
 
 extern Log LOG; //global log object (declared in log.cpp)
@@ -94,7 +94,12 @@ MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
     ui(new Ui::MainWindow),
     m_userSettings(),
-    m_comparisonThread()
+    m_comparisonThread(),
+    m_fileLoader1(),
+    m_fileLoader2(),
+    m_fileLoadProgress1(0),
+    m_fileLoadProgress2(0),
+    m_deferredComparison(comparisonRequest::none)
 {
     ui->setupUi(this);
 
@@ -106,20 +111,55 @@ MainWindow::MainWindow(QWidget *parent) :
 
     connect(ui->verticalScrollBar, &QScrollBar::valueChanged, this, &MainWindow::doScrollBar);
 
+    //selecting an index in the overview strip centers it in the hex views
+    connect(ui->overviewStrip, &overviewStrip::indexSelected, this, [this](unsigned int index) {
+        unsigned int visibleCount = 0;
+        for (const QSharedPointer<dataSetView>& dsv : {m_dataSetView1, m_dataSetView2}) {
+            if (dsv) {
+                visibleCount = qMax(visibleCount, dsv->getSubset().count());
+            }
+        }
+        const unsigned int start = index - qMin(index, visibleCount/2);
+
+        ASSERT_LE_INT_MAX(start);
+        ui->verticalScrollBar->setValue(static_cast<int>(start));   //limited to the scrollbar range
+    });
+
     connect(ui->textEdit_dataSet1, &hexField::filenameDropped, this, &MainWindow::doLoadFile1);
     connect(ui->textEdit_dataSet2, &hexField::filenameDropped, this, &MainWindow::doLoadFile2);
 
+    //2 files dropped together on either side load in parallel, one on each side
+    connect(ui->textEdit_dataSet1, &hexField::filenamePairDropped, this, &MainWindow::doLoadFiles);
+    connect(ui->textEdit_dataSet2, &hexField::filenamePairDropped, this, &MainWindow::doLoadFiles);
+
     connect(ui->textEdit_dataSet1, &hexField::fontChanged, this, &MainWindow::onHexFieldFontChange);
     connect(ui->textEdit_dataSet2, &hexField::fontChanged, this, &MainWindow::onHexFieldFontChange);
 
     connect(ui->textEdit_dataSet1, &hexField::resized, this, &MainWindow::resizeHexField1);
     connect(ui->textEdit_dataSet2, &hexField::resized, this, &MainWindow::resizeHexField2);
 
+    //address columns only display the byte grid row addresses
+    ui->textEdit_address1->setDisplayMode(hexField::DisplayMode::AddressColumn);
+    ui->textEdit_address2->setDisplayMode(hexField::DisplayMode::AddressColumn);
+    ui->textEdit_address1->setAcceptDrops(false);
+    ui->textEdit_address2->setAcceptDrops(false);
+
     connect(&LOG, &Log::message, this, &MainWindow::displayLogMessage);
 
     connect(&m_comparisonThread, &comparisonThread::sendMessage, this, &MainWindow::displayLogMessage);
     connect(&m_comparisonThread, &comparisonThread::finished, this, &MainWindow::onComparisonThreadEnded);
 
+    connect(&m_fileLoader1, &fileLoaderThread::finished, this, &MainWindow::onFileLoader1Ended);
+    connect(&m_fileLoader2, &fileLoaderThread::finished, this, &MainWindow::onFileLoader2Ended);
+    connect(&m_fileLoader1, &fileLoaderThread::progress, this, [this](unsigned int percent) {
+        m_fileLoadProgress1 = percent;
+        showFileLoadProgress();
+    });
+    connect(&m_fileLoader2, &fileLoaderThread::progress, this, [this](unsigned int percent) {
+        m_fileLoadProgress2 = percent;
+        showFileLoadProgress();
+    });
+
     //redirect scroll wheel events from the hex views to the main scrollbar
     m_scrollWheelRedirector = QSharedPointer<scrollWheelRedirector>::create(ui->verticalScrollBar);
     ui->textEdit_dataSet1->installEventFilter(m_scrollWheelRedirector.data());
@@ -131,6 +171,7 @@ MainWindow::MainWindow(QWidget *parent) :
 
     //load settings from ini file
     m_userSettings.loadINIFile();
+    ui->actionAligned_scrolling->setChecked(m_userSettings.alignedScrolling);
 
     //resize window from ini file settings
     if (m_userSettings.windowWidth && m_userSettings.windowHeight) {
@@ -160,12 +201,10 @@ MainWindow::~MainWindow()
 
 void MainWindow::doScrollBar(int value)
 {
-    auto doScroll = [value](const QSharedPointer<dataSetView> dsv, QTextEdit* byteGrid, QTextEdit* addressColumn)
+    auto doScroll = [](const QSharedPointer<dataSetView> dsv, hexField* byteGrid, hexField* addressColumn, unsigned int val)
     {
         if (!dsv) {return;}
 
-        ASSERT_NOT_NEGATIVE(value);
-        unsigned int val = static_cast<unsigned int>(value);
         unsigned int bytesPerRow = dsv->getBytesPerRow();
 
         if (bytesPerRow) {
@@ -179,8 +218,13 @@ void MainWindow::doScrollBar(int value)
         }
     };
 
-    doScroll(m_dataSetView1, ui->textEdit_dataSet1, ui->textEdit_address1);
-    doScroll(m_dataSetView2, ui->textEdit_dataSet2, ui->textEdit_address2);
+    ASSERT_NOT_NEGATIVE(value);
+    const unsigned int index1 = static_cast<unsigned int>(value);
+
+    doScroll(m_dataSetView1, ui->textEdit_dataSet1, ui->textEdit_address1, index1);
+    doScroll(m_dataSetView2, ui->textEdit_dataSet2, ui->textEdit_address2, getAlignedIndex2(index1));
+
+    updateOverviewStrip();
 }
 
 void MainWindow::resizeHexField1()
@@ -220,24 +264,48 @@ void MainWindow::closeEvent(QCloseEvent* event)
 
 void MainWindow::doLoadFile1(const QString filename)
 {
-    dataSet::loadFileResult res = m_dataSet1->loadFile(filename);
-    if      (res == dataSet::loadFileResult::SUCCESS) {
-        //do nothing
-    }
-    else if (res == dataSet::loadFileResult::ERROR_FileDoesNotExist) {
-        LOG.Error("File \"" % filename % "\" does not exist.");
+    doLoadFile1Regions(filename, std::vector<dataSet::fileWindow>());
+}
+
+void MainWindow::doLoadFile1Regions(const QString filename, const std::vector<dataSet::fileWindow>& windows)
+{
+    //the file is read on m_fileLoader1's thread, then published to m_dataSet1 by onFileLoader1Ended
+
+    //a new file replaces one that is still loading
+    if (m_fileLoader1.isRunning()) {
+        m_fileLoader1.abort();
+        m_fileLoader1.wait();
     }
-    else if (res == dataSet::loadFileResult::ERROR_FileReadFailure) {
-        LOG.Error("\"" % filename % "\" failed to read.");
+
+    m_fileLoadProgress1 = 0;
+    m_fileLoader1.startThread(filename, windows)
+        ?   LOG.Debug("loading \"" % filename % "\"" % describeWindows(windows) % " (file 1)")
+        :   LOG.Debug("failed to start loading file 1: loader thread already running");
+}
+
+void MainWindow::onFileLoader1Ended()
+{
+    QString filename;
+    std::vector<dataSet::fileWindow> windows;
+    dataSet::loadFileResult res;
+    std::unique_ptr<std::vector<unsigned char>> data;
+
+    if (!m_fileLoader1.getResult(filename, windows, res, data)) {
+        return; //still running (a newer load was started), or already published
     }
-    else if (res == dataSet::loadFileResult::ERROR_ActiveDataReadLock) {
-        LOG.Error("File load canceled: Current file is still in use.");
+
+    showFileLoadProgress();
+
+    if (res == dataSet::loadFileResult::SUCCESS) {
+        res = m_dataSet1->loadFileData(filename, std::move(data), windows);
     }
-    else {
-        FAIL();
+
+    //failed and canceled loads leave the current file loaded
+    if (reportLoadFileResult(res, filename)) {
+        updateUIforFile1Load();
     }
 
-    updateUIforFile1Load();
+    startDeferredComparison();
 }
 
 void MainWindow::doLoadFile1FromMemory(std::unique_ptr<std::vector<unsigned char>> data)
@@ -260,6 +328,9 @@ void MainWindow::updateUIforFile1Load()
 {
     m_dataSetView1 = QSharedPointer<dataSetView>::create(m_dataSet1);
 
+    //previous comparison results no longer apply
+    clearComparisonResults();
+
     applyUserSettingsTo(m_dataSetView1); //reapply user settings to new dataSetView
 
     if (m_dataSet1->isLoaded() && m_dataSetView1) {
@@ -269,6 +340,9 @@ void MainWindow::updateUIforFile1Load()
             m_dataSetView1->setSubsetStart(m_dataSetView2->getSubsetStart());
         }
 
+        //addresses of large files (or regions far into them) need more digits
+        setAddressColumnWidth(ui->textEdit_address1, m_dataSetView1);
+
         m_dataSetView1->updateByteGridDimensions(ui->textEdit_dataSet1);
         m_dataSetView1->printByteGrid(ui->textEdit_dataSet1, ui->textEdit_address1);
         updateScrollBarRange();
@@ -277,7 +351,7 @@ void MainWindow::updateUIforFile1Load()
         dataSet::sourceInfo sourceInfo = m_dataSet1->getSourceInfo();
 
         if      (sourceInfo.type == dataSet::sourceType::file) {
-            name = sourceInfo.name;
+            name = sourceInfo.name % describeWindows(m_dataSet1->getWindows());
         }
         else if (sourceInfo.type == dataSet::sourceType::memory) {
             name = "[loaded from memory]";
@@ -301,24 +375,48 @@ void MainWindow::updateUIforFile1Load()
 
 void MainWindow::doLoadFile2(const QString filename)
 {
-    dataSet::loadFileResult res = m_dataSet2->loadFile(filename);
-    if      (res == dataSet::loadFileResult::SUCCESS) {
-        //do nothing
-    }
-    else if (res == dataSet::loadFileResult::ERROR_FileDoesNotExist) {
-        LOG.Error("File \"" % filename % "\" does not exist.");
+    doLoadFile2Regions(filename, std::vector<dataSet::fileWindow>());
+}
+
+void MainWindow::doLoadFile2Regions(const QString filename, const std::vector<dataSet::fileWindow>& windows)
+{
+    //the file is read on m_fileLoader2's thread, then published to m_dataSet2 by onFileLoader2Ended
+
+    //a new file replaces one that is still loading
+    if (m_fileLoader2.isRunning()) {
+        m_fileLoader2.abort();
+        m_fileLoader2.wait();
     }
-    else if (res == dataSet::loadFileResult::ERROR_FileReadFailure) {
-        LOG.Error("\"" % filename % "\" failed to read.");
+
+    m_fileLoadProgress2 = 0;
+    m_fileLoader2.startThread(filename, windows)
+        ?   LOG.Debug("loading \"" % filename % "\"" % describeWindows(windows) % " (file 2)")
+        :   LOG.Debug("failed to start loading file 2: loader thread already running");
+}
+
+void MainWindow::onFileLoader2Ended()
+{
+    QString filename;
+    std::vector<dataSet::fileWindow> windows;
+    dataSet::loadFileResult res;
+    std::unique_ptr<std::vector<unsigned char>> data;
+
+    if (!m_fileLoader2.getResult(filename, windows, res, data)) {
+        return; //still running (a newer load was started), or already published
     }
-    else if (res == dataSet::loadFileResult::ERROR_ActiveDataReadLock) {
-        LOG.Error("File load canceled: Current file is still in use.");
+
+    showFileLoadProgress();
+
+    if (res == dataSet::loadFileResult::SUCCESS) {
+        res = m_dataSet2->loadFileData(filename, std::move(data), windows);
     }
-    else {
-        FAIL();
+
+    //failed and canceled loads leave the current file loaded
+    if (reportLoadFileResult(res, filename)) {
+        updateUIforFile2Load();
     }
 
-    updateUIforFile2Load();
+    startDeferredComparison();
 }
 
 void MainWindow::doLoadFile2FromMemory(std::unique_ptr<std::vector<unsigned char>> data)
@@ -341,6 +439,9 @@ void MainWindow::updateUIforFile2Load()
 {
     m_dataSetView2 = QSharedPointer<dataSetView>::create(m_dataSet2);
 
+    //previous comparison results no longer apply
+    clearComparisonResults();
+
     applyUserSettingsTo(m_dataSetView2); //reapply user settings to new dataSetView
 
     if (m_dataSet2->isLoaded() && m_dataSetView2) {
@@ -350,6 +451,9 @@ void MainWindow::updateUIforFile2Load()
             m_dataSetView2->setSubsetStart(m_dataSetView1->getSubsetStart());
         }
 
+        //addresses of large files (or regions far into them) need more digits
+        setAddressColumnWidth(ui->textEdit_address2, m_dataSetView2);
+
         m_dataSetView2->updateByteGridDimensions(ui->textEdit_dataSet2);
         m_dataSetView2->printByteGrid(ui->textEdit_dataSet2, ui->textEdit_address2);
         updateScrollBarRange();
@@ -358,7 +462,7 @@ void MainWindow::updateUIforFile2Load()
         dataSet::sourceInfo sourceInfo = m_dataSet2->getSourceInfo();
 
         if      (sourceInfo.type == dataSet::sourceType::file) {
-            name = sourceInfo.name;
+            name = sourceInfo.name % describeWindows(m_dataSet2->getWindows());
         }
         else if (sourceInfo.type == dataSet::sourceType::memory) {
             name = "[loaded from memory]";
@@ -380,8 +484,142 @@ void MainWindow::updateUIforFile2Load()
     refreshTitleBarText();
 }
 
+/*static*/ QString MainWindow::describeWindows(const std::vector<dataSet::fileWindow>& windows)
+{
+    //" [offset:length, ...]" in hex (empty for a whole file)
+    if (windows.empty()) {
+        return QString();
+    }
+
+    QStringList items;
+    for (const dataSet::fileWindow& window : windows) {
+        items.append(QString("0x%1:0x%2").arg(window.offset, 0, 16).arg(window.length, 0, 16));
+    }
+
+    return " [" % items.join(", ") % "]";
+}
+
+bool MainWindow::getFileRegionsFromUser(const QString title, QString& filename, std::vector<dataSet::fileWindow>& windows)
+{
+    filename = QFileDialog::getOpenFileName(nullptr, title);
+    if (filename.isEmpty()) {
+        return false;
+    }
+
+    QString text = "0:0x10000000";
+    while (true) {
+        bool ok = false;
+        text = QInputDialog::getText(this, title,
+                                     "Regions to load (offset:length, separated by commas; decimal or 0x hex):",
+                                     QLineEdit::Normal, text, &ok);
+        if (!ok) {
+            return false;
+        }
+
+        if (dataSet::parseWindows(text, windows)) {
+            return true;
+        }
+
+        LOG.Error("Invalid file regions: \"" % text % "\"");
+    }
+}
+
+void MainWindow::doLoadFiles(const QString filename1, const QString filename2)
+{
+    //both files are read at the same time
+    doLoadFile1(filename1);
+    doLoadFile2(filename2);
+}
+
+bool MainWindow::deferComparisonUntilLoaded(const comparisonRequest request)
+{
+    //(waiting for the loader threads here would freeze the GUI until the files are read)
+    if (!m_fileLoader1.isLoading() && !m_fileLoader2.isLoading()) {
+        return false;
+    }
+
+    m_deferredComparison = request;
+    LOG.Info("the comparison will start when the files are loaded");
+    return true;
+}
+
+void MainWindow::startDeferredComparison()
+{
+    if (    comparisonRequest::none == m_deferredComparison
+         || m_fileLoader1.isLoading()
+         || m_fileLoader2.isLoading() ) {
+        return;
+    }
+
+    const comparisonRequest request = m_deferredComparison;
+    m_deferredComparison = comparisonRequest::none;
+
+    switch (request) {
+        case comparisonRequest::simple:
+            doSimpleCompare();
+            break;
+        case comparisonRequest::sequential:
+            on_actionSequential_compare_triggered();
+            break;
+        case comparisonRequest::largestBlock:
+            on_actionLargestBlock_compare_triggered();
+            break;
+        default:
+            FAIL();
+    }
+}
+
+void MainWindow::showFileLoadProgress()
+{
+    QStringList loading;
+    if (m_fileLoader1.isRunning()) {
+        loading.append(QString("File1 (Left) %1%").arg(m_fileLoadProgress1));
+    }
+    if (m_fileLoader2.isRunning()) {
+        loading.append(QString("File2 (Right) %1%").arg(m_fileLoadProgress2));
+    }
+
+    if (loading.isEmpty()) {
+        ui->statusBar->clearMessage();
+    }
+    else {
+        ui->statusBar->showMessage("Loading: " % loading.join("    "));
+    }
+}
+
+/*static*/ bool MainWindow::reportLoadFileResult(const dataSet::loadFileResult res, const QString filename)
+{
+    if      (res == dataSet::loadFileResult::SUCCESS) {
+        return true;
+    }
+    else if (res == dataSet::loadFileResult::ERROR_FileDoesNotExist) {
+        LOG.Error("File \"" % filename % "\" does not exist.");
+    }
+    else if (res == dataSet::loadFileResult::ERROR_FileReadFailure) {
+        LOG.Error("\"" % filename % "\" failed to read.");
+    }
+    else if (res == dataSet::loadFileResult::ERROR_ActiveDataReadLock) {
+        LOG.Error("File load canceled: Current file is still in use.");
+    }
+    else if (res == dataSet::loadFileResult::ERROR_Aborted) {
+        LOG.Info("Loading \"" % filename % "\" was canceled.");
+    }
+    else if (res == dataSet::loadFileResult::ERROR_UnsupportedCompression) {
+        LOG.Error("\"" % filename % "\" is compressed in a format this build can't decompress.");
+    }
+    else {
+        FAIL();
+    }
+
+    return false;
+}
+
 void MainWindow::doSimpleCompare()
 {
+    if (deferComparisonUntilLoaded(comparisonRequest::simple)) {
+        return;
+    }
+
     if (m_dataSet1.isNull() || m_dataSet2.isNull()) {
         return;
     }
@@ -518,6 +756,94 @@ void MainWindow::updateScrollBarRange()
         ASSERT_LE_INT_MAX(scrollPage);
         ui->verticalScrollBar->setPageStep(static_cast<int>(scrollPage));
     }
+
+    updateOverviewStrip();
+}
+
+void MainWindow::updateOverviewStrip()
+{
+    //the strip covers the larger dataSet, and marks the indices shown by either view
+    unsigned int indexCount = 0;
+    indexRange visibleRange(0,0);
+
+    auto include = [&](QSharedPointer<dataSet> ds, QSharedPointer<dataSetView> dsv) {
+        if (ds && ds->isLoaded()) {
+            indexCount = qMax(indexCount, ds->getSize());
+        }
+        if (dsv && dsv->getSubset().count() > visibleRange.count()) {
+            visibleRange = dsv->getSubset();
+        }
+    };
+
+    include(m_dataSet1, m_dataSetView1);
+    include(m_dataSet2, m_dataSetView2);
+
+    ui->overviewStrip->setIndexCount(indexCount);
+    ui->overviewStrip->setVisibleRange(visibleRange);
+}
+
+void MainWindow::setOverviewDensities(QSharedPointer<densityPyramid> density1, QSharedPointer<densityPyramid> density2)
+{
+    m_density1 = density1;
+    m_density2 = density2;
+    ui->overviewStrip->setDensities(m_density1, m_density2);
+}
+
+void MainWindow::navigateTo(const navigationIndex::target t, const bool forward)
+{
+    const int value = ui->verticalScrollBar->value();
+    ASSERT_NOT_NEGATIVE(value);
+
+    //the scroll position is a dataSet1 index; dataSet2 ranges are found from (and mapped back to) the aligned dataSet2 index
+    const unsigned int index1 = static_cast<unsigned int>(value);
+    const unsigned int index2 = getAlignedIndex2(index1);
+    const bool aligned = m_userSettings.alignedScrolling;
+
+    bool found = false;
+    unsigned int target = 0;
+
+    auto consider = [&](const unsigned int candidate) {
+        const bool inDirection = forward ? (candidate > index1) : (candidate < index1);
+        if (inDirection && (!found || (forward ? (candidate < target) : (candidate > target)))) {
+            target = candidate;
+            found = true;
+        }
+    };
+
+    unsigned int rangeStart;
+    if (forward ? m_navigationIndex1.findNext    (index1, t, rangeStart)
+                : m_navigationIndex1.findPrevious(index1, t, rangeStart)) {
+        consider(rangeStart);
+    }
+    if (forward ? m_navigationIndex2.findNext    (index2, t, rangeStart)
+                : m_navigationIndex2.findPrevious(index2, t, rangeStart)) {
+        consider(aligned ? m_offsetMap2to1.map(rangeStart) : rangeStart);
+    }
+
+    if (!found) {
+        LOG.Info(forward ? "no more ranges after this position" : "no more ranges before this position");
+        return;
+    }
+
+    ASSERT_LE_INT_MAX(target);
+    ui->verticalScrollBar->setValue(static_cast<int>(target));
+}
+
+void MainWindow::clearComparisonResults()
+{
+    setOverviewDensities(QSharedPointer<densityPyramid>(), QSharedPointer<densityPyramid>());
+    m_navigationIndex1.clear();
+    m_navigationIndex2.clear();
+    m_offsetMap1to2.clear();
+    m_offsetMap2to1.clear();
+}
+
+unsigned int MainWindow::getAlignedIndex2(const unsigned int index1)
+{
+    if (!m_userSettings.alignedScrolling) {
+        return index1;
+    }
+    return m_offsetMap1to2.map(index1);     //no alignment ranges: same index
 }
 
 void MainWindow::displayLogMessage(QString str, QColor color)
@@ -650,6 +976,43 @@ void MainWindow::on_actionLoad_File2_Right_triggered()
     }
 }
 
+void MainWindow::on_actionLoad_File1_Region_triggered()
+{
+    QString filename;
+    std::vector<dataSet::fileWindow> windows;
+    if (getFileRegionsFromUser("Load File 1 (Left) Regions", filename, windows)) {
+        doLoadFile1Regions(filename, windows);
+    }
+}
+
+void MainWindow::on_actionLoad_File2_Region_triggered()
+{
+    QString filename;
+    std::vector<dataSet::fileWindow> windows;
+    if (getFileRegionsFromUser("Load File 2 (Right) Regions", filename, windows)) {
+        doLoadFile2Regions(filename, windows);
+    }
+}
+
+/*static*/ void MainWindow::setAddressColumnWidth(hexField* const addressColumn, const QSharedPointer<dataSetView> view)
+{
+    //calculate the hexField width needed to draw the address text
+    //
+    //  Text is drawn in addressColumn->getDrawArea();
+    //  the rest of the widget's width is the frame and margins.
+    int frameAndMargins_px = addressColumn->width() - addressColumn->getDrawArea().width();
+
+    //"0x" and the view's address digits (at least 8)
+    const int addressLength = view ? static_cast<int>(view->getAddressLength()) : static_cast<int>(hexFormat::ADDRESS_LENGTH);
+
+    QFontMetrics qfm(addressColumn->font());
+    int addressWidth_px = qfm.width(QString(addressLength, '0'))    //get the width of an address (assuming MONOSPACE FONTS)
+                + frameAndMargins_px;                               //plus the frame and margins
+
+    //set the min & max width values; qt should always draw it at this width
+    addressColumn->setFixedWidth(addressWidth_px);
+}
+
 void MainWindow::onHexFieldFontChange()
 {
     //prevent misaligned/hidden address text:
@@ -659,32 +1022,8 @@ void MainWindow::onHexFieldFontChange()
     //todo: handle font changes from address column?
 
 
-    auto setAddressColumnWidth = [](QTextEdit* const textEdit)->void
-    {
-        //calculate the QTextEdit width needed to draw the address text
-        //
-        //  The drawable area is textEdit->viewport().
-        //  Text starts a bit inside this area; we can see where by moving the cursor
-        //  to the start of the control and measuring the cursor location.
-        textEdit->moveCursor(QTextCursor::Start);
-        QPoint topLeftCornerOfFirstChar = textEdit->cursorRect().topLeft();
-
-        //margins inside the viewport not used for text drawing
-        int leftMargin  = textEdit->contentsMargins().left();
-        int rightMargin = textEdit->contentsMargins().right();
-
-        QFontMetrics qfm(textEdit->font());
-        int addressWidth_px = qfm.width("0x00000000")   //get the width of an address (assuming MONOSPACE FONTS)
-                    + topLeftCornerOfFirstChar.x()      //plus the distance from the left edge to text start
-                    + leftMargin + rightMargin;         //plus the margins
-
-        //set the min & max width values; qt should always draw it at this width
-        textEdit->setFixedWidth(addressWidth_px);
-
-    };
-
-    setAddressColumnWidth(ui->textEdit_address1);
-    setAddressColumnWidth(ui->textEdit_address2);
+    setAddressColumnWidth(ui->textEdit_address1, m_dataSetView1);
+    setAddressColumnWidth(ui->textEdit_address2, m_dataSetView2);
 
     if (m_dataSetView1) {
         m_dataSetView1->updateByteGridDimensions(ui->textEdit_dataSet1);
@@ -778,6 +1117,43 @@ void MainWindow::onComparisonThreadEnded()
         m_dataSetView1->addDiffHighlighting(results.data1_unmatchedBlocks);
         m_dataSetView2->addDiffHighlighting(results.data2_unmatchedBlocks);
 
+        //unmatched blocks have no paired indices to differ from: they're left as unmatched density
+        auto density1 = QSharedPointer<densityPyramid>::create(m_dataSet1->getSize());
+        auto density2 = QSharedPointer<densityPyramid>::create(m_dataSet2->getSize());
+        for (const blockMatchSet& match : results.matches) {
+            for (unsigned int index : match.data1_BlockStartIndices) {
+                ASSERT(noSumOverflow(index, match.blockSize));
+                density1->add(indexRange(index, index + match.blockSize), densityPyramid::category::match);
+            }
+            for (unsigned int index : match.data2_BlockStartIndices) {
+                ASSERT(noSumOverflow(index, match.blockSize));
+                density2->add(indexRange(index, index + match.blockSize), densityPyramid::category::match);
+            }
+        }
+        clearComparisonResults();
+        setOverviewDensities(density1, density2);
+
+        for (const blockMatchSet& match : results.matches) {
+            for (unsigned int index : match.data1_BlockStartIndices) {
+                ASSERT(noSumOverflow(index, match.blockSize));
+                m_navigationIndex1.add(indexRange(index, index + match.blockSize), navigationIndex::target::matchBlock);
+            }
+            for (unsigned int index : match.data2_BlockStartIndices) {
+                ASSERT(noSumOverflow(index, match.blockSize));
+                m_navigationIndex2.add(indexRange(index, index + match.blockSize), navigationIndex::target::matchBlock);
+            }
+
+            //align the copies of each block in order (a block repeated in only one dataSet aligns with its first copy)
+            auto index1 = match.data1_BlockStartIndices.begin();
+            auto index2 = match.data2_BlockStartIndices.begin();
+            for ( ; index1 != match.data1_BlockStartIndices.end() && index2 != match.data2_BlockStartIndices.end(); ++index1, ++index2) {
+                m_offsetMap1to2.add(*index1, *index2, match.blockSize);
+                m_offsetMap2to1.add(*index2, *index1, match.blockSize);
+            }
+        }
+        for (const indexRange& r : results.data1_unmatchedBlocks) { m_navigationIndex1.add(r, navigationIndex::target::difference); }
+        for (const indexRange& r : results.data2_unmatchedBlocks) { m_navigationIndex2.add(r, navigationIndex::target::difference); }
+
         LOG.Info(summarizeResults(results));
 
         if (m_dataSet1) {
@@ -812,6 +1188,25 @@ void MainWindow::onComparisonThreadEnded()
         m_dataSetView1->addDiffHighlighting(results.file1_differences);
         m_dataSetView2->addDiffHighlighting(results.file2_differences);
 
+        auto density1 = QSharedPointer<densityPyramid>::create(m_dataSet1->getSize());
+        auto density2 = QSharedPointer<densityPyramid>::create(m_dataSet2->getSize());
+        for (const indexRange& r : results.file1_matches    ) { density1->add(r, densityPyramid::category::match     ); }
+        for (const indexRange& r : results.file2_matches    ) { density2->add(r, densityPyramid::category::match     ); }
+        for (const indexRange& r : results.file1_differences) { density1->add(r, densityPyramid::category::difference); }
+        for (const indexRange& r : results.file2_differences) { density2->add(r, densityPyramid::category::difference); }
+        clearComparisonResults();
+        setOverviewDensities(density1, density2);
+
+        for (const indexRange& r : results.file1_matches    ) { m_navigationIndex1.add(r, navigationIndex::target::matchBlock); }
+        for (const indexRange& r : results.file2_matches    ) { m_navigationIndex2.add(r, navigationIndex::target::matchBlock); }
+        for (const indexRange& r : results.file1_differences) { m_navigationIndex1.add(r, navigationIndex::target::difference); }
+        for (const indexRange& r : results.file2_differences) { m_navigationIndex2.add(r, navigationIndex::target::difference); }
+
+        for (const rangeMatch& alignmentRange : results.alignmentRanges) {
+            m_offsetMap1to2.add(alignmentRange);
+            m_offsetMap2to1.add(alignmentRange, true);
+        }
+
         LOG.Info(summarizeResults(results));
 
         if (m_dataSet1) {
@@ -828,8 +1223,8 @@ void MainWindow::onComparisonThreadEnded()
     }
 
 
-    m_dataSetView1->printByteGrid(ui->textEdit_dataSet1, ui->textEdit_address1);
-    m_dataSetView2->printByteGrid(ui->textEdit_dataSet2, ui->textEdit_address2);
+    //reprint both views (the dataSet2 view moves to the aligned index if aligned scrolling is on)
+    doScrollBar(ui->verticalScrollBar->value());
 
 STOPWATCH1.recordTime();
 STOPWATCH1.reportTimes(&Log::strMessageLvl2);
@@ -842,7 +1237,10 @@ void MainWindow::on_actionDoSimpleCompare_triggered()
 
 void MainWindow::on_actionStop_thread_triggered()
 {
+    m_deferredComparison = comparisonRequest::none;
     m_comparisonThread.abort();
+    m_fileLoader1.abort();
+    m_fileLoader2.abort();
 }
 
 void MainWindow::on_actionTest_triggered()
@@ -891,6 +1289,12 @@ void MainWindow::on_actionDebugFlag_triggered()
     LOG.Debug(QString("DEBUGFLAG1: %1").arg(DEBUGFLAG1));
 }
 
+void MainWindow::on_actionDetailed_debug_messages_toggled(bool checked)
+{
+    Log::setDetailedDebugEnabled(checked);
+    LOG.Debug(QString("detailed debug messages: %1").arg(checked ? "on" : "off"));
+}
+
 void MainWindow::on_actionSequential_compare_triggered()
 {
 STOPWATCH1.clear();
@@ -901,6 +1305,10 @@ STOPWATCH1.recordTime("Sequential Compare operation Total:");
         return;
     }
 
+    if (deferComparisonUntilLoaded(comparisonRequest::sequential)) {
+        return;
+    }
+
     m_comparisonThread.setDataSet1(m_dataSet1);
     m_comparisonThread.setDataSet2(m_dataSet2);
     m_comparisonThread.startThread(comparisonThread::comparisonAlgorithm::sequential)
@@ -918,6 +1326,10 @@ STOPWATCH1.recordTime("Largest Block Compare operation Total:");
         return;
     }
 
+    if (deferComparisonUntilLoaded(comparisonRequest::largestBlock)) {
+        return;
+    }
+
     m_comparisonThread.setDataSet1(m_dataSet1);
     m_comparisonThread.setDataSet2(m_dataSet2);
     m_comparisonThread.startThread(comparisonThread::comparisonAlgorithm::largestBlock)
@@ -1089,3 +1501,50 @@ void MainWindow::on_actionReset_triggered()
 {
     doSearchProcessing(searchProcessing::searchAction::none);
 }
+
+void MainWindow::on_actionNext_difference_triggered()
+{
+    navigateTo(navigationIndex::target::difference, true);
+}
+
+void MainWindow::on_actionPrevious_difference_triggered()
+{
+    navigateTo(navigationIndex::target::difference, false);
+}
+
+void MainWindow::on_actionNext_match_block_triggered()
+{
+    navigateTo(navigationIndex::target::matchBlock, true);
+}
+
+void MainWindow::on_actionPrevious_match_block_triggered()
+{
+    navigateTo(navigationIndex::target::matchBlock, false);
+}
+
+void MainWindow::on_actionAligned_scrolling_toggled(bool checked)
+{
+    m_userSettings.alignedScrolling = checked;
+    doScrollBar(ui->verticalScrollBar->value());
+}
+
+void MainWindow::on_actionCopy_visible_rows_triggered()
+{
+    //the rows shown in each view, as text (with the name of the file each came from)
+    QString text;
+
+    auto append = [&](QSharedPointer<dataSet> ds, QSharedPointer<dataSetView> dsv) {
+        if (!ds || !dsv) {
+            return;
+        }
+        if (!text.isEmpty()) {
+            text += "\n";
+        }
+        text += ds->getSourceInfo().name + "\n" + dsv->getVisibleRowsText();
+    };
+
+    append(m_dataSet1, m_dataSetView1);
+    append(m_dataSet2, m_dataSetView2);
+
+    QApplication::clipboard()->setText(text);
+}
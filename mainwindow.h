@@ -2,7 +2,10 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QApplication>
+#include <QClipboard>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QFile>
 #include <QMessageBox>
 #include <QTextStream>
@@ -22,9 +25,13 @@
 #include "defensivecoding.h"
 #include "comparison.h"
 #include "comparisonthread.h"
+#include "fileloaderthread.h"
 #include "offsetmetrics.h"
 #include "utilities.h"
 #include "searchprocessing.h"
+#include "densitypyramid.h"
+#include "navigationindex.h"
+#include "offsetmap.h"
 
 #include <set>
 
@@ -78,6 +85,10 @@ private slots:
 
     void onComparisonThreadEnded();
 
+    void onFileLoader1Ended();
+
+    void onFileLoader2Ended();
+
 
     void on_actionQuit_triggered();
 
@@ -85,6 +96,10 @@ private slots:
 
     void on_actionLoad_File2_Right_triggered();
 
+    void on_actionLoad_File1_Region_triggered();
+
+    void on_actionLoad_File2_Region_triggered();
+
     void onHexFieldFontChange();
 
     void on_actionSettings_triggered();
@@ -99,6 +114,8 @@ private slots:
 
     void on_actionDebugFlag_triggered();
 
+    void on_actionDetailed_debug_messages_toggled(bool checked);
+
     void on_actionSequential_compare_triggered();
 
     void on_actionLargestBlock_compare_triggered();
@@ -119,6 +136,18 @@ private slots:
 
     void on_actionReset_triggered();
 
+    void on_actionNext_difference_triggered();
+
+    void on_actionPrevious_difference_triggered();
+
+    void on_actionNext_match_block_triggered();
+
+    void on_actionPrevious_match_block_triggered();
+
+    void on_actionAligned_scrolling_toggled(bool checked);
+
+    void on_actionCopy_visible_rows_triggered();
+
 private:
 
     QSharedPointer<scrollWheelRedirector> m_scrollWheelRedirector;
@@ -128,14 +157,61 @@ private:
     void doScrollBar(int value);
 
     void doLoadFile1(const QString filename);
+    void doLoadFile1Regions(const QString filename, const std::vector<dataSet::fileWindow>& windows);
     void doLoadFile1FromMemory(std::unique_ptr<std::vector<unsigned char>> data);
     void updateUIforFile1Load();
 
     void doLoadFile2(const QString filename);
+    void doLoadFile2Regions(const QString filename, const std::vector<dataSet::fileWindow>& windows);
     void doLoadFile2FromMemory(std::unique_ptr<std::vector<unsigned char>> data);
     void updateUIforFile2Load();
 
+    //loads filename1 as file 1 and filename2 as file 2 (in parallel)
+    void doLoadFiles(const QString filename1, const QString filename2);
+
+    //comparisons that can be requested while files are loading
+    enum class comparisonRequest
+    {
+        none,
+        simple,
+        sequential,
+        largestBlock
+    };
+
+    //if a file is still loading, keeps request (replacing an earlier one) to start when the files are published,
+    // and returns true: comparisons use the files being loaded, not the ones they replace
+    bool deferComparisonUntilLoaded(const comparisonRequest request);
+
+    //starts the deferred comparison, if there is one and no file is still loading (called when a file load ends)
+    void startDeferredComparison();
+
+    //shows the progress of files being loaded in the status bar (or clears it)
+    void showFileLoadProgress();
+
+    //asks the user for a file and the regions of it to load; returns false if canceled
+    bool getFileRegionsFromUser(const QString title, QString& filename, std::vector<dataSet::fileWindow>& windows);
+
+    //text describing loaded file regions, for labels and the log (empty for a whole file)
+    static QString describeWindows(const std::vector<dataSet::fileWindow>& windows);
+
+    //logs a failed file load; returns true if res is SUCCESS
+    static bool reportLoadFileResult(const dataSet::loadFileResult res, const QString filename);
+
     void updateScrollBarRange();
+    void updateOverviewStrip();
+    void setOverviewDensities(QSharedPointer<densityPyramid> density1, QSharedPointer<densityPyramid> density2);
+
+    //scrolls to the next (or previous) range of kind t after (or before) the current scroll position
+    void navigateTo(const navigationIndex::target t, const bool forward);
+
+    //clears the overview, navigation and alignment data of the last comparison
+    void clearComparisonResults();
+
+    //the dataSet2 index shown with dataSet1 index (mapped through the alignment ranges if aligned scrolling is on)
+    unsigned int getAlignedIndex2(const unsigned int index1);
+    //sizes an address column to fit the addresses of view (or 32-bit addresses, if there is no view)
+    static void setAddressColumnWidth(hexField* const addressColumn, const QSharedPointer<dataSetView> view);
+
     void resizeHexField1();
     void resizeHexField2();
     void applyUserSettingsTo(QSharedPointer<dataSetView> ds);
@@ -158,6 +234,18 @@ private:
     QSharedPointer<dataSetView> m_dataSetView1;
     QSharedPointer<dataSetView> m_dataSetView2;
 
+    //match/difference densities of the last comparison results (shown by the overview strip)
+    QSharedPointer<densityPyramid> m_density1;
+    QSharedPointer<densityPyramid> m_density2;
+
+    //start indices of the last comparison results' differences and match blocks in each dataSet
+    navigationIndex m_navigationIndex1;
+    navigationIndex m_navigationIndex2;
+
+    //index mappings through the last comparison results' alignment ranges (or match blocks), for aligned scrolling
+    offsetMap m_offsetMap1to2;
+    offsetMap m_offsetMap2to1;
+
     void doSimpleCompare();
     void displayLogMessage(QString str, QColor color);
 
@@ -168,6 +256,14 @@ private:
 
     comparisonThread m_comparisonThread;
 
+    //read files on worker threads (file 1 and file 2 can load at the same time)
+    fileLoaderThread m_fileLoader1;
+    fileLoaderThread m_fileLoader2;
+    unsigned int m_fileLoadProgress1;   //percent
+    unsigned int m_fileLoadProgress2;
+
+    comparisonRequest m_deferredComparison;   //see deferComparisonUntilLoaded
+
 stopwatch STOPWATCH1;
 bool DEBUGFLAG1 = false;
 };
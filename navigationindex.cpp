@@ -0,0 +1,95 @@
+#include "navigationindex.h"
+
+#include <algorithm>
+#include <iterator>
+
+navigationIndex::navigationIndex()
+    :   m_ranges(),
+        m_sorted{true, true}
+{
+}
+
+void navigationIndex::add(const indexRange& range, const target t)
+{
+    if (0 == range.count()) {
+        return;
+    }
+
+    const unsigned int i = static_cast<unsigned int>(t);
+    ASSERT(i < TARGET_COUNT);
+
+    m_ranges[i].push_back(range);
+    m_sorted[i] = false;
+}
+
+void navigationIndex::clear()
+{
+    for (unsigned int i = 0; i < TARGET_COUNT; ++i) {
+        m_ranges[i].clear();
+        m_sorted[i] = true;
+    }
+}
+
+unsigned int navigationIndex::size(const target t)
+{
+    const std::vector<indexRange>& ranges = getRanges(t);
+
+    ASSERT_LE_UINT_MAX(ranges.size());
+    return static_cast<unsigned int>(ranges.size());
+}
+
+bool navigationIndex::findNext(const unsigned int index, const target t, unsigned int& rangeStart)
+{
+    const std::vector<indexRange>& ranges = getRanges(t);
+
+    auto it = std::upper_bound(ranges.begin(), ranges.end(), index,
+                               [](const unsigned int i, const indexRange& r){ return i < r.start; });
+    if (ranges.end() == it) {
+        return false;
+    }
+
+    rangeStart = it->start;
+    return true;
+}
+
+bool navigationIndex::findPrevious(const unsigned int index, const target t, unsigned int& rangeStart)
+{
+    const std::vector<indexRange>& ranges = getRanges(t);
+
+    auto it = std::lower_bound(ranges.begin(), ranges.end(), index,
+                               [](const indexRange& r, const unsigned int i){ return r.start < i; });
+    if (ranges.begin() == it) {
+        return false;
+    }
+
+    rangeStart = std::prev(it)->start;
+    return true;
+}
+
+std::vector<indexRange>& navigationIndex::getRanges(const target t)
+{
+    const unsigned int i = static_cast<unsigned int>(t);
+    ASSERT(i < TARGET_COUNT);
+
+    std::vector<indexRange>& ranges = m_ranges[i];
+
+    if (!m_sorted[i]) {
+        std::sort(ranges.begin(), ranges.end());
+
+        //merge overlapping ranges (touching ranges are left separate)
+        auto merged = ranges.begin();
+        for (auto it = ranges.begin() + 1; it < ranges.end(); ++it) {
+            if (it->start < merged->end) {
+                merged->end = std::max(merged->end, it->end);
+            }
+            else {
+                *(++merged) = *it;
+            }
+        }
+        ranges.erase(merged + 1, ranges.end());
+
+        m_sorted[i] = true;
+    }
+
+    return ranges;
+}
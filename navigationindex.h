@@ -0,0 +1,52 @@
+#ifndef NAVIGATIONINDEX_H
+#define NAVIGATIONINDEX_H
+
+#include <vector>
+
+#include "indexrange.h"
+#include "defensivecoding.h"
+
+/*
+    sorted start indices of comparison result ranges (differences and match blocks), for jumping between them
+
+    ranges of each kind are merged where they overlap (e.g., the same difference found twice),
+     but not where they only touch: adjacent match blocks are separate stops
+    ranges are sorted once (on the first query after ranges are added), and found with a binary search
+*/
+
+class navigationIndex
+{
+public:
+    enum class target
+    {
+        difference,
+        matchBlock
+    };
+
+    navigationIndex();
+
+    void add(const indexRange& range, const target t);
+    void clear();
+
+    //the number of stored ranges of kind t (after merging)
+    unsigned int size(const target t);
+
+    //finds the start of the first range of kind t that starts after index
+    // returns false if there isn't one
+    bool findNext(const unsigned int index, const target t, unsigned int& rangeStart);
+
+    //finds the start of the last range of kind t that starts before index
+    // returns false if there isn't one
+    bool findPrevious(const unsigned int index, const target t, unsigned int& rangeStart);
+
+private:
+    static const unsigned int TARGET_COUNT = 2;
+
+    //sorts and merges the ranges of kind t, if ranges were added since the last update
+    std::vector<indexRange>& getRanges(const target t);
+
+    std::vector<indexRange> m_ranges[TARGET_COUNT];
+    bool m_sorted[TARGET_COUNT];
+};
+
+#endif // NAVIGATIONINDEX_H
@@ -0,0 +1,65 @@
+#include "navigationindex.h"
+#include "gtestDefs.h"
+#include <gtest.h>
+
+TEST(navigationIndex, empty){
+    navigationIndex index;
+    unsigned int start = 0;
+
+    EXPECT_FALSE(index.findNext    (0, navigationIndex::target::difference, start));
+    EXPECT_FALSE(index.findPrevious(0, navigationIndex::target::difference, start));
+
+    index.add(indexRange(10,10), navigationIndex::target::difference);  //empty ranges aren't stored
+    EXPECT_EQ(0u, index.size(navigationIndex::target::difference));
+}
+
+TEST(navigationIndex, mergesOverlappingRanges){
+    navigationIndex index;
+    index.add(indexRange(50,60), navigationIndex::target::difference);
+    index.add(indexRange(10,20), navigationIndex::target::difference);
+    index.add(indexRange(15,25), navigationIndex::target::difference);  //overlaps
+    index.add(indexRange(25,30), navigationIndex::target::difference);  //touches: a separate range
+    index.add(indexRange(50,55), navigationIndex::target::difference);  //same start (e.g. found in both data sets)
+    index.add(indexRange(30,50), navigationIndex::target::matchBlock);  //a different kind
+    EXPECT_EQ(3u, index.size(navigationIndex::target::difference));
+    EXPECT_EQ(1u, index.size(navigationIndex::target::matchBlock));
+
+    //adjacent match blocks (e.g. from different match sets) are each a stop
+    unsigned int start = 0;
+    index.add(indexRange(50,70), navigationIndex::target::matchBlock);
+    EXPECT_TRUE(index.findNext(30, navigationIndex::target::matchBlock, start));
+    EXPECT_EQ(50u, start);
+    EXPECT_TRUE(index.findPrevious(50, navigationIndex::target::matchBlock, start));
+    EXPECT_EQ(30u, start);
+
+    index.clear();
+    EXPECT_EQ(0u, index.size(navigationIndex::target::difference));
+    EXPECT_EQ(0u, index.size(navigationIndex::target::matchBlock));
+}
+
+TEST(navigationIndex, findNextAndPrevious){
+    navigationIndex index;
+    for (unsigned int start : {400u, 100u, 300u, 200u}) {
+        index.add(indexRange(start, start + 10), navigationIndex::target::difference);
+    }
+    index.add(indexRange(150, 160), navigationIndex::target::matchBlock);
+
+    unsigned int start = 0;
+    EXPECT_TRUE(index.findNext(0, navigationIndex::target::difference, start));
+    EXPECT_EQ(100u, start);
+    EXPECT_TRUE(index.findNext(100, navigationIndex::target::difference, start));  //ranges starting after index
+    EXPECT_EQ(200u, start);
+    EXPECT_TRUE(index.findNext(105, navigationIndex::target::difference, start));
+    EXPECT_EQ(200u, start);
+    EXPECT_FALSE(index.findNext(400, navigationIndex::target::difference, start));
+
+    EXPECT_TRUE(index.findPrevious(400, navigationIndex::target::difference, start)); //ranges starting before index
+    EXPECT_EQ(300u, start);
+    EXPECT_TRUE(index.findPrevious(401, navigationIndex::target::difference, start));
+    EXPECT_EQ(400u, start);
+    EXPECT_FALSE(index.findPrevious(100, navigationIndex::target::difference, start));
+
+    EXPECT_TRUE(index.findNext(0, navigationIndex::target::matchBlock, start));
+    EXPECT_EQ(150u, start);
+    EXPECT_FALSE(index.findNext(150, navigationIndex::target::matchBlock, start));
+}
@@ -0,0 +1,108 @@
+#include "offsetmap.h"
+
+#include <algorithm>
+#include <climits>
+#include <iterator>
+
+offsetMap::offsetMap()
+    :   m_segments(),
+        m_sorted(true)
+{
+}
+
+void offsetMap::add(const unsigned int fromStart, const unsigned int toStart, const unsigned int count)
+{
+    if (0 == count) {
+        return;
+    }
+
+    ASSERT(noSumOverflow(fromStart, count));
+    ASSERT(noSumOverflow(toStart,   count));
+
+    m_segments.push_back(segment{fromStart, toStart, count});
+    m_sorted = false;
+}
+
+void offsetMap::add(const rangeMatch& range, const bool inverse /*= false*/)
+{
+    if (inverse) {
+        add(range.startIndexInFile2, range.startIndexInFile1, range.byteCount);
+    }
+    else {
+        add(range.startIndexInFile1, range.startIndexInFile2, range.byteCount);
+    }
+}
+
+void offsetMap::clear()
+{
+    m_segments.clear();
+    m_sorted = true;
+}
+
+unsigned int offsetMap::size()
+{
+    update();
+
+    ASSERT_LE_UINT_MAX(m_segments.size());
+    return static_cast<unsigned int>(m_segments.size());
+}
+
+unsigned int offsetMap::map(const unsigned int fromIndex)
+{
+    update();
+
+    if (m_segments.empty()) {
+        return fromIndex;
+    }
+
+    //the first segment starting after fromIndex
+    auto next = std::upper_bound(m_segments.begin(), m_segments.end(), fromIndex,
+                                 [](const unsigned int i, const segment& s){ return i < s.fromStart; });
+
+    long long toIndex;
+
+    if (m_segments.begin() == next) {
+        //before the first segment: continue its offset
+        toIndex = static_cast<long long>(next->toStart) - (next->fromStart - fromIndex);
+    }
+    else {
+        const segment& previous = *std::prev(next);
+        const unsigned int previousFromEnd = previous.fromStart + previous.count;
+        const unsigned int previousToEnd   = previous.toStart   + previous.count;
+
+        if (fromIndex < previousFromEnd || m_segments.end() == next) {
+            //inside the segment, or after the last segment: keep its offset
+            toIndex = static_cast<long long>(previous.toStart) + (fromIndex - previous.fromStart);
+        }
+        else {
+            //between segments: interpolate from the end of the previous one to the start of the next
+            const double fraction = static_cast<double>(fromIndex - previousFromEnd) / (next->fromStart - previousFromEnd);
+            toIndex =   static_cast<long long>(previousToEnd)
+                      + static_cast<long long>(fraction * (static_cast<double>(next->toStart) - previousToEnd));
+        }
+    }
+
+    return static_cast<unsigned int>(std::min(static_cast<long long>(UINT_MAX), std::max(0LL, toIndex)));
+}
+
+void offsetMap::update()
+{
+    if (m_sorted) {
+        return;
+    }
+
+    //stable: of segments with the same start, the first added one is kept
+    std::stable_sort(m_segments.begin(), m_segments.end(),
+                     [](const segment& a, const segment& b){ return a.fromStart < b.fromStart; });
+
+    //drop segments overlapping the previous kept segment
+    auto kept = m_segments.begin();
+    for (auto it = m_segments.begin() + 1; it < m_segments.end(); ++it) {
+        if (it->fromStart >= kept->fromStart + kept->count) {
+            *(++kept) = *it;
+        }
+    }
+    m_segments.erase(kept + 1, m_segments.end());
+
+    m_sorted = true;
+}
@@ -0,0 +1,55 @@
+#ifndef OFFSETMAP_H
+#define OFFSETMAP_H
+
+#include <vector>
+
+#include "rangematch.h"
+#include "defensivecoding.h"
+
+/*
+    maps indices in one data set to the corresponding indices in another, through matched ranges (e.g. alignment ranges)
+
+    the mapping is piecewise linear:
+        inside a matched range, indices keep their offset from the range start
+        between two matched ranges, indices are interpolated from the end of one to the start of the next
+        before the first (after the last) matched range, the first (last) range's offset is continued
+
+    ranges are sorted once (on the first lookup after ranges are added), so each lookup is a binary search
+     (a range overlapping a range that starts before it, in the mapped-from data set, is dropped)
+*/
+
+class offsetMap
+{
+public:
+    offsetMap();
+
+    //[fromStart, fromStart + count) maps to [toStart, toStart + count)
+    void add(const unsigned int fromStart, const unsigned int toStart, const unsigned int count);
+
+    //adds an alignment range, mapping file 1 indices to file 2 indices (or file 2 to file 1 if inverse is true)
+    void add(const rangeMatch& range, const bool inverse = false);
+
+    void clear();
+
+    //the number of stored ranges (after dropping overlapping ranges)
+    unsigned int size();
+
+    //the index corresponding to fromIndex (limited to [0, UINT_MAX]), or fromIndex if no ranges are stored
+    unsigned int map(const unsigned int fromIndex);
+
+private:
+    class segment {
+    public:
+        unsigned int fromStart;
+        unsigned int toStart;
+        unsigned int count;
+    };
+
+    //sorts the ranges and drops overlapping ones, if ranges were added since the last update
+    void update();
+
+    std::vector<segment> m_segments;    //sorted by fromStart (when m_sorted is true)
+    bool m_sorted;
+};
+
+#endif // OFFSETMAP_H
@@ -0,0 +1,53 @@
+#include "offsetmap.h"
+#include "gtestDefs.h"
+#include <gtest.h>
+
+TEST(offsetMap, empty){
+    offsetMap map;
+    EXPECT_EQ(0u, map.size());
+    EXPECT_EQ(1234u, map.map(1234));   //identity
+}
+
+TEST(offsetMap, insideAndOutsideRanges){
+    offsetMap map;
+    map.add(rangeMatch(300, 500, 100));
+    map.add(rangeMatch(100, 100, 100));
+    EXPECT_EQ(2u, map.size());
+
+    //inside ranges
+    EXPECT_EQ(100u, map.map(100));
+    EXPECT_EQ(199u, map.map(199));
+    EXPECT_EQ(500u, map.map(300));
+    EXPECT_EQ(550u, map.map(350));
+
+    //between ranges: interpolated from [200 -> 200] to [300 -> 500]
+    EXPECT_EQ(200u, map.map(200));
+    EXPECT_EQ(350u, map.map(250));
+
+    //before the first range and after the last one: their offsets continue
+    EXPECT_EQ( 50u, map.map( 50));
+    EXPECT_EQ(800u, map.map(600));
+
+    //limited to zero
+    offsetMap shifted;
+    shifted.add(100, 10, 50);
+    EXPECT_EQ(0u, shifted.map(50));
+}
+
+TEST(offsetMap, inverse){
+    offsetMap map;
+    map.add(rangeMatch(0, 1000, 100), true);
+    EXPECT_EQ(  0u, map.map(1000));
+    EXPECT_EQ( 50u, map.map(1050));
+}
+
+TEST(offsetMap, overlappingRangesAreDropped){
+    offsetMap map;
+    map.add(100, 0,   100);
+    map.add(150, 500, 100); //overlaps the first range
+    map.add(100, 900, 10);  //same start as the first range, added later
+    map.add(200, 200, 10);
+    EXPECT_EQ(2u, map.size());
+    EXPECT_EQ( 50u, map.map(150));
+    EXPECT_EQ(205u, map.map(205));
+}
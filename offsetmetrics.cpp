@@ -1,89 +1,82 @@
 #include "offsetmetrics.h"
 
-/*static*/ std::atomic_bool offsetMetrics::m_abort{false};
+#include <thread>
+#include <mutex>
 
-/*static*/ std::unique_ptr<rangeMatch>
-            offsetMetrics::getNextAlignmentRange(   const std::vector<unsigned char>& source,
-                                                    const std::vector<unsigned char>& target,
-                                                    const unsigned int sourceRangeStart,
-                                                    const indexRange sourceSearchRange,
-                                                    const indexRange targetSearchRange
-                                                    )
+/*static*/ std::atomic_bool offsetMetrics::m_abort{false};
+/*static*/ const unsigned int offsetMetrics::BAND_SOURCE_WINDOW_RADII;
+
+/*static*/ unsigned int offsetMetrics::getAlignmentRangeSizeAtIndices(  const byteSpan& source,
+                                                                        const byteSpan& target,
+                                                                        const indexRange& sourceSearchRange,
+                                                                        const indexRange& targetSearchRange,
+                                                                        const unsigned int sourceRangeStart,
+                                                                        const unsigned int targetRangeStart
+                                                                        )
 {
-
-    ASSERT(0 < target.size());                          //vectors should have contents
-    ASSERT(0 < source.size());
-    ASSERT(sourceSearchRange.end <= source.size());     //ranges shouldn't exceed vectors
-    ASSERT(targetSearchRange.end <= target.size());
-
     //returns the size of the alignment range starting at these indices in source and target:
     //an alignment range contains >50% index-to-index matching bytes between source and target,
     // and has matching bytes at its lowest and highest indices (i.e., non-matches on edges are excluded)
-    auto getAlignmentRangeSizeAtIndices = [&source, &target, &sourceSearchRange, &targetSearchRange]
-                                          (const unsigned int sourceRangeStart,
-                                           const unsigned int targetRangeStart)
-                                           -> unsigned int {
 
-        unsigned int rangeSize = 0;     //the result
-        unsigned int matchCount = 0;    //the number of paired indices between source and target that contain the same byte
+    unsigned int rangeSize = 0;     //the result
+    unsigned int matchCount = 0;    //the number of paired indices between source and target that contain the same byte
 
 
-        ASSERT(sourceSearchRange.contains(sourceRangeStart));   //make sure start indices are within search ranges
-        ASSERT(targetSearchRange.contains(targetRangeStart));
+    ASSERT(sourceSearchRange.contains(sourceRangeStart));   //make sure start indices are within search ranges
+    ASSERT(targetSearchRange.contains(targetRangeStart));
 
-        //limit search to within source & target ranges
-        const unsigned int searchLimit = std::min(  sourceSearchRange.end - sourceRangeStart,
-                                                    targetSearchRange.end - targetRangeStart  );
+    //limit search to within source & target ranges
+    const unsigned int searchLimit = std::min(  sourceSearchRange.end - sourceRangeStart,
+                                                targetSearchRange.end - targetRangeStart  );
 
-        for (unsigned int i = 0; i < searchLimit; ++i) {
+    for (unsigned int i = 0; i < searchLimit; ++i) {
 
-            unsigned int count = i + 1;   //indices compared so far
+        unsigned int count = i + 1;   //indices compared so far
 
-            //test for matching bytes between these ranges
-            if (    source[sourceRangeStart + i]
-                 == target[targetRangeStart + i] ) {
+        //test for matching bytes between these ranges
+        if (    source[sourceRangeStart + i]
+             == target[targetRangeStart + i] ) {
 
-                rangeSize = count;
-                ++matchCount;
-            }
-            else {
-
-                //if the match ratio just dropped below 50%, the range has ended (or never started)
-                if (matchCount*2 < count) {
-                    break;
-                }
-            }
+            rangeSize = count;
+            ++matchCount;
         }
+        else {
 
-        //either the loop was broken because the match ratio dropped below 50%,
-        // or the end of source or target has been reached
-        return rangeSize;
-    };
-
-
-    auto findAlignmentRange_fixedSourceIndex = [&source, &target, &getAlignmentRangeSizeAtIndices]
-                                               (const unsigned int sourceRangeStart,
-                                                const indexRange& targetSearchRange)
-                                                -> rangeMatch {
-
-        for (unsigned int i = targetSearchRange.start; i < targetSearchRange.end; ++i) {
-
-            unsigned int alignmentRangeSize = getAlignmentRangeSizeAtIndices(sourceRangeStart, i);
-            if (alignmentRangeSize > 1) {
-                return rangeMatch(sourceRangeStart, i, alignmentRangeSize);
+            //if the match ratio just dropped below 50%, the range has ended (or never started)
+            if (matchCount*2 < count) {
+                break;
             }
         }
+    }
 
-        //if this is reached, no alignment ranges were found
-        return rangeMatch(0,0,0);
-    };
+    //either the loop was broken because the match ratio dropped below 50%,
+    // or the end of source or target has been reached
+    return rangeSize;
+}
 
+/*static*/ std::unique_ptr<rangeMatch>
+            offsetMetrics::getNextAlignmentRange(   const byteSpan& source,
+                                                    const byteSpan& target,
+                                                    const unsigned int sourceRangeStart,
+                                                    const indexRange sourceSearchRange,
+                                                    const indexRange targetSearchRange
+                                                    )
+{
+
+    ASSERT(0 < target.size());                          //vectors should have contents
+    ASSERT(0 < source.size());
+    ASSERT(sourceSearchRange.end <= source.size());     //ranges shouldn't exceed vectors
+    ASSERT(targetSearchRange.end <= target.size());
 
     //look for an alignment range starting at sourceRangeStart
-    rangeMatch alignmentRange = findAlignmentRange_fixedSourceIndex(sourceRangeStart, targetSearchRange);
+    for (unsigned int i = targetSearchRange.start; i < targetSearchRange.end; ++i) {
+
+        unsigned int alignmentRangeSize
+            = getAlignmentRangeSizeAtIndices(source, target, sourceSearchRange, targetSearchRange, sourceRangeStart, i);
 
-    if (alignmentRange.byteCount) {
-        return std::unique_ptr<rangeMatch>(new rangeMatch(alignmentRange));
+        if (alignmentRangeSize > 1) {
+            return std::unique_ptr<rangeMatch>(new rangeMatch(sourceRangeStart, i, alignmentRangeSize));
+        }
     }
 
     //no match found
@@ -91,8 +84,8 @@
 }
 
 /*static*/ std::unique_ptr<rangeMatch>
-            offsetMetrics::getNextAlignmentRange(   const std::vector<unsigned char>& source,
-                                                    const std::vector<unsigned char>& target,
+            offsetMetrics::getNextAlignmentRange(   const byteSpan& source,
+                                                    const byteSpan& target,
                                                     const indexRange sourceSearchRange,
                                                     const indexRange targetSearchRange
                                                     )
@@ -116,8 +109,8 @@
 }
 
 /*static*/ std::unique_ptr<rangeMatch>
-            offsetMetrics::getNextAlignmentRange(   const std::vector<unsigned char>& source,
-                                                    const std::vector<unsigned char>& target,
+            offsetMetrics::getNextAlignmentRange(   const byteSpan& source,
+                                                    const byteSpan& target,
                                                     const indexRange sourceSearchRange,
                                                     //this should be sorted by increasing start index
                                                     const std::list<indexRange>& targetSearchRanges
@@ -143,196 +136,318 @@
     return nullptr;
 }
 
-/*static*/ bool offsetMetrics::isNonMatchRangeExcludable(   const std::vector<unsigned char>& source,
-                                                            const std::vector<unsigned char>& target,
-                                                            const indexRange sourceNonMatchRange,
-                                                            const indexRange targetNonMatchRange
+/*static*/ std::unique_ptr<rangeMatch>
+            offsetMetrics::getNextAlignmentRange_parallel(  const byteSpan& source,
+                                                            const byteSpan& target,
+                                                            const indexRange sourceSearchRange,
+                                                            //this should be sorted by increasing start index
+                                                            const std::list<indexRange>& targetSearchRanges,
+                                                            const unsigned int workerThreadCount
                                                             )
 {
     /*
-    decide if a non-matching range in an alignment range should be excluded:
-    i.e., the alignment range can be truncated at the start of this non-match range,
-     and the match search can continue from that point
+    the serial search checks every source index against a target range before moving to the next target range,
+     so its result is the first hit in this sequence of work items:
+        (target range 0, source block 0), (target range 0, source block 1), ... (target range 1, source block 0), ...
 
-    1. extend non-match range out to 2x its size in both directions (to the extent possible by file/range limits)
-    2. if either range match count is < block size, then (return true) exclude this non-matching range
-    3. otherwise, (return false) don't exclude
+    work items are handed out in that order; when a worker finds a hit, it is recorded if it's in the earliest item so far,
+     and workers stop searching any item that comes after it.
+     items before it keep going (they were already handed out), so the earliest hit is always found
 
-    todo: this prevents valid match ranges near the end of some test files, why?
-    todo: why does this work in general?
+    the next alignment range is usually close, so the first item is searched on this thread before any workers are started:
+     doCompare makes one search per alignment range, and starting threads would cost more than most of those searches
     */
 
+    ASSERT(indexRange::isNonDecreasingAndNonOverlapping(targetSearchRanges));
 
-    ASSERT(     sourceNonMatchRange.count()
-             == targetNonMatchRange.count() );
+    if (    workerThreadCount <= 1
+         || 0 == sourceSearchRange.count() ) {
+        return getNextAlignmentRange(source, target, sourceSearchRange, targetSearchRanges);
+    }
 
-    ASSERT_LE_UINT_MAX(source.size());
-    ASSERT_LE_UINT_MAX(target.size());
-    const indexRange sourceRange(0,static_cast<unsigned int>(source.size()));
-    const indexRange targetRange(0,static_cast<unsigned int>(target.size()));
+    const std::vector<indexRange> targetRanges(targetSearchRanges.begin(), targetSearchRanges.end());
 
-    //supplied non-matching ranges should actually be in the source and target
-    ASSERT(0 < sourceRange.getIntersection(sourceNonMatchRange).count());
-    ASSERT(0 < targetRange.getIntersection(targetNonMatchRange).count());
+    //split the source search range into enough blocks to keep all workers busy
+    const unsigned int minBlockSize = 256;
+    const unsigned int blockSize = std::max( minBlockSize, sourceSearchRange.count() / (workerThreadCount * 8) );
+    const unsigned int blocksPerTargetRange = (sourceSearchRange.count() - 1) / blockSize + 1;
 
+    const unsigned long long itemCount = static_cast<unsigned long long>(targetRanges.size()) * blocksPerTargetRange;
 
-    const unsigned int lowerTestRangeCount =
+    std::atomic<unsigned long long> nextItem{0};
+    std::atomic<unsigned long long> firstHitItem{std::numeric_limits<unsigned long long>::max()};
 
-    [&]() -> unsigned int {
-        //extend the lower test range size up to 2x the size of nonMatchRange
-        // constraints: start index shouldn't go negative
-        //              start index shouldn't go outside dataRange
-        auto get2XWithConstraints =
-        [](const indexRange& nonMatchRange, const indexRange& dataRange)-> unsigned int
-        {
-            const unsigned int lowerTestRangeStart
-                    = utilities::subtractClampToZero( nonMatchRange.start, 2*nonMatchRange.count() );
+    std::mutex resultMutex;
+    std::unique_ptr<rangeMatch> result;
 
-            indexRange lowerRange( lowerTestRangeStart, nonMatchRange.start );
+    auto searchItem = [&](const unsigned long long item) {
 
-            lowerRange = lowerRange.getIntersection(dataRange);
+        const indexRange& targetSearchRange = targetRanges[item / blocksPerTargetRange];
 
-            return lowerRange.count();
-        };
+        const unsigned int blockStart = sourceSearchRange.start
+                                      + static_cast<unsigned int>(item % blocksPerTargetRange) * blockSize;
+        const unsigned int blockEnd   = std::min( utilities::addClampToMax(blockStart, blockSize),
+                                                  sourceSearchRange.end );
 
-        const unsigned int sourceLowerTestRangeCount
-            = get2XWithConstraints(sourceNonMatchRange, sourceRange);
+        for (unsigned int i = blockStart; i < blockEnd; ++i) {
 
-        const unsigned int targetLowerTestRangeCount
-            = get2XWithConstraints(targetNonMatchRange, targetRange);
+            if (item > firstHitItem || m_abort) {
+                break;  //an earlier item already has a result (or the comparison was aborted)
+            }
 
-        //choose the lesser of the two range sizes:
-        // only equal-sized ranges can be compared index-to-index
-        return std::min(sourceLowerTestRangeCount,
-                        targetLowerTestRangeCount);
-    } ();
+            std::unique_ptr<rangeMatch> alignmentRange
+                = getNextAlignmentRange(source, target, i, sourceSearchRange, targetSearchRange);
 
-    const unsigned int upperTestRangeCount =
+            if (alignmentRange) {
 
-    [&]() -> unsigned int {
-        //extend the upper test range size up to 2x the size of nonMatchRange
-        // constraints: end index shouldn't overflow unsigned int
-        //              end index shouldn't go beyond the end of dataRange
-        auto get2XWithConstraints =
-        [](const indexRange& nonMatchRange, const indexRange& dataRange)-> unsigned int
-        {
-            const unsigned int upperTestRangeEnd
-                    = utilities::addClampToMax( nonMatchRange.end, 2*nonMatchRange.count() );
+                std::lock_guard<std::mutex> lock(resultMutex);
+                if (item < firstHitItem) {
+                    firstHitItem = item;
+                    result = std::move(alignmentRange);
+                }
+                break;
+            }
+        }
+    };
 
-            indexRange upperRange( nonMatchRange.end, upperTestRangeEnd );
+    auto worker = [&]() {
 
-            upperRange = upperRange.getIntersection(dataRange);
+        while (1) {
 
-            return upperRange.count();
-        };
+            const unsigned long long item = nextItem++;
 
-        const unsigned int sourceUpperTestRangeCount
-            = get2XWithConstraints(sourceNonMatchRange, sourceRange);
-
-        const unsigned int targetUpperTestRangeCount
-            = get2XWithConstraints(targetNonMatchRange, targetRange);
-
-        //choose the lesser of the two range sizes:
-        // only equal-sized ranges can be compared index-to-index
-        return std::min(sourceUpperTestRangeCount,
-                        targetUpperTestRangeCount);
-    } ();
-
-
-    ASSERT(sourceNonMatchRange.start >= lowerTestRangeCount);
-    const indexRange sourceLowerTestRange(sourceNonMatchRange.start - lowerTestRangeCount,
-                                          sourceNonMatchRange.start);
-
-    ASSERT(targetNonMatchRange.start >= lowerTestRangeCount);
-    const indexRange targetLowerTestRange(targetNonMatchRange.start - lowerTestRangeCount,
-                                          targetNonMatchRange.start);
-
-
-    ASSERT(noSumOverflow(sourceNonMatchRange.end, upperTestRangeCount));
-    const indexRange sourceUpperTestRange(sourceNonMatchRange.end,
-                                          sourceNonMatchRange.end + upperTestRangeCount);
-
-    ASSERT(noSumOverflow(targetNonMatchRange.end, upperTestRangeCount));
-    const indexRange targetUpperTestRange(targetNonMatchRange.end,
-                                          targetNonMatchRange.end + upperTestRangeCount);
-
-    ASSERT(    sourceLowerTestRange.count()
-            == targetLowerTestRange.count());
-    const unsigned int
-    lowerMatchCount = utilities::countMatchingIndices(  source,
-                                                        target,
-                                                        sourceLowerTestRange,
-                                                        targetLowerTestRange);
-    ASSERT(    sourceUpperTestRange.count()
-            == targetUpperTestRange.count());
-    const unsigned int
-    upperMatchCount = utilities::countMatchingIndices(  source,
-                                                        target,
-                                                        sourceUpperTestRange,
-                                                        targetUpperTestRange);
-
-    if (lowerMatchCount < sourceNonMatchRange.count()) {
-        return true;
+            if (    item >= itemCount
+                 || item >  firstHitItem
+                 || m_abort ) {
+                return;
+            }
+
+            searchItem(item);
+        }
+    };
+
+    //the first item, without starting any workers
+    searchItem(nextItem++);
+    if (result || 1 == itemCount || m_abort) {
+        return result;
     }
 
-    if (upperMatchCount < sourceNonMatchRange.count()) {
-        return true;
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < workerThreadCount; ++i) {
+        workers.emplace_back(worker);
     }
+    worker();   //this thread is a worker too
 
-    return false;
+    for (std::thread& t : workers) {
+        t.join();
+    }
+
+    return result;
 }
 
-/*static*/ bool offsetMetrics::truncateAlignmentRange(  const std::vector<unsigned char>& data1,
-                                                        const std::vector<unsigned char>& data2,
-                                                        rangeMatch& alignmentRange
+/*static*/ std::unique_ptr<rangeMatch>
+            offsetMetrics::getNextAlignmentRange_banded(    const byteSpan& source,
+                                                            const byteSpan& target,
+                                                            const indexRange sourceSearchRange,
+                                                            //this should be sorted by increasing start index
+                                                            const std::list<indexRange>& targetSearchRanges,
+                                                            const long long diagonal,
+                                                            const unsigned int bandRadius,
+                                                            diagonalMatchIndexCache* indexCache /*= nullptr*/
+                                                            )
+{
+    /*
+    most differences between related files are small insertions and deletions,
+     so the next alignment range is usually on (or near) the previous one's diagonal
+     (diagonal: target index - source index)
+
+    for each source index: check target indices in the band around the diagonal,
+     starting at the diagonal and moving outward (lower target index first at each distance)
+
+    if the next alignment range is off the band, the whole band up to the end of the source would be checked
+     before the full search takes over: the search stops after a window of source indices instead
+    */
+
+    ASSERT(indexRange::isNonDecreasingAndNonOverlapping(targetSearchRanges));
+    ASSERT(sourceSearchRange.end <= source.size());
+
+    const long long targetSize = static_cast<long long>(target.size());
+
+    //search ranges that overlap the band at the current source index
+    std::vector<indexRange> bandSearchRanges;
+
+    //the first search range that doesn't end before the band
+    // (the band only moves forward through the target, so the ranges it has passed are never checked again)
+    std::list<indexRange>::const_iterator firstBandSearchRange = targetSearchRanges.begin();
+
+    //the band covers the same diagonals at every source index:
+    // their match bitmaps are built once and reused as the search moves through the source
+    std::unique_ptr<diagonalMatchIndexCache> localIndexCache;
+    if (!indexCache) {
+        localIndexCache.reset(new diagonalMatchIndexCache(source, target, 2*bandRadius + 1));
+    }
+    diagonalMatchIndexCache& bandIndexCache = indexCache ? *indexCache : *localIndexCache;
+
+    const unsigned long long sourceWindow = static_cast<unsigned long long>(BAND_SOURCE_WINDOW_RADII) * bandRadius;
+    const unsigned int sourceWindowEnd = static_cast<unsigned int>(
+                std::min<unsigned long long>(sourceSearchRange.start + sourceWindow, sourceSearchRange.end) );
+
+    for (unsigned int i = sourceSearchRange.start; i < sourceWindowEnd; ++i) {
+
+        if (m_abort) {
+            return nullptr;
+        }
+
+        const long long center = static_cast<long long>(i) + diagonal;
+
+        //skip source indices whose band is entirely outside the target
+        const long long bandStart = std::max(center - bandRadius, 0LL);
+        const long long bandEnd   = std::min(center + bandRadius + 1, targetSize);
+        if (bandStart >= bandEnd) {
+            continue;
+        }
+
+        const indexRange band(static_cast<unsigned int>(bandStart), static_cast<unsigned int>(bandEnd));
+
+        while (    firstBandSearchRange != targetSearchRanges.end()
+                && firstBandSearchRange->end <= band.start ) {
+            ++firstBandSearchRange;
+        }
+
+        bandSearchRanges.clear();
+        for (auto it = firstBandSearchRange; it != targetSearchRanges.end(); ++it) {
+            if (it->start >= band.end) {
+                break;  //sorted: the rest are past the band
+            }
+            if (it->overlaps(band)) {
+                bandSearchRanges.push_back(*it);
+            }
+        }
+
+        //returns the size of the alignment range at (i, targetIndex) if targetIndex is in a search range
+        auto tryTargetIndex = [&](const long long targetIndex) -> unsigned int {
+
+            if (targetIndex < 0 || !band.contains(static_cast<unsigned int>(targetIndex))) {
+                return 0;
+            }
+
+            for (const indexRange& targetSearchRange : bandSearchRanges) {
+                if (targetSearchRange.contains(static_cast<unsigned int>(targetIndex))) {
+
+                    //an alignment range starts with a match:
+                    // don't build a match bitmap for a diagonal until it has one
+                    if (source[i] != target[static_cast<size_t>(targetIndex)]) {
+                        return 0;
+                    }
+
+                    diagonalMatchIndex& index = bandIndexCache.get(targetIndex - i);
+
+                    //the search won't return to earlier source indices
+                    index.releaseBefore(i);
+
+                    //limit search to within source & target ranges
+                    const unsigned int searchLimit = std::min(  sourceSearchRange.end  - i,
+                                                                targetSearchRange.end  - static_cast<unsigned int>(targetIndex) );
+
+                    return index.getAlignmentRangeSize(i, searchLimit);
+                }
+            }
+            return 0;
+        };
+
+        if (bandSearchRanges.empty()) {
+            continue;
+        }
+
+        //the diagonal itself, then the pair of target indices at each distance from it
+        const unsigned int centerRangeSize = tryTargetIndex(center);
+        if (centerRangeSize > 1) {
+            return std::unique_ptr<rangeMatch>(new rangeMatch(i, static_cast<unsigned int>(center), centerRangeSize));
+        }
+
+        for (long long distance = 1; distance <= bandRadius; ++distance) {
+
+            for (const long long targetIndex : {center - distance, center + distance}) {
+
+                const unsigned int alignmentRangeSize = tryTargetIndex(targetIndex);
+                if (alignmentRangeSize > 1) {
+                    return std::unique_ptr<rangeMatch>(
+                                new rangeMatch(i, static_cast<unsigned int>(targetIndex), alignmentRangeSize));
+                }
+            }
+        }
+    }
+
+    //no match found in the band
+    return nullptr;
+}
+
+/*static*/ bool offsetMetrics::truncateAlignmentRange(  const byteSpan& data1,
+                                                        const byteSpan& data2,
+                                                        rangeMatch& alignmentRange,
+                                                        diagonalMatchIndexCache* indexCache /*= nullptr*/
                                                         )
 {
     LOG.Debug("truncate alignment range");
 
-    std::list<indexRange> file1_matches;
-    std::list<indexRange> file1_differences;
-    std::list<indexRange> file2_matches;
-    std::list<indexRange> file2_differences;
+    if ( !alignmentRange.byteCount ) {
+        return false;
+    }
 
-    offsetMetrics::getAlignmentRangeDiff( data1, data2, alignmentRange,
-                                          file1_matches,
-                                          file1_differences,
-                                          file2_matches,
-                                          file2_differences);
+    ASSERT(data1.size() >= alignmentRange.getEndInFile1());
+    ASSERT(data2.size() >= alignmentRange.getEndInFile2());
 
-    ASSERT(    file1_matches.size()
-            == file2_matches.size());
+    /*
+    walk the difference runs of the alignment range in order, and truncate at the first excludable one:
+     a difference run is excludable (the alignment range can end before it, and the match search can continue from there)
+     if the test range on either side of it, extended up to 2x its size (within both files), has fewer matches than it has bytes
 
-    ASSERT(    file1_differences.size()
-            == file2_differences.size());
+    the match bitmap of the alignment range's diagonal gives the run boundaries and test range match counts
+     without rescanning bytes or building diff lists
+    */
+
+    diagonalMatchIndexCache localIndexCache(data1, data2, 1);
+    diagonalMatchIndex& index = (indexCache ? *indexCache : localIndexCache).get(
+                                              static_cast<long long>(alignmentRange.startIndexInFile2)
+                                            - static_cast<long long>(alignmentRange.startIndexInFile1) );
 
-    std::list<indexRange>::const_iterator i1 = file1_differences.begin();
-    std::list<indexRange>::const_iterator i2 = file2_differences.begin();
+    //the source indices on this diagonal: test ranges are limited to these (i.e., by both file sizes)
+    const indexRange diagonalRange = index.getSourceRange();
 
-    while(i1 != file1_differences.end()) {
+    const unsigned int end = alignmentRange.getEndInFile1();
+    unsigned int i = alignmentRange.startIndexInFile1;
 
-        ASSERT(    i1->count()
-                == i2->count());
+    while (i < end) {
+
+        //next difference run in file1 (the file2 run is at the same offset from the alignment range start)
+        const unsigned int nonMatchStart = index.findNext(i, end, false);
+        if (nonMatchStart == end) {
+            break;
+        }
+        const unsigned int nonMatchEnd = index.findNext(nonMatchStart, end, true);
+        const unsigned int nonMatchCount = nonMatchEnd - nonMatchStart;
 
-        if (offsetMetrics::isNonMatchRangeExcludable(data1, data2, *i1, *i2)) {
+        //extend test ranges up to 2x the size of the non-match range in both directions
+        const unsigned int testRangeLimit = utilities::addClampToMax(nonMatchCount, nonMatchCount);
 
-            ASSERT(    i1->start - alignmentRange.startIndexInFile1
-                    == i2->start - alignmentRange.startIndexInFile2);
+        const unsigned int lowerTestRangeCount = std::min(testRangeLimit, nonMatchStart - diagonalRange.start);
+        const unsigned int upperTestRangeCount = std::min(testRangeLimit, diagonalRange.end - nonMatchEnd);
 
-            ASSERT(                    i1->start >=alignmentRange.startIndexInFile1);
+        if (   index.countMatches(nonMatchStart - lowerTestRangeCount, lowerTestRangeCount) < nonMatchCount
+            || index.countMatches(nonMatchEnd, upperTestRangeCount) < nonMatchCount ) {
 
-            alignmentRange.byteCount = i1->start - alignmentRange.startIndexInFile1;
+            ASSERT(nonMatchStart >= alignmentRange.startIndexInFile1);
+            alignmentRange.byteCount = nonMatchStart - alignmentRange.startIndexInFile1;
             return true;
         }
 
-        ++i1;
-        ++i2;
+        i = nonMatchEnd;
     }
     return false;
 }
 
-/*static*/ void offsetMetrics::getAlignmentRangeDiff(   const std::vector<unsigned char>& file1,
-                                                        const std::vector<unsigned char>& file2,
+/*static*/ void offsetMetrics::getAlignmentRangeDiff(   const byteSpan& file1,
+                                                        const byteSpan& file2,
                                                         const rangeMatch& alignmentRange,
                                                         std::list<indexRange>& file1_matches,
                                                         std::list<indexRange>& file1_differences,
@@ -408,10 +523,11 @@
 
 /*static*/
 std::unique_ptr<offsetMetrics::results>
-offsetMetrics::doCompare(   const std::vector<unsigned char>& data1,
-                            const std::vector<unsigned char>& data2 )
+offsetMetrics::doCompare(   const byteSpan& data1,
+                            const byteSpan& data2,
+                            const options& settings /*= options()*/ )
 {
-    m_abort = false; //clear abort flag
+    //(the abort flag isn't cleared here: an abort requested before the comparison starts still applies, see clearAbort)
 
     auto Results = std::unique_ptr<offsetMetrics::results>( new offsetMetrics::results );
 
@@ -426,6 +542,14 @@ offsetMetrics::doCompare(   const std::vector<unsigned char>& data1,
     unsigned int sourceStartIndex = 0;
     std::list<rangeMatch> alignmentRanges;
 
+    //the diagonal (target index - source index) of the last accepted alignment range
+    // (before the first one is found: the expected diagonal, if any)
+    long long diagonal = settings.initialDiagonal;
+
+    //match bitmaps for the recently searched diagonals (the band around the last accepted alignment range),
+    // shared by the banded searches and alignment range truncation
+    diagonalMatchIndexCache indexCache(data1, data2, 2*(2*settings.searchBandRadius + 1));
+
     while(1) {
 
         if (m_abort) {
@@ -454,12 +578,23 @@ offsetMetrics::doCompare(   const std::vector<unsigned char>& data1,
         ASSERT_LE_UINT_MAX(data1.size());
         indexRange sourceSearchRange(sourceStartIndex, static_cast<unsigned int>(data1.size()));
 
-        std::unique_ptr<rangeMatch> rangeResult
-            = offsetMetrics::getNextAlignmentRange(data1, data2, sourceSearchRange, targetSearchRanges);
+        std::unique_ptr<rangeMatch> rangeResult;
+
+        if (settings.searchBandRadius) {
+            //search near the previous alignment range's diagonal first
+            rangeResult = offsetMetrics::getNextAlignmentRange_banded(data1, data2, sourceSearchRange, targetSearchRanges,
+                                                                      diagonal, settings.searchBandRadius, &indexCache);
+        }
+
+        if (!rangeResult && !m_abort) {
+            //no alignment range in the band (or banded search is disabled): search the full target
+            rangeResult = offsetMetrics::getNextAlignmentRange_parallel(data1, data2, sourceSearchRange, targetSearchRanges,
+                                                                        settings.workerThreadCount);
+        }
 
         if (rangeResult){
 
-            truncateAlignmentRange(data1, data2, *rangeResult);
+            truncateAlignmentRange(data1, data2, *rangeResult, &indexCache);
 
             LOG.Info(QString("getNextAlignmentRange: %1, %2; %3")
                             .arg(rangeResult->startIndexInFile1)
@@ -468,6 +603,9 @@ offsetMetrics::doCompare(   const std::vector<unsigned char>& data1,
 
             sourceStartIndex = rangeResult->getEndInFile1();
 
+            diagonal =  static_cast<long long>(rangeResult->startIndexInFile2)
+                      - static_cast<long long>(rangeResult->startIndexInFile1);
+
             alignmentRanges.push_back(*rangeResult);
         }
         else
@@ -491,6 +629,8 @@ offsetMetrics::doCompare(   const std::vector<unsigned char>& data1,
                                                         Results->file2_differences   );
     }
 
+    Results->alignmentRanges = std::move(alignmentRanges);
+
     return Results;
 }
 
@@ -498,3 +638,8 @@ offsetMetrics::doCompare(   const std::vector<unsigned char>& data1,
 {
     m_abort = true;
 }
+
+/*static*/ void offsetMetrics::clearAbort()
+{
+    m_abort = false;
+}
@@ -8,7 +8,9 @@
 #include <atomic>
 
 #include "indexrange.h"
+#include "bytespan.h"
 #include "rangematch.h"
+#include "diagonalmatchindexcache.h"
 #include "utilities.h"
 #include "defensivecoding.h"
 
@@ -32,48 +34,92 @@ public:
         std::list<indexRange> file2_matches;
         std::list<indexRange> file2_differences;
 
+        //the alignment ranges the matches and differences were found in (in the order they were found)
+        std::list<rangeMatch> alignmentRanges;
+
         bool aborted;
         bool internalError;
 
         results() : aborted(false), internalError(false) {}
     };
 
+    class options {
+    public:
+        //banded search (opt-in):
+        // target offsets within this distance of the previous alignment range's diagonal
+        // are searched before falling back to a full target search (0 disables banded search)
+        //the results can differ from the full search's: an alignment range in the band is used
+        // even if one off the band starts at an earlier source index
+        unsigned int searchBandRadius;
+
+        //full target searches are split across this many threads (1: search serially)
+        unsigned int workerThreadCount;
+
+        //the diagonal (target index - source index) the first banded search is centered on
+        // (e.g. the main offset shift found by chunkTriage)
+        long long initialDiagonal;
+
+        options() : searchBandRadius(0), workerThreadCount(1), initialDiagonal(0) {}
+    };
+
 
 
 
-    static std::unique_ptr<rangeMatch> getNextAlignmentRange(   const std::vector<unsigned char>& source,
-                                                                const std::vector<unsigned char>& target,
+    static std::unique_ptr<rangeMatch> getNextAlignmentRange(   const byteSpan& source,
+                                                                const byteSpan& target,
                                                                 const unsigned int sourceRangeStart,
                                                                 const indexRange sourceSearchRange,
                                                                 const indexRange targetSearchRange
                                                                 );
 
-    static std::unique_ptr<rangeMatch> getNextAlignmentRange(   const std::vector<unsigned char>& source,
-                                                                const std::vector<unsigned char>& target,
+    static std::unique_ptr<rangeMatch> getNextAlignmentRange(   const byteSpan& source,
+                                                                const byteSpan& target,
                                                                 const indexRange sourceSearchRange,
                                                                 const indexRange targetSearchRange
                                                                 );
 
-    static std::unique_ptr<rangeMatch> getNextAlignmentRange( const std::vector<unsigned char>& source,
-                                                              const std::vector<unsigned char>& target,
+    static std::unique_ptr<rangeMatch> getNextAlignmentRange( const byteSpan& source,
+                                                              const byteSpan& target,
                                                               const indexRange sourceSearchRange,
                                                               //this should be sorted by increasing start index
                                                               const std::list<indexRange>& targetSearchRanges
                                                               );
 
-    static bool isNonMatchRangeExcludable(  const std::vector<unsigned char>& source,
-                                            const std::vector<unsigned char>& target,
-                                            const indexRange sourceNonMatchRange,
-                                            const indexRange targetNonMatchRange
-                                            );
-
-    static bool truncateAlignmentRange( const std::vector<unsigned char>& data1,
-                                        const std::vector<unsigned char>& data2,
-                                              rangeMatch& alignmentRange
+    //same result as the serial search above, but the search is split into (target range, source block) work items
+    // which are searched by workerThreadCount threads; items after the first one with a result are canceled
+    //  (the first item is searched before the threads are started: if it has the result, no threads are used)
+    static std::unique_ptr<rangeMatch> getNextAlignmentRange_parallel(  const byteSpan& source,
+                                                                        const byteSpan& target,
+                                                                        const indexRange sourceSearchRange,
+                                                                        //this should be sorted by increasing start index
+                                                                        const std::list<indexRange>& targetSearchRanges,
+                                                                        const unsigned int workerThreadCount
+                                                                        );
+
+    //searches only target indices within bandRadius of (source index + diagonal),
+    // closest to the diagonal first, for the first BAND_SOURCE_WINDOW_RADII*bandRadius source indices
+    // of sourceSearchRange; returns nullptr if that part of the band contains no alignment range
+    static std::unique_ptr<rangeMatch> getNextAlignmentRange_banded(    const byteSpan& source,
+                                                                        const byteSpan& target,
+                                                                        const indexRange sourceSearchRange,
+                                                                        //this should be sorted by increasing start index
+                                                                        const std::list<indexRange>& targetSearchRanges,
+                                                                        const long long diagonal,
+                                                                        const unsigned int bandRadius,
+                                                                        //match bitmaps can be kept here between calls
+                                                                        // (it must be for the same source and target)
+                                                                        diagonalMatchIndexCache* indexCache = nullptr
+                                                                        );
+
+    static bool truncateAlignmentRange( const byteSpan& data1,
+                                        const byteSpan& data2,
+                                              rangeMatch& alignmentRange,
+                                        //if supplied, the alignment range's match bitmap comes from here (it must be for data1 and data2)
+                                        diagonalMatchIndexCache* indexCache = nullptr
                                         );
 
-    static void getAlignmentRangeDiff(  const std::vector<unsigned char>& file1,
-                                        const std::vector<unsigned char>& file2,
+    static void getAlignmentRangeDiff(  const byteSpan& file1,
+                                        const byteSpan& file2,
                                         const rangeMatch& alignmentRange,
                                         std::list<indexRange>& file1_matches,
                                         std::list<indexRange>& file1_differences,
@@ -83,14 +129,30 @@ public:
 
     static
     std::unique_ptr<offsetMetrics::results>
-    doCompare(  const std::vector<unsigned char>& data1,
-                const std::vector<unsigned char>& data2 );
+    doCompare(  const byteSpan& data1,
+                const byteSpan& data2,
+                const options& settings = options() );
 
     static void abort();
+    static void clearAbort();   //call before starting a new comparison
+
+    //the banded search gives up (so the full search can take over) after this many band radii of source indices:
+    // an edit that moves the next alignment range off the band costs at most this*(2*radius + 1)*radius probes
+    static const unsigned int BAND_SOURCE_WINDOW_RADII = 8;
 
 private:
     static std::atomic_bool m_abort;  //abort flag
 
+    //returns the size of the alignment range starting at these indices in source and target
+    // (0 or 1 if there isn't one: valid alignment ranges have a size > 1)
+    static unsigned int getAlignmentRangeSizeAtIndices( const byteSpan& source,
+                                                        const byteSpan& target,
+                                                        const indexRange& sourceSearchRange,
+                                                        const indexRange& targetSearchRange,
+                                                        const unsigned int sourceRangeStart,
+                                                        const unsigned int targetRangeStart
+                                                        );
+
 };
 
 #endif // OFFSETMETRICS_H
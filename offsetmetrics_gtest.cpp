@@ -0,0 +1,380 @@
+#include <random>
+
+#include "offsetmetrics.h"
+#include "gtestDefs.h"
+#include <gtest.h>
+
+namespace {
+
+    //a copy of data with some short insertions and deletions (and a few changed bytes)
+    std::vector<unsigned char> makeEditedCopy(const std::vector<unsigned char>& data, const unsigned int seed, const unsigned int alphabetSize)
+    {
+        std::mt19937 generator(seed);
+        std::vector<unsigned char> edited(data);
+
+        for (unsigned int edit = 0; edit < 12; ++edit) {
+            const size_t at = generator() % edited.size();
+            const unsigned int length = 1 + generator() % 40;
+
+            switch (generator() % 3) {
+                case 0: {
+                    const std::vector<unsigned char> inserted = gtestDefs::makeTestData(length, generator(), alphabetSize);
+                    edited.insert(edited.begin() + at, inserted.begin(), inserted.end());
+                    break;
+                }
+                case 1:
+                    edited.erase(edited.begin() + at, edited.begin() + std::min(edited.size(), at + length));
+                    break;
+                default:
+                    edited[at] = static_cast<unsigned char>(edited[at] + 1);
+                    break;
+            }
+        }
+        return edited;
+    }
+
+    //target search ranges: the whole target, minus a few gaps (as if alignment ranges had been found there)
+    std::list<indexRange> makeTargetSearchRanges(const unsigned int targetSize, const unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::list<indexRange> ranges;
+
+        unsigned int start = 0;
+        while (start < targetSize) {
+            const unsigned int end = std::min(targetSize, start + 1 + static_cast<unsigned int>(generator() % (targetSize/3)));
+            ranges.push_back(indexRange(start, end));
+            start = end + static_cast<unsigned int>(generator() % 200);
+        }
+        return ranges;
+    }
+
+    //the banded search, one target index at a time: for each source index in the window, the band's target indices
+    // closest to the diagonal first (lower first at each distance), using the serial search at each one
+    std::unique_ptr<rangeMatch> bandedReference(const std::vector<unsigned char>& source,
+                                                const std::vector<unsigned char>& target,
+                                                const indexRange sourceSearchRange,
+                                                const std::list<indexRange>& targetSearchRanges,
+                                                const long long diagonal,
+                                                const unsigned int bandRadius)
+    {
+        const unsigned int windowEnd = std::min(sourceSearchRange.end, sourceSearchRange.start + offsetMetrics::BAND_SOURCE_WINDOW_RADII*bandRadius);
+
+        for (unsigned int i = sourceSearchRange.start; i < windowEnd; ++i) {
+            for (long long distance = 0; distance <= bandRadius; ++distance) {
+                for (const long long targetIndex : {i + diagonal - distance, i + diagonal + distance}) {
+
+                    for (const indexRange& range : targetSearchRanges) {
+                        if (targetIndex < 0 || !range.contains(static_cast<unsigned int>(targetIndex))) {
+                            continue;
+                        }
+
+                        //(the serial search from targetIndex returns a range at targetIndex if there is one there)
+                        std::unique_ptr<rangeMatch> result
+                                = offsetMetrics::getNextAlignmentRange(source, target, i, sourceSearchRange,
+                                                                       indexRange(static_cast<unsigned int>(targetIndex), range.end));
+                        if (result && result->startIndexInFile2 == targetIndex) {
+                            return result;
+                        }
+                    }
+
+                    if (0 == distance) {
+                        break;
+                    }
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    //alignment range truncation as it was before match bitmaps, one byte at a time:
+    // the difference runs come from getAlignmentRangeDiff, and the test ranges' matches are counted bytewise
+    bool truncateReference(const std::vector<unsigned char>& data1, const std::vector<unsigned char>& data2, rangeMatch& alignmentRange)
+    {
+        std::list<indexRange> file1_matches;
+        std::list<indexRange> file1_differences;
+        std::list<indexRange> file2_matches;
+        std::list<indexRange> file2_differences;
+        offsetMetrics::getAlignmentRangeDiff(data1, data2, alignmentRange, file1_matches, file1_differences, file2_matches, file2_differences);
+
+        const indexRange range1(0, static_cast<unsigned int>(data1.size()));
+        const indexRange range2(0, static_cast<unsigned int>(data2.size()));
+
+        auto i2 = file2_differences.begin();
+        for (const indexRange& run1 : file1_differences) {
+            const indexRange& run2 = *i2++;
+            const unsigned int count = run1.count();
+
+            //test ranges: up to 2x the run size on each side, within both files
+            const unsigned int lowerCount = std::min(
+                        indexRange(utilities::subtractClampToZero(run1.start, 2*count), run1.start).getIntersection(range1).count(),
+                        indexRange(utilities::subtractClampToZero(run2.start, 2*count), run2.start).getIntersection(range2).count() );
+            const unsigned int upperCount = std::min(
+                        indexRange(run1.end, run1.end + 2*count).getIntersection(range1).count(),
+                        indexRange(run2.end, run2.end + 2*count).getIntersection(range2).count() );
+
+            const unsigned int lowerMatches = utilities::countMatchingIndices(data1, data2, indexRange(run1.start - lowerCount, run1.start),
+                                                                                            indexRange(run2.start - lowerCount, run2.start));
+            const unsigned int upperMatches = utilities::countMatchingIndices(data1, data2, indexRange(run1.end, run1.end + upperCount),
+                                                                                            indexRange(run2.end, run2.end + upperCount));
+
+            if (lowerMatches < count || upperMatches < count) {
+                alignmentRange.byteCount = run1.start - alignmentRange.startIndexInFile1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //checks truncateAlignmentRange (with and without a cache) against the reference; returns the reference's result
+    rangeMatch expectTruncatedAsReference(const std::vector<unsigned char>& data1, const std::vector<unsigned char>& data2, const rangeMatch& alignmentRange)
+    {
+        rangeMatch expected(alignmentRange);
+        const bool expectedTruncated = truncateReference(data1, data2, expected);
+
+        rangeMatch truncated(alignmentRange);
+        EXPECT_EQ(expectedTruncated, offsetMetrics::truncateAlignmentRange(data1, data2, truncated));
+        EXPECT_EQ(expected.byteCount, truncated.byteCount);
+
+        diagonalMatchIndexCache cache(data1, data2, 2);
+        rangeMatch cacheTruncated(alignmentRange);
+        EXPECT_EQ(expectedTruncated, offsetMetrics::truncateAlignmentRange(data1, data2, cacheTruncated, &cache));
+        EXPECT_EQ(expected.byteCount, cacheTruncated.byteCount);
+
+        return expected;
+    }
+
+    void expectEqual(const std::unique_ptr<rangeMatch>& expected, const std::unique_ptr<rangeMatch>& actual)
+    {
+        ASSERT_EQ(nullptr == expected, nullptr == actual);
+        if (expected) {
+            EXPECT_EQ(expected->startIndexInFile1, actual->startIndexInFile1);
+            EXPECT_EQ(expected->startIndexInFile2, actual->startIndexInFile2);
+            EXPECT_EQ(expected->byteCount,         actual->byteCount);
+        }
+    }
+
+}
+
+TEST(offsetMetrics, bandedSearchMatchesReference){
+    for (unsigned int seed = 0; seed < 20; ++seed) {
+
+        //a large alphabet, so the band has few alignment ranges and the search goes on past the first source indices
+        const std::vector<unsigned char> source = gtestDefs::makeTestData(1500, seed, 64);
+        const std::vector<unsigned char> target = makeEditedCopy(source, seed + 100, 64);
+        const std::list<indexRange> targetSearchRanges = makeTargetSearchRanges(static_cast<unsigned int>(target.size()), seed);
+
+        for (const long long diagonal : {0LL, 25LL, -40LL, 1000LL}) {
+            for (const unsigned int sourceStart : {0u, 700u}) {
+
+                const indexRange sourceSearchRange(sourceStart, static_cast<unsigned int>(source.size()));
+
+                //with and without a cache kept by the caller
+                diagonalMatchIndexCache cache(source, target, 2*16 + 1);
+
+                const std::unique_ptr<rangeMatch> expected = bandedReference(source, target, sourceSearchRange, targetSearchRanges, diagonal, 16);
+                expectEqual(expected, offsetMetrics::getNextAlignmentRange_banded(source, target, sourceSearchRange, targetSearchRanges, diagonal, 16));
+                expectEqual(expected, offsetMetrics::getNextAlignmentRange_banded(source, target, sourceSearchRange, targetSearchRanges, diagonal, 16, &cache));
+            }
+        }
+    }
+}
+
+TEST(offsetMetrics, bandedSearchResultIsUsed){
+    //the target has 2 copies of the source: the full search finds the first copy,
+    // but the band around diagonal 1000 finds the second, and the comparison uses it
+    const std::vector<unsigned char> source = gtestDefs::makeTestData(1000, 1, 256);
+    std::vector<unsigned char> target(source);
+    target.insert(target.end(), source.begin(), source.end());
+
+    const std::list<indexRange> targetSearchRanges = {indexRange(0, 2000)};
+    const indexRange sourceSearchRange(0, 1000);
+
+    const std::unique_ptr<rangeMatch> full = offsetMetrics::getNextAlignmentRange(source, target, sourceSearchRange, targetSearchRanges);
+    ASSERT_NE(nullptr, full);
+    EXPECT_EQ(0u, full->startIndexInFile2);
+
+    offsetMetrics::options options;
+    options.initialDiagonal = 1000;
+
+    offsetMetrics::clearAbort();
+
+    //banded search is opt-in: by default, the comparison uses the full search's result
+    const std::unique_ptr<offsetMetrics::results> fullResults = offsetMetrics::doCompare(source, target, options);
+    ASSERT_EQ(1u, fullResults->alignmentRanges.size());
+    EXPECT_EQ(0u, fullResults->alignmentRanges.front().startIndexInFile2);
+
+    options.searchBandRadius = 16;
+    const std::unique_ptr<offsetMetrics::results> res = offsetMetrics::doCompare(source, target, options);
+    ASSERT_EQ(1u, res->alignmentRanges.size());
+    EXPECT_EQ(   0u, res->alignmentRanges.front().startIndexInFile1);
+    EXPECT_EQ(1000u, res->alignmentRanges.front().startIndexInFile2);
+    EXPECT_EQ(1000u, res->alignmentRanges.front().byteCount);
+}
+
+TEST(offsetMetrics, bandedSearchStopsAfterSourceWindow){
+    //the only alignment range is on the band's diagonal, but past the band's source window:
+    // the banded search gives up, and the full search finds it
+    const unsigned int bandRadius = 16;
+    const unsigned int windowSize = offsetMetrics::BAND_SOURCE_WINDOW_RADII*bandRadius;
+
+    //  bytes 0-63: the rest of the source, 64-127: the alignment range, 128-255: the rest of the target
+    std::vector<unsigned char> source = gtestDefs::makeTestData(2000, 4, 64);
+    std::vector<unsigned char> target = gtestDefs::makeTestData(2000, 5, 128, 128);
+    const std::vector<unsigned char> shared = gtestDefs::makeTestData(100, 6, 64, 64);
+    std::copy(shared.begin(), shared.end(), source.begin() + windowSize + 50);
+    std::copy(shared.begin(), shared.end(), target.begin() + windowSize + 50);
+
+    const std::list<indexRange> targetSearchRanges = {indexRange(0, 2000)};
+    EXPECT_EQ(nullptr, offsetMetrics::getNextAlignmentRange_banded(source, target, indexRange(0, 2000), targetSearchRanges, 0, bandRadius));
+
+    //(from a source index closer to it, it's in the window)
+    const std::unique_ptr<rangeMatch> banded
+            = offsetMetrics::getNextAlignmentRange_banded(source, target, indexRange(100, 2000), targetSearchRanges, 0, bandRadius);
+    ASSERT_NE(nullptr, banded);
+    EXPECT_EQ(windowSize + 50, banded->startIndexInFile1);
+    EXPECT_EQ(windowSize + 50, banded->startIndexInFile2);
+
+    offsetMetrics::options options;
+    options.searchBandRadius = bandRadius;
+
+    offsetMetrics::clearAbort();
+    const std::unique_ptr<offsetMetrics::results> res = offsetMetrics::doCompare(source, target, options);
+    ASSERT_EQ(1u, res->alignmentRanges.size());
+    EXPECT_EQ(windowSize + 50, res->alignmentRanges.front().startIndexInFile1);
+    EXPECT_EQ(windowSize + 50, res->alignmentRanges.front().startIndexInFile2);
+    EXPECT_EQ(100u,            res->alignmentRanges.front().byteCount);
+}
+
+TEST(offsetMetrics, fullSearchWhenBandIsEmpty){
+    //the source is 2000 bytes into the target, far outside the band around diagonal 0
+    // (the bytes before it are from a different alphabet, so nothing in the band matches)
+    const std::vector<unsigned char> source = gtestDefs::makeTestData(1000, 2, 128);
+    std::vector<unsigned char> target = gtestDefs::makeTestData(2000, 3, 128, 128);
+    target.insert(target.end(), source.begin(), source.end());
+
+    const std::list<indexRange> targetSearchRanges = {indexRange(0, 3000)};
+    EXPECT_EQ(nullptr, offsetMetrics::getNextAlignmentRange_banded(source, target, indexRange(0, 1000), targetSearchRanges, 0, 16));
+
+    offsetMetrics::options options;
+    options.searchBandRadius = 16;
+
+    offsetMetrics::clearAbort();
+    const std::unique_ptr<offsetMetrics::results> res = offsetMetrics::doCompare(source, target, options);
+    ASSERT_EQ(1u, res->alignmentRanges.size());
+    EXPECT_EQ(   0u, res->alignmentRanges.front().startIndexInFile1);
+    EXPECT_EQ(2000u, res->alignmentRanges.front().startIndexInFile2);
+    EXPECT_EQ(1000u, res->alignmentRanges.front().byteCount);
+}
+
+TEST(offsetMetrics, parallelSearchMatchesSerial){
+    for (unsigned int seed = 0; seed < 6; ++seed) {
+
+        //alignment ranges are everywhere with a small alphabet, and rare with a large one
+        for (const unsigned int alphabetSize : {4u, 256u}) {
+
+            const std::vector<unsigned char> source = gtestDefs::makeTestData(3000, seed, alphabetSize);
+            const std::vector<unsigned char> target = makeEditedCopy(gtestDefs::makeTestData(3000, seed + 50, alphabetSize), seed + 100, alphabetSize);
+            const std::list<indexRange> targetSearchRanges = makeTargetSearchRanges(static_cast<unsigned int>(target.size()), seed);
+
+            for (const unsigned int sourceStart : {0u, 1234u, 2990u}) {
+
+                const indexRange sourceSearchRange(sourceStart, static_cast<unsigned int>(source.size()));
+                const std::unique_ptr<rangeMatch> expected = offsetMetrics::getNextAlignmentRange(source, target, sourceSearchRange, targetSearchRanges);
+
+                for (const unsigned int threadCount : {1u, 2u, 3u, 4u, 7u, 16u}) {
+                    expectEqual(expected, offsetMetrics::getNextAlignmentRange_parallel(source, target, sourceSearchRange, targetSearchRanges, threadCount));
+                }
+            }
+        }
+    }
+
+    //a source with a single alignment range, late in the last target search range
+    // (so every work item before it is searched and comes up empty)
+    //  bytes 0-63: the rest of the source, 64-127: the alignment range, 128-255: the rest of the target
+    std::vector<unsigned char> source = gtestDefs::makeTestData(1900, 7, 64);
+    const std::vector<unsigned char> shared = gtestDefs::makeTestData(100, 8, 64, 64);
+    source.insert(source.end(), shared.begin(), shared.end());
+
+    std::vector<unsigned char> target = gtestDefs::makeTestData(5000, 9, 128, 128);
+    std::copy(shared.begin(), shared.end(), target.begin() + 4800);
+
+    const std::list<indexRange> targetSearchRanges = {indexRange(0, 1000), indexRange(1500, 5000)};
+    const std::unique_ptr<rangeMatch> expected = offsetMetrics::getNextAlignmentRange(source, target, indexRange(0, 2000), targetSearchRanges);
+    ASSERT_NE(nullptr, expected);
+    EXPECT_EQ(1900u, expected->startIndexInFile1);
+    EXPECT_EQ(4800u, expected->startIndexInFile2);
+
+    for (const unsigned int threadCount : {2u, 5u, 8u}) {
+        expectEqual(expected, offsetMetrics::getNextAlignmentRange_parallel(source, target, indexRange(0, 2000), targetSearchRanges, threadCount));
+    }
+}
+
+TEST(offsetMetrics, truncateAlignmentRange){
+    const std::vector<unsigned char> data = gtestDefs::makeTestData(300, 10, 256);
+
+    //a 1 byte run with matches on both sides isn't excludable
+    std::vector<unsigned char> changed(data);
+    changed[100] ^= 0x01;
+    EXPECT_EQ(300u, expectTruncatedAsReference(data, changed, rangeMatch(0, 0, 300)).byteCount);
+
+    //an interior run followed by mostly differences: truncated at the start of the run
+    changed = data;
+    for (unsigned int i = 100; i < 130; ++i) {
+        if (i < 110 || 0 != i%4) {
+            changed[i] ^= 0x01;
+        }
+    }
+    EXPECT_EQ(100u, expectTruncatedAsReference(data, changed, rangeMatch(0, 0, 300)).byteCount);
+
+    //runs at the edge of the data: the test range before each one is cut short by the start of a file
+    changed = data;
+    for (unsigned int i = 1; i < 5; ++i) {
+        changed[i] ^= 0x01;
+    }
+    EXPECT_EQ(1u, expectTruncatedAsReference(data, changed, rangeMatch(0, 0, 300)).byteCount);
+
+    //(data2 is data1 from index 5, with a run at 2)
+    std::vector<unsigned char> shifted(data.begin() + 5, data.end());
+    shifted[2] ^= 0x01;
+    shifted[3] ^= 0x01;
+    shifted[4] ^= 0x01;
+    EXPECT_EQ(2u, expectTruncatedAsReference(data, shifted, rangeMatch(5, 0, 295)).byteCount);
+
+    //a run at the end of the data
+    changed = data;
+    changed[297] ^= 0x01;
+    changed[298] ^= 0x01;
+    EXPECT_EQ(297u, expectTruncatedAsReference(data, changed, rangeMatch(0, 0, 299)).byteCount);
+}
+
+TEST(offsetMetrics, truncateAlignmentRangeMatchesReference){
+    for (unsigned int seed = 0; seed < 300; ++seed) {
+
+        std::mt19937 generator(seed);
+
+        //small alphabets have many short runs (and chance matches in the test ranges)
+        const unsigned int alphabetSize = 2 + generator() % 8;
+        const std::vector<unsigned char> data1 = gtestDefs::makeTestData(500 + generator() % 500, seed, alphabetSize);
+        std::vector<unsigned char> data2 = gtestDefs::makeTestData(500 + generator() % 500, seed + 1000, alphabetSize);
+
+        //copy part of data1 to data2 at an offset, with some of the copy's bytes changed
+        const unsigned int start1 = generator() % 200;
+        const unsigned int start2 = generator() % 200;
+        const unsigned int count = std::min(static_cast<unsigned int>(data1.size()) - start1, static_cast<unsigned int>(data2.size()) - start2);
+        const unsigned int changedPercent = generator() % 40;
+        for (unsigned int i = 0; i < count; ++i) {
+            data2[start2 + i] = (generator() % 100 < changedPercent) ? static_cast<unsigned char>(data1[start1 + i] + 1) : data1[start1 + i];
+        }
+
+        //alignment ranges start with a match
+        data2[start2] = data1[start1];
+
+        //the whole copy, and a part of it
+        expectTruncatedAsReference(data1, data2, rangeMatch(start1, start2, count));
+
+        const unsigned int partStart = generator() % count;
+        const unsigned int partCount = 1 + generator() % (count - partStart);
+        data2[start2 + partStart] = data1[start1 + partStart];
+        expectTruncatedAsReference(data1, data2, rangeMatch(start1 + partStart, start2 + partStart, partCount));
+    }
+}
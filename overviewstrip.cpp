@@ -0,0 +1,149 @@
+#include "overviewstrip.h"
+
+#include <QPainter>
+
+overviewStrip::overviewStrip(QWidget* parent) :
+    QFrame(parent),
+    m_density1(),
+    m_density2(),
+    m_indexCount(0),
+    m_visibleRange()
+{
+    setFrameStyle(QFrame::StyledPanel | QFrame::Sunken);
+    setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
+
+    //paintEvent fills the whole widget
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void overviewStrip::setDensities(QSharedPointer<const densityPyramid> density1, QSharedPointer<const densityPyramid> density2)
+{
+    m_density1 = density1;
+    m_density2 = density2;
+    update();
+}
+
+void overviewStrip::setIndexCount(const unsigned int indexCount)
+{
+    if (m_indexCount != indexCount) {
+        m_indexCount = indexCount;
+        update();
+    }
+}
+
+void overviewStrip::setVisibleRange(const indexRange& visibleRange)
+{
+    if (m_visibleRange != visibleRange) {
+        m_visibleRange = visibleRange;
+        update();
+    }
+}
+
+QSize overviewStrip::sizeHint() const
+{
+    return QSize(24, 0);
+}
+
+indexRange overviewStrip::getRowRange(const int y) const
+{
+    const int height = contentsRect().height();
+    if (height <= 0 || y < 0 || y >= height) {
+        return indexRange(0,0);
+    }
+
+    unsigned long long start = static_cast<unsigned long long>(y    )*m_indexCount/static_cast<unsigned int>(height);
+    unsigned long long end   = static_cast<unsigned long long>(y + 1)*m_indexCount/static_cast<unsigned int>(height);
+
+    //when there are fewer indices than rows, each row shows the index it starts in
+    if (start == end && start < m_indexCount) {
+        ++end;
+    }
+    return indexRange(static_cast<unsigned int>(start), static_cast<unsigned int>(end));
+}
+
+unsigned int overviewStrip::getIndexAt(const int y) const
+{
+    const int height = contentsRect().height();
+    if (height <= 0 || y < 0 || 0 == m_indexCount) {
+        return 0;
+    }
+    if (y >= height) {
+        return m_indexCount - 1;
+    }
+
+    return getRowRange(y).start;
+}
+
+/*static*/ QColor overviewStrip::getColor(const densityPyramid::density& d)
+{
+    static const QColor MATCH_COLOR      = QColor::fromRgb( 96,192, 96);
+    static const QColor DIFFERENCE_COLOR = QColor::fromRgb(224, 64, 64);
+    static const QColor UNMATCHED_COLOR  = QColor::fromRgb(160,160,160);
+
+    auto blend = [&d](const int match, const int difference, const int unmatched) {
+        return qBound(0, qRound(d.match*match + d.difference*difference + d.unmatched*unmatched), 255);
+    };
+
+    return QColor::fromRgb( blend(MATCH_COLOR.red(),   DIFFERENCE_COLOR.red(),   UNMATCHED_COLOR.red()  ),
+                            blend(MATCH_COLOR.green(), DIFFERENCE_COLOR.green(), UNMATCHED_COLOR.green()),
+                            blend(MATCH_COLOR.blue(),  DIFFERENCE_COLOR.blue(),  UNMATCHED_COLOR.blue() )  );
+}
+
+void overviewStrip::paintEvent(QPaintEvent *e)
+{
+    {
+        QPainter painter(this);
+        const QRect area = contentsRect();
+        painter.fillRect(area, palette().window());
+
+        //one column per data set
+        const int columnWidth = (area.width() - 1)/2;
+        const QSharedPointer<const densityPyramid> densities[] = {m_density1, m_density2};
+        const int columnLefts[] = {area.left(), area.right() + 1 - columnWidth};
+
+        const QRect rows = e->rect().intersected(area);
+
+        for (int y = rows.top(); y <= rows.bottom(); ++y) {
+            const indexRange rowRange = getRowRange(y - area.top());
+            if (0 == rowRange.count()) {
+                continue;
+            }
+
+            for (int column = 0; column < 2; ++column) {
+                const QSharedPointer<const densityPyramid>& density = densities[column];
+                if (!density || rowRange.start >= density->getDataSize()) {
+                    continue;   //past the end of this data set
+                }
+                painter.fillRect(QRect(columnLefts[column], y, columnWidth, 1), getColor(density->getDensity(rowRange)));
+            }
+        }
+
+        //visible range marker
+        if (m_indexCount && m_visibleRange.count() && area.height() > 0) {
+            const unsigned long long height = static_cast<unsigned long long>(area.height());
+            const int top    = static_cast<int>(static_cast<unsigned long long>(m_visibleRange.start)*height/m_indexCount);
+            const int bottom = static_cast<int>((static_cast<unsigned long long>(m_visibleRange.end)*height + m_indexCount - 1)/m_indexCount);
+
+            painter.setPen(palette().highlight().color());
+            painter.drawRect(QRect(area.left(), area.top() + top, area.width() - 1, qMax(2, bottom - top) - 1));
+        }
+    }
+
+    //draw the frame over the contents
+    QFrame::paintEvent(e);
+}
+
+void overviewStrip::mousePressEvent(QMouseEvent *e)
+{
+    if (e->button() == Qt::LeftButton && m_indexCount) {
+        emit indexSelected(getIndexAt(e->pos().y() - contentsRect().top()));
+    }
+}
+
+void overviewStrip::mouseMoveEvent(QMouseEvent *e)
+{
+    //dragging
+    if ((e->buttons() & Qt::LeftButton) && m_indexCount) {
+        emit indexSelected(getIndexAt(e->pos().y() - contentsRect().top()));
+    }
+}
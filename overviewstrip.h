@@ -0,0 +1,66 @@
+#ifndef OVERVIEWSTRIP_H
+#define OVERVIEWSTRIP_H
+
+#include <QFrame>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QSharedPointer>
+
+#include "densitypyramid.h"
+#include "indexrange.h"
+
+/*
+ *  an overview of the comparison results for both data sets:
+ *   each pixel row shows the match, difference and unmatched density of the indices it covers
+ *   (one column per data set, over the same index scale as the main scrollbar)
+ *
+ *  densities come from densityPyramids, so painting takes time proportional to the pixel count, regardless of data size
+ *
+ *  clicking or dragging selects the index under the mouse
+*/
+
+class overviewStrip : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit overviewStrip(QWidget* parent = nullptr);
+
+    //sets the densities to display (either can be null) and schedules a repaint
+    // (the pyramids are built from the finished comparison results, and aren't changed while they're displayed)
+    void setDensities(QSharedPointer<const densityPyramid> density1, QSharedPointer<const densityPyramid> density2);
+
+    //the number of indices the strip's height represents
+    void setIndexCount(const unsigned int indexCount);
+
+    //the index range shown in the hex views (drawn as a marker)
+    void setVisibleRange(const indexRange& visibleRange);
+
+    QSize sizeHint() const Q_DECL_OVERRIDE;
+
+signals:
+    void indexSelected(unsigned int index);
+
+protected:
+    void paintEvent(QPaintEvent *e) Q_DECL_OVERRIDE;
+    void mousePressEvent(QMouseEvent *e) Q_DECL_OVERRIDE;
+    void mouseMoveEvent(QMouseEvent *e) Q_DECL_OVERRIDE;
+
+private:
+    //the indices covered by pixel row y of the contents rect
+    indexRange getRowRange(const int y) const;
+
+    //the index at pixel row y of the contents rect
+    unsigned int getIndexAt(const int y) const;
+
+    //blends the category colors by density
+    static QColor getColor(const densityPyramid::density& d);
+
+    QSharedPointer<const densityPyramid> m_density1;
+    QSharedPointer<const densityPyramid> m_density2;
+
+    unsigned int m_indexCount;
+    indexRange m_visibleRange;
+};
+
+#endif // OVERVIEWSTRIP_H
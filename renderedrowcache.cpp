@@ -0,0 +1,176 @@
+#include "renderedrowcache.h"
+
+renderedRowCache::renderedRowCache(const unsigned int capacity)
+    :   m_mutex(),
+        m_wake(),
+        m_idle(),
+        m_capacity(std::max(1u, capacity)),
+        m_rows(),
+        m_rowsByKey(),
+        m_pending(),
+        m_render(),
+        m_generation(0),
+        m_rendering(false),
+        m_stop(false),
+        m_worker()
+{
+}
+
+renderedRowCache::~renderedRowCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_pending.clear();
+    }
+    m_wake.notify_all();
+
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+void renderedRowCache::setCapacity(const unsigned int capacity)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_capacity = std::max(1u, capacity);
+    trim();
+}
+
+unsigned int renderedRowCache::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capacity;
+}
+
+unsigned int renderedRowCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<unsigned int>(m_rows.size());
+}
+
+std::shared_ptr<const renderedRowCache::row> renderedRowCache::get(const indexRange& range)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_rowsByKey.find(rowKey(range.start, range.end));
+    if (found == m_rowsByKey.end()) {
+        return nullptr;
+    }
+
+    //move to the front of the list (most recently used)
+    m_rows.splice(m_rows.begin(), m_rows, found->second);
+    return m_rows.front().second;
+}
+
+void renderedRowCache::put(const indexRange& range, std::shared_ptr<const row> rendered)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    insert(rowKey(range.start, range.end), rendered);
+}
+
+void renderedRowCache::prefetch(const std::vector<indexRange>& ranges, renderFunction render)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_pending.clear();
+        for (const indexRange& range : ranges) {
+            if (range.count() && !m_rowsByKey.count(rowKey(range.start, range.end))) {
+                m_pending.push_back(range);
+            }
+        }
+        m_render = render;
+
+        if (m_pending.empty()) {
+            return;
+        }
+
+        if (!m_worker.joinable()) {
+            m_worker = std::thread(&renderedRowCache::workerLoop, this);
+        }
+    }
+    m_wake.notify_all();
+}
+
+void renderedRowCache::clear()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    ++m_generation;
+    m_pending.clear();
+    m_rows.clear();
+    m_rowsByKey.clear();
+
+    m_idle.wait(lock, [this]{ return !m_rendering; });
+}
+
+void renderedRowCache::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]{ return !m_rendering && m_pending.empty(); });
+}
+
+void renderedRowCache::insert(const rowKey& key, std::shared_ptr<const row> rendered)
+{
+    auto found = m_rowsByKey.find(key);
+    if (found != m_rowsByKey.end()) {
+        m_rows.erase(found->second);
+    }
+
+    m_rows.emplace_front(key, rendered);
+    m_rowsByKey[key] = m_rows.begin();
+
+    trim();
+}
+
+void renderedRowCache::trim()
+{
+    while (m_rows.size() > m_capacity) {
+        //discard the least recently used
+        m_rowsByKey.erase(m_rows.back().first);
+        m_rows.pop_back();
+    }
+}
+
+void renderedRowCache::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+
+        if (m_pending.empty()) {
+            m_idle.notify_all();
+        }
+
+        m_wake.wait(lock, [this]{ return m_stop || !m_pending.empty(); });
+        if (m_stop) {
+            return;
+        }
+
+        const indexRange range = m_pending.front();
+        m_pending.pop_front();
+
+        const rowKey key(range.start, range.end);
+        if (m_rowsByKey.count(key)) {
+            continue;   //cached since it was requested
+        }
+
+        //render without holding the lock (the GUI thread can use the cache meanwhile)
+        const renderFunction render = m_render;
+        const unsigned int generation = m_generation;
+        m_rendering = true;
+        lock.unlock();
+
+        auto rendered = std::make_shared<row>();
+        render(range, *rendered);
+
+        lock.lock();
+        m_rendering = false;
+
+        if (generation == m_generation) {
+            insert(key, rendered);
+        }
+        m_idle.notify_all();
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef RENDEREDROWCACHE_H
+#define RENDEREDROWCACHE_H
+
+#include <vector>
+#include <memory>
+#include <list>
+#include <map>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "indexrange.h"
+#include "defensivecoding.h"
+
+/*
+    the most recently used rendered byte grid rows (the highlight style of each byte in a row), by row index range
+
+    rows can be rendered ahead of time on a worker thread (e.g. the pages above and below the displayed page),
+     so scrolling to them only draws, instead of resolving highlights on the GUI thread first
+
+    when the cache is full, the least recently used row is discarded
+*/
+
+class renderedRowCache
+{
+public:
+    class row {
+    public:
+        //per byte: (style index) + 1, or 0 for none
+        std::vector<unsigned int> foregroundStyles;
+        std::vector<unsigned int> backgroundStyles;
+    };
+
+    //renders the row with the bytes in range (called on the worker thread for prefetched rows)
+    typedef std::function<void(const indexRange& range, row& rendered)> renderFunction;
+
+    explicit renderedRowCache(const unsigned int capacity);
+    ~renderedRowCache();
+
+    renderedRowCache(const renderedRowCache&) = delete;
+    renderedRowCache& operator=(const renderedRowCache&) = delete;
+
+    void setCapacity(const unsigned int capacity);
+    unsigned int getCapacity() const;
+    unsigned int size() const;
+
+    //returns the cached row for range (marking it most recently used), or nullptr if it isn't cached
+    std::shared_ptr<const row> get(const indexRange& range);
+
+    void put(const indexRange& range, std::shared_ptr<const row> rendered);
+
+    //renders the rows in ranges that aren't cached on the worker thread, and adds them to the cache
+    // (replaces any rows still waiting from a previous prefetch)
+    void prefetch(const std::vector<indexRange>& ranges, renderFunction render);
+
+    //discards all rows, and rows waiting to be prefetched; waits for a row being rendered to finish
+    // (call this before changing anything the render function reads)
+    void clear();
+
+    //waits until all prefetched rows are rendered
+    void waitUntilIdle();
+
+private:
+    typedef std::pair<unsigned int, unsigned int> rowKey;   //range start, range end
+    typedef std::list<std::pair<rowKey, std::shared_ptr<const row>>> rowList;
+
+    //adds or replaces a row (m_mutex must be locked)
+    void insert(const rowKey& key, std::shared_ptr<const row> rendered);
+
+    //removes least recently used rows until the cache fits its capacity (m_mutex must be locked)
+    void trim();
+
+    void workerLoop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;     //signals the worker: rows to render, or stop
+    std::condition_variable m_idle;     //signals waiting threads: no row is being rendered (and, if none are pending, all are done)
+
+    unsigned int m_capacity;
+    rowList m_rows;                                 //most recently used first
+    std::map<rowKey, rowList::iterator> m_rowsByKey;
+
+    std::deque<indexRange> m_pending;               //rows to render on the worker thread
+    renderFunction m_render;
+    unsigned int m_generation;                      //incremented by clear(): rows rendered from older requests are discarded
+    bool m_rendering;
+    bool m_stop;
+
+    std::thread m_worker;                           //started by the first prefetch
+};
+
+#endif // RENDEREDROWCACHE_H
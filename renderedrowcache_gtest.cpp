@@ -0,0 +1,96 @@
+#include <atomic>
+
+#include "renderedrowcache.h"
+#include "gtestDefs.h"
+#include <gtest.h>
+
+namespace {
+
+    //a row whose styles identify the range it was rendered for
+    void renderTestRow(const indexRange& range, renderedRowCache::row& rendered)
+    {
+        for (unsigned int i = range.start; i < range.end; ++i) {
+            rendered.foregroundStyles.push_back(i);
+            rendered.backgroundStyles.push_back(i + 1);
+        }
+    }
+
+    std::shared_ptr<const renderedRowCache::row> makeTestRow(const indexRange& range)
+    {
+        auto rendered = std::make_shared<renderedRowCache::row>();
+        renderTestRow(range, *rendered);
+        return rendered;
+    }
+}
+
+TEST(renderedRowCache, leastRecentlyUsed){
+    renderedRowCache cache(2);
+
+    cache.put(indexRange( 0,16), makeTestRow(indexRange( 0,16)));
+    cache.put(indexRange(16,32), makeTestRow(indexRange(16,32)));
+    EXPECT_TRUE(cache.get(indexRange(0,16)) != nullptr);            //0 is now the most recently used
+    cache.put(indexRange(32,48), makeTestRow(indexRange(32,48)));   //discards 16
+
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_TRUE(cache.get(indexRange(16,32)) == nullptr);
+    EXPECT_TRUE(cache.get(indexRange( 0,16)) != nullptr);
+    EXPECT_TRUE(cache.get(indexRange(32,48)) != nullptr);
+
+    //rows are keyed by the whole range (a different row width is a different row)
+    EXPECT_TRUE(cache.get(indexRange(0,8)) == nullptr);
+
+    cache.setCapacity(1);
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_TRUE(cache.get(indexRange(32,48)) != nullptr);
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+}
+
+TEST(renderedRowCache, prefetch){
+    renderedRowCache cache(100);
+    std::atomic<unsigned int> renderCount(0);
+
+    auto render = [&renderCount](const indexRange& range, renderedRowCache::row& rendered) {
+        ++renderCount;
+        renderTestRow(range, rendered);
+    };
+
+    cache.put(indexRange(0,10), makeTestRow(indexRange(0,10)));
+
+    std::vector<indexRange> ranges;
+    for (unsigned int start = 0; start < 200; start += 10) {
+        ranges.push_back(indexRange(start, start + 10));
+    }
+    cache.prefetch(ranges, render);
+    cache.waitUntilIdle();
+
+    EXPECT_EQ(19u, renderCount.load()); //the cached row isn't rendered again
+    EXPECT_EQ(20u, cache.size());
+
+    auto rendered = cache.get(indexRange(150,160));
+    ASSERT_TRUE(rendered != nullptr);
+    ASSERT_EQ(10u, rendered->foregroundStyles.size());
+    EXPECT_EQ(150u, rendered->foregroundStyles[0]);
+    EXPECT_EQ(160u, rendered->backgroundStyles[9]);
+
+    //everything is cached: nothing to render
+    cache.prefetch(ranges, render);
+    cache.waitUntilIdle();
+    EXPECT_EQ(19u, renderCount.load());
+}
+
+TEST(renderedRowCache, clearDiscardsPendingRows){
+    renderedRowCache cache(1000);
+
+    std::vector<indexRange> ranges;
+    for (unsigned int start = 0; start < 10000; start += 10) {
+        ranges.push_back(indexRange(start, start + 10));
+    }
+    cache.prefetch(ranges, renderTestRow);
+    cache.clear();
+
+    //no row rendered before clear() is added after it
+    cache.waitUntilIdle();
+    EXPECT_EQ(0u, cache.size());
+}
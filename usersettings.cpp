@@ -5,6 +5,7 @@ UserSettings::UserSettings()
       byteGridColumn_LargestMultipleOf_N(8),
       byteGridColumn_UpTo_N(8),
       byteGridScrollingMode(dataSetView::ByteGridScrollingMode::FixedRows),
+      alignedScrolling(false),
       windowWidth(0),
       windowHeight(0),
       logAreaHeight(0)
@@ -27,6 +28,8 @@ void UserSettings::loadINIFile() {
     byteGridScrollingMode =                 static_cast<dataSetView::ByteGridScrollingMode>
                                             (settings.value("byteGridScrollingMode").toInt());
 
+    alignedScrolling =                      settings.value("alignedScrolling").toBool();
+
     windowWidth =                           settings.value("windowWidth").toUInt();
 
     windowHeight =                          settings.value("windowHeight").toUInt();
@@ -44,6 +47,7 @@ void UserSettings::saveINIFile() {
     settings.setValue("byteGridColumn_LargestMultipleOf_N", byteGridColumn_LargestMultipleOf_N      );
     settings.setValue("byteGridColumn_UpTo_N",              byteGridColumn_UpTo_N                   );
     settings.setValue("byteGridScrollingMode",              static_cast<int>(byteGridScrollingMode) );
+    settings.setValue("alignedScrolling",                   alignedScrolling                        );
     settings.setValue("windowWidth",                        windowWidth                             );
     settings.setValue("windowHeight",                       windowHeight                            );
     settings.setValue("logAreaHeight",                      logAreaHeight                           );
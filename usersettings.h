@@ -28,6 +28,9 @@ public:
         //scrolling mode
         dataSetView::ByteGridScrollingMode byteGridScrollingMode;
 
+    //scroll dataSet2 to the index aligned with dataSet1's (through the comparison results), instead of the same index
+    bool alignedScrolling;
+
     //saved window size
     unsigned int windowWidth;
     unsigned int windowHeight;
@@ -1,5 +1,73 @@
 #include "utilities.h"
 
+#include <cstring>
+#include <thread>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*static*/ const unsigned int utilities::MIN_BYTES_PER_THREAD;
+
+namespace {
+
+    //index of the lowest set bit (x must be nonzero)
+    inline unsigned int lowestSetBit32(unsigned int x)
+    {
+#if defined(__GNUC__)
+        return static_cast<unsigned int>(__builtin_ctz(x));
+#else
+        unsigned int index = 0;
+        while (!(x & 1)) {
+            x >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    //index of the highest set bit (x must be nonzero)
+    inline unsigned int highestSetBit32(unsigned int x)
+    {
+#if defined(__GNUC__)
+        return 31 - static_cast<unsigned int>(__builtin_clz(x));
+#else
+        unsigned int index = 0;
+        while (x >>= 1) {
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+#ifdef __SSE2__
+    //a bit for each of the 32 bytes at data1 and data2 (lowest bit first): set if the bytes are equal
+    inline unsigned int getEqualMask32(const unsigned char* data1, const unsigned char* data2)
+    {
+        const __m128i low1  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data1));
+        const __m128i low2  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data2));
+        const __m128i high1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data1 + 16));
+        const __m128i high2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data2 + 16));
+
+        const unsigned int low  = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(low1, low2)));
+        const unsigned int high = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(high1, high2)));
+
+        return low | (high << 16);
+    }
+#else
+    //the 8 bytes at data1 XOR the 8 bytes at data2 (a byte is 0 where they're equal)
+    inline unsigned long long getDifferenceWord(const unsigned char* data1, const unsigned char* data2)
+    {
+        unsigned long long word1;
+        unsigned long long word2;
+        std::memcpy(&word1, data1, 8);
+        std::memcpy(&word2, data2, 8);
+        return word1 ^ word2;
+    }
+#endif
+
+}
+
 
 /*static*/ unsigned int utilities::findStrongestRepetitionPeriod (
                 const std::vector<unsigned char> &data,
@@ -268,8 +336,8 @@ utilities::addClampToMax (
 /*static*/
 unsigned int
 utilities::countMatchingIndices (
-        const std::vector<unsigned char>& data1,
-        const std::vector<unsigned char>& data2,
+        const byteSpan& data1,
+        const byteSpan& data2,
         const indexRange& data1Subset,
         const indexRange& data2Subset)
 {
@@ -295,3 +363,177 @@ utilities::countMatchingIndices (
 
     return matches;
 }
+
+
+/*static*/
+unsigned int
+utilities::getCommonPrefixLength (
+        const unsigned char* data1,
+        const unsigned char* data2,
+        const unsigned int count )
+{
+    unsigned int i = 0;
+
+#ifdef __SSE2__
+    //32 bytes at a time: the first unequal byte is the lowest clear bit in the mask
+    for (; i + 32 <= count; i += 32) {
+        const unsigned int equal = getEqualMask32(data1 + i, data2 + i);
+        if (0xFFFFFFFF != equal) {
+            return i + lowestSetBit32(~equal);
+        }
+    }
+#else
+    //8 bytes at a time (the first difference is found bytewise below)
+    for (; i + 8 <= count; i += 8) {
+        if (getDifferenceWord(data1 + i, data2 + i)) {
+            break;
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if (data1[i] != data2[i]) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/*static*/
+unsigned int
+utilities::getCommonSuffixLength (
+        const unsigned char* data1End,
+        const unsigned char* data2End,
+        const unsigned int count )
+{
+    unsigned int i = 0;
+
+#ifdef __SSE2__
+    //32 bytes at a time, backwards: the last unequal byte is the highest clear bit in the mask
+    for (; i + 32 <= count; i += 32) {
+        const unsigned int equal = getEqualMask32(data1End - i - 32, data2End - i - 32);
+        if (0xFFFFFFFF != equal) {
+            return i + 31 - highestSetBit32(~equal);
+        }
+    }
+#else
+    //8 bytes at a time (the last difference is found bytewise below)
+    for (; i + 8 <= count; i += 8) {
+        if (getDifferenceWord(data1End - i - 8, data2End - i - 8)) {
+            break;
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if (*(data1End - i - 1) != *(data2End - i - 1)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/*static*/
+unsigned int
+utilities::getDifferentPrefixLength (
+        const unsigned char* data1,
+        const unsigned char* data2,
+        const unsigned int count )
+{
+    unsigned int i = 0;
+
+#ifdef __SSE2__
+    //32 bytes at a time: the first equal byte is the lowest set bit in the mask
+    for (; i + 32 <= count; i += 32) {
+        const unsigned int equal = getEqualMask32(data1 + i, data2 + i);
+        if (equal) {
+            return i + lowestSetBit32(equal);
+        }
+    }
+#else
+    //8 bytes at a time, while no byte of the difference word is 0 (the first equal byte is found bytewise below)
+    for (; i + 8 <= count; i += 8) {
+        const unsigned long long difference = getDifferenceWord(data1 + i, data2 + i);
+        if ((difference - 0x0101010101010101ULL) & ~difference & 0x8080808080808080ULL) {
+            break;
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if (data1[i] == data2[i]) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/*static*/
+std::vector<indexRange>
+utilities::findDifferences (
+        const unsigned char* data1,
+        const unsigned char* data2,
+        const unsigned int count,
+        const unsigned int threadCount /*= 1*/ )
+{
+    //each thread finds the differences in one part of the data
+    const unsigned int partCount = std::max(1u, std::min(threadCount, count/MIN_BYTES_PER_THREAD));
+    const unsigned int partSize = count/partCount;
+
+    std::vector<std::vector<indexRange>> partDiffs(partCount);
+    auto getPart = [&](const unsigned int part) {
+        const unsigned int start = part*partSize;
+        const unsigned int end = (part + 1 == partCount) ? count : start + partSize;
+        appendDifferences(data1, data2, indexRange(start, end), partDiffs[part]);
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int part = 1; part < partCount; ++part) {
+        workers.emplace_back(getPart, part);
+    }
+    getPart(0); //this thread does the first part
+
+    for (std::thread& t : workers) {
+        t.join();
+    }
+
+    //join the parts (a run that crosses a part boundary was found as 2 runs)
+    std::vector<indexRange> diffs(std::move(partDiffs[0]));
+    for (unsigned int part = 1; part < partCount; ++part) {
+        for (const indexRange& range : partDiffs[part]) {
+            if (!diffs.empty() && diffs.back().end == range.start) {
+                diffs.back().end = range.end;
+            }
+            else {
+                diffs.push_back(range);
+            }
+        }
+    }
+
+    return diffs;
+}
+
+/*static*/
+void
+utilities::appendDifferences (
+        const unsigned char* data1,
+        const unsigned char* data2,
+        const indexRange& range,
+        std::vector<indexRange>& diffs )
+{
+    //alternately skip a run of equal bytes, then record a run of different bytes
+    unsigned int i = range.start;
+    while (i < range.end) {
+        i += getCommonPrefixLength(data1 + i, data2 + i, range.end - i);
+        if (i == range.end) {
+            break;
+        }
+
+        const unsigned int runLength = getDifferentPrefixLength(data1 + i, data2 + i, range.end - i);
+        diffs.emplace_back(i, i + runLength);
+        i += runLength;
+    }
+}
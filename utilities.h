@@ -6,6 +6,7 @@
 #include <memory>
 
 #include "indexrange.h"
+#include "bytespan.h"
 
 class utilities
 {
@@ -46,10 +47,61 @@ public:
     static
     unsigned int
     countMatchingIndices(
-            const std::vector<unsigned char>& data1,
-            const std::vector<unsigned char>& data2,
+            const byteSpan& data1,
+            const byteSpan& data2,
             const indexRange& data1Subset,
             const indexRange& data2Subset);
+
+    //
+    //  byte comparison of 2 buffers, 32 bytes at a time with SSE2 where it's available (8 at a time otherwise)
+    //
+
+    //the number of identical bytes at the start of data1 and data2 (at most count)
+    static
+    unsigned int
+    getCommonPrefixLength (
+            const unsigned char* data1,
+            const unsigned char* data2,
+            const unsigned int count );
+
+    //the number of identical bytes before data1End and data2End (at most count)
+    static
+    unsigned int
+    getCommonSuffixLength (
+            const unsigned char* data1End,
+            const unsigned char* data2End,
+            const unsigned int count );
+
+    //the number of bytes at the start of data1 and data2 that are all different (at most count)
+    static
+    unsigned int
+    getDifferentPrefixLength (
+            const unsigned char* data1,
+            const unsigned char* data2,
+            const unsigned int count );
+
+    //the runs of differing bytes in the first count bytes of data1 and data2, in order
+    // (split across threadCount threads for large counts)
+    static
+    std::vector<indexRange>
+    findDifferences (
+            const unsigned char* data1,
+            const unsigned char* data2,
+            const unsigned int count,
+            const unsigned int threadCount = 1 );
+
+    //findDifferences only uses another thread for each (at least) this many bytes
+    static const unsigned int MIN_BYTES_PER_THREAD = 1 << 22;
+
+private:
+    //appends the runs of differing bytes in range (of data1 and data2) to diffs
+    static
+    void
+    appendDifferences (
+            const unsigned char* data1,
+            const unsigned char* data2,
+            const indexRange& range,
+            std::vector<indexRange>& diffs );
 };
 
 #endif // UTILITIES_H
@@ -22,3 +22,55 @@ TEST(utilities, addClampToMax){
     EXPECT_EQ(UINT_MAX,     utilities::addClampToMax(UINT_MAX, UINT_MAX)        );
     EXPECT_EQ(15,           utilities::addClampToMax(10, 5)                     );
 }
+
+TEST(utilities, prefixAndSuffixLengths){
+    const std::vector<unsigned char> data = gtestDefs::randomData(100, 45);
+
+    //a difference at every position (on both sides of 16 byte blocks)
+    for (unsigned int i = 0; i < data.size(); ++i) {
+        std::vector<unsigned char> changed(data);
+        changed[i] ^= 0x80;
+
+        EXPECT_EQ(i, utilities::getCommonPrefixLength(data.data(), changed.data(), 100));
+        EXPECT_EQ(99 - i, utilities::getCommonSuffixLength(data.data() + 100, changed.data() + 100, 100));
+    }
+
+    EXPECT_EQ(100u, utilities::getCommonPrefixLength(data.data(), data.data(), 100));
+    EXPECT_EQ(100u, utilities::getCommonSuffixLength(data.data() + 100, data.data() + 100, 100));
+    EXPECT_EQ(0u, utilities::getCommonPrefixLength(data.data(), data.data(), 0));
+}
+
+TEST(utilities, findDifferences){
+    const std::vector<unsigned char> data1 = gtestDefs::randomData(1000, 46);
+    std::vector<unsigned char> data2(data1);
+
+    //runs at the start, across a 32 byte block, of 1 byte, and at the end
+    const std::vector<indexRange> expected = {indexRange(0, 3), indexRange(30, 70), indexRange(500, 501), indexRange(990, 1000)};
+    for (const indexRange& run : expected) {
+        for (unsigned int i = run.start; i < run.end; ++i) {
+            data2[i] ^= 0x01;
+        }
+    }
+
+    EXPECT_EQ(expected, utilities::findDifferences(data1.data(), data2.data(), 1000));
+    EXPECT_TRUE(utilities::findDifferences(data1.data(), data1.data(), 1000).empty());
+    EXPECT_TRUE(utilities::findDifferences(data1.data(), data2.data(), 0).empty());
+}
+
+TEST(utilities, findDifferencesThreaded){
+    //3 parts: a run across each part boundary is found as 1 run
+    const unsigned int size = 3*utilities::MIN_BYTES_PER_THREAD;
+    const std::vector<unsigned char> data1(size, 0);
+    std::vector<unsigned char> data2(size, 0);
+
+    const std::vector<indexRange> expected = {  indexRange(5, 6),
+                                                indexRange(  utilities::MIN_BYTES_PER_THREAD - 10,   utilities::MIN_BYTES_PER_THREAD + 10),
+                                                indexRange(2*utilities::MIN_BYTES_PER_THREAD,      2*utilities::MIN_BYTES_PER_THREAD + 1),
+                                                indexRange(size - 1, size) };
+    for (const indexRange& run : expected) {
+        std::fill(data2.begin() + run.start, data2.begin() + run.end, 0xFF);
+    }
+
+    EXPECT_EQ(expected, utilities::findDifferences(data1.data(), data2.data(), size, 3));
+    EXPECT_EQ(expected, utilities::findDifferences(data1.data(), data2.data(), size, 8));
+}